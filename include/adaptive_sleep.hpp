@@ -0,0 +1,217 @@
+/**
+ * @file 	adaptive_sleep.hpp
+ * @brief 	adaptive_sleep.hpp defines kernel sleeps that wake early by the overshoot predicted from the
+ * 			overshoots of previous sleeps of a similar duration.
+ * @details	A kernel sleep overshoots its deadline by the wakeup latency of the kernel, which on a given
+ * 			host is fairly stable for a given duration. Each thread keeps an OvershootModel holding an
+ * 			exponentially weighted moving average and variance of the overshoot for each power of two
+ * 			bucket of durations. The adaptive sleeps ask the kernel to wake them the predicted overshoot
+ * 			before the deadline and then learn from how late the kernel actually was, so the mean wakeup
+ * 			converges onto the deadline without spending any time spinning.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef ADAPTIVE_SLEEP_HPP
+#define ADAPTIVE_SLEEP_HPP
+
+// C++ Standard Library Headers
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/**************************************************************************************************/
+	/* Overshoot Model 																				  */
+	/**************************************************************************************************/
+	/// Number of power of two duration buckets that overshoots are learnt for.
+	const static size_t overshoot_model_buckets = 64;
+
+	/**
+	 * @brief	Struct overshoot_model_config holds the parameters of the overshoot estimator.
+	 */
+	struct overshoot_model_config {
+		/// Weight of each new overshoot in the moving average and variance once the bucket is warm.
+		double smoothing = 1.0 / 16.0;
+		/// Number of standard deviations below the mean overshoot to wake at, larger values wake late more often than early.
+		double margin_stddevs = 0.0;
+	};
+
+	/**
+	 * @brief	Struct overshoot_estimate holds the learnt overshoot of one bucket of durations.
+	 */
+	struct overshoot_estimate {
+		/// Number of overshoots learnt from.
+		uint64_t count = 0;
+		/// Moving average of the overshoot in nanoseconds.
+		double mean_ns = 0.0;
+		/// Moving variance of the overshoot in square nanoseconds.
+		double variance_ns2 = 0.0;
+
+		/**
+		 * @brief	Method stddev_ns gets the moving standard deviation of the overshoot.
+		 * @return	double standard deviation in nanoseconds.
+		 */
+		double stddev_ns() const {
+			return std::sqrt(variance_ns2);
+		}
+	};
+
+	/**
+	 * @brief	Function overshoot_model_bucket gets the bucket of durations a duration is learnt in.
+	 * @param	duration_ns	uint64_t duration of the sleep in nanoseconds.
+	 * @return	size_t index of the bucket, the position of the highest set bit of the duration.
+	 */
+	inline size_t overshoot_model_bucket(const uint64_t duration_ns) {
+		size_t bucket = 0;
+		for (uint64_t remaining = duration_ns >> 1; remaining != 0; remaining >>= 1) bucket++;
+		return bucket;
+	}
+
+	/**
+	 * @brief	Class OvershootModel learns the overshoot of kernel sleeps for each bucket of durations.
+	 * @details	Each bucket uses a cumulative average until it has seen 1 / smoothing overshoots, so a new
+	 * 			bucket converges quickly, after which it tracks the host with an exponentially weighted
+	 * 			moving average and variance. The model is not thread safe, use thread_overshoot_model to
+	 * 			get the model of the calling thread.
+	 */
+	class OvershootModel {
+	public:
+		/**
+		 * @brief	Constructor for OvershootModel.
+		 * @param	config	overshoot_model_config parameters of the estimator.
+		 */
+		explicit OvershootModel(const overshoot_model_config &config = overshoot_model_config{}) : config(config) {}
+
+		/**
+		 * @brief	Method predict_ns gets the amount to wake early by for a sleep of the given duration.
+		 * @param	duration_ns	uint64_t duration of the sleep in nanoseconds.
+		 * @return	uint64_t predicted overshoot less the margin, at most the duration.
+		 */
+		uint64_t predict_ns(const uint64_t duration_ns) const {
+			const overshoot_estimate &estimate = estimates[overshoot_model_bucket(duration_ns)];
+			const double prediction = estimate.mean_ns - config.margin_stddevs * estimate.stddev_ns();
+			if (prediction <= 0.0) return 0;
+			const uint64_t prediction_ns = static_cast<uint64_t>(prediction);
+			return prediction_ns < duration_ns ? prediction_ns : duration_ns;
+		}
+
+		/**
+		 * @brief	Method update learns the overshoot of a kernel sleep.
+		 * @param	duration_ns		uint64_t duration of the sleep in nanoseconds.
+		 * @param	overshoot_ns	int64_t number of nanoseconds the kernel woke the thread after the time asked for.
+		 */
+		void update(const uint64_t duration_ns, const int64_t overshoot_ns) {
+			overshoot_estimate &estimate = estimates[overshoot_model_bucket(duration_ns)];
+			estimate.count++;
+			const double weight = 1.0 / static_cast<double>(estimate.count) > config.smoothing ? 1.0 / static_cast<double>(estimate.count) : config.smoothing;
+			double sample_ns = static_cast<double>(overshoot_ns);
+			// Once warm, clip outliers such as preemptions so that a single one cannot swamp the estimate.
+			if (weight == config.smoothing) {
+				const double spread_ns = 4.0 * estimate.stddev_ns() > estimate.mean_ns ? 4.0 * estimate.stddev_ns() : estimate.mean_ns;
+				if (sample_ns > estimate.mean_ns + spread_ns) sample_ns = estimate.mean_ns + spread_ns;
+			}
+			const double difference = sample_ns - estimate.mean_ns;
+			estimate.mean_ns += weight * difference;
+			estimate.variance_ns2 = (1.0 - weight) * (estimate.variance_ns2 + weight * difference * difference);
+		}
+
+		/**
+		 * @brief	Method decay shrinks the learnt overshoot of a bucket whose prediction covered the whole
+		 * 			sleep, so that the sleep was skipped and nothing could be learnt from it.
+		 * @param	duration_ns	uint64_t duration of the skipped sleep in nanoseconds.
+		 * @details	Without the decay an overestimate, for example from a preemption while the bucket was
+		 * 			warming up, would skip every later sleep of the bucket and never be corrected.
+		 */
+		void decay(const uint64_t duration_ns) {
+			estimates[overshoot_model_bucket(duration_ns)].mean_ns *= 1.0 - config.smoothing;
+		}
+
+		/**
+		 * @brief	Method estimate gets the learnt overshoot for sleeps of the given duration.
+		 * @param	duration_ns	uint64_t duration of the sleep in nanoseconds.
+		 * @return	const overshoot_estimate& estimate of the duration's bucket.
+		 */
+		const overshoot_estimate &estimate(const uint64_t duration_ns) const {
+			return estimates[overshoot_model_bucket(duration_ns)];
+		}
+
+		/**
+		 * @brief	Method reset forgets every learnt overshoot.
+		 */
+		void reset() {
+			estimates.fill(overshoot_estimate{});
+		}
+
+	private:
+		/// Parameters of the estimator.
+		overshoot_model_config config;
+		/// Learnt overshoot of each bucket of durations.
+		std::array<overshoot_estimate, overshoot_model_buckets> estimates{};
+	};
+
+	/**
+	 * @brief	Function thread_overshoot_model gets the overshoot model of the calling thread.
+	 * @return	OvershootModel& model used by the adaptive sleeps made on the calling thread.
+	 */
+	inline OvershootModel &thread_overshoot_model() {
+		thread_local OvershootModel model;
+		return model;
+	}
+
+	/**************************************************************************************************/
+	/* Adaptive Sleep Implementations 																  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Function sleep_until_ns_adaptive sleeps in the kernel until the specified absolute time in
+	 * 			nanoseconds, waking early by the overshoot predicted by the model.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 * @param	model		OvershootModel to predict the overshoot with and to update with the result.
+	 */
+	inline void sleep_until_ns_adaptive(const uint64_t deadline_ns, OvershootModel &model) {
+		const uint64_t start_ns = now_ns();
+		if (start_ns >= deadline_ns) return;
+		const uint64_t duration_ns = deadline_ns - start_ns;
+		const uint64_t wake_ns = deadline_ns - model.predict_ns(duration_ns);
+		if (wake_ns <= start_ns) {
+			model.decay(duration_ns);
+			return;
+		}
+		sleep_until_ns_with<sleep_policy::kernel>(wake_ns);
+		model.update(duration_ns, static_cast<int64_t>(now_ns() - wake_ns));
+	}
+
+	/**
+	 * @brief	Function sleep_until_ns_adaptive sleeps in the kernel until the specified absolute time in
+	 * 			nanoseconds, waking early by the overshoot predicted by the calling thread's model.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 */
+	inline void sleep_until_ns_adaptive(const uint64_t deadline_ns) {
+		sleep_until_ns_adaptive(deadline_ns, thread_overshoot_model());
+	}
+
+	/**
+	 * @brief	Function sleep_us_adaptive sleeps for the specified number of microseconds in the kernel,
+	 * 			waking early by the overshoot predicted by the calling thread's model.
+	 * @param	us	uint32_t number of microseconds to sleep for.
+	 */
+	inline void sleep_us_adaptive(const uint32_t us) {
+		sleep_until_ns_adaptive(now_ns() + static_cast<uint64_t>(us) * 1'000);
+	}
+
+	/**
+	 * @brief	Function sleep_ms_adaptive sleeps for the specified number of milliseconds in the kernel,
+	 * 			waking early by the overshoot predicted by the calling thread's model.
+	 * @param	ms	uint32_t number of milliseconds to sleep for.
+	 */
+	inline void sleep_ms_adaptive(const uint32_t ms) {
+		sleep_until_ns_adaptive(now_ns() + static_cast<uint64_t>(ms) * 1'000'000);
+	}
+}
+
+#endif /* ADAPTIVE_SLEEP_HPP */
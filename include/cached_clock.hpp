@@ -0,0 +1,196 @@
+/**
+ * @file 	cached_clock.hpp
+ * @brief 	cached_clock.hpp defines a clock that is read with a single relaxed atomic load, for hot paths
+ * 			where even the cost of now_ns is too much.
+ * @details	The CachedClock class starts a background thread that publishes now_ns into a cache line of
+ * 			its own at a fixed cadence, sleeping between updates with a Sleeper so that the cadence is
+ * 			held as precisely as sleep_until_ns_hybrid holds a deadline and stop does not wait for the
+ * 			rest of a period. Readers trade accuracy for cost: a cached time is never ahead of now_ns,
+ * 			and is behind it by at most the period plus the latest the updater has woken, which is
+ * 			reported as the staleness bound. The updater spins for the last sleep margin of the hybrid
+ * 			sleep configuration of every period, so the default period of a millisecond keeps it asleep
+ * 			for most of each period, while periods shorter than the margin never sleep in the kernel and
+ * 			need a core dedicated to the updater.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef CACHED_CLOCK_HPP
+#define CACHED_CLOCK_HPP
+
+// C++ Standard Library Headers
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "sleeper.hpp"
+
+
+namespace high_resolution_sleep {
+	/// Default number of nanoseconds between updates of a CachedClock, well above the default sleep margin.
+	const static uint64_t cached_clock_default_period_ns = 1'000'000;
+
+	/**
+	 * @brief	Class CachedClock publishes the current time from a background thread so that it can be read
+	 * 			with a single relaxed load.
+	 * @details	The cached time is in the time base of now_ns, so it can be compared with now_ns and passed
+	 * 			as a deadline to the sleep functions. It is only refreshed while the clock is running, and
+	 * 			holds the last published time once stopped.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::CachedClock clock(10'000);
+	 * 			clock.start();
+	 * 			for (packet &p : packets) p.timestamp_ns = clock.now_ns();
+	 * 			clock.stop();
+	 * @endcode
+	 */
+	class CachedClock {
+	public:
+		/**
+		 * @brief	Constructor for CachedClock, which is stopped until start is called.
+		 * @param	period_ns	uint64_t number of nanoseconds between updates of the cached time.
+		 * @param	config		hybrid_sleep_config thresholds the updater sleeps between updates with.
+		 * @throws	std::invalid_argument if the period is zero.
+		 */
+		explicit CachedClock(const uint64_t period_ns = cached_clock_default_period_ns, const hybrid_sleep_config &config = hybrid_sleep_config{}) :
+			update_period_ns(period_ns), sleeper(config) {
+			if (period_ns == 0) {
+				throw std::invalid_argument("CachedClock::CachedClock: period_ns must be greater than zero.");
+			}
+		}
+
+		CachedClock(const CachedClock &) = delete;
+		CachedClock &operator=(const CachedClock &) = delete;
+
+		/**
+		 * @brief	Destructor for CachedClock that stops the updater.
+		 */
+		~CachedClock() {
+			stop();
+		}
+
+		/**
+		 * @brief	Method start publishes the current time and starts the background thread that keeps it updated.
+		 * @details	The time is published before the method returns, so reads made after start are never
+		 * 			staler than the staleness bound.
+		 * @throws	std::logic_error if the clock is already running.
+		 */
+		void start() {
+			if (updater.joinable()) {
+				throw std::logic_error("CachedClock::start: the clock is already running.");
+			}
+			const uint64_t current_ns = high_resolution_sleep::now_ns();
+			cached.time_ns.store(current_ns, std::memory_order_relaxed);
+			updater = std::thread([this, current_ns]() { update(current_ns); });
+		}
+
+		/**
+		 * @brief	Method stop wakes the background thread, publishes the time a last time and waits for the
+		 * 			thread to exit. Stopping a clock that is not running does nothing.
+		 */
+		void stop() {
+			if (!updater.joinable()) return;
+			sleeper.wake();
+			updater.join();
+		}
+
+		/**
+		 * @brief	Method is_running gets whether the background thread is updating the cached time.
+		 * @return	bool true between start and stop.
+		 */
+		bool is_running() const {
+			return updater.joinable();
+		}
+
+		/**
+		 * @brief	Method now_ns gets the cached time in nanoseconds.
+		 * @return	uint64_t last published time, in the time base of now_ns.
+		 */
+		uint64_t now_ns() const noexcept {
+			return cached.time_ns.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief	Method now_us gets the cached time in microseconds.
+		 * @return	uint64_t last published time, in the time base of now_us.
+		 */
+		uint64_t now_us() const noexcept {
+			return now_ns() / 1'000;
+		}
+
+		/**
+		 * @brief	Method period_ns gets the number of nanoseconds between updates of the cached time.
+		 * @return	uint64_t update period in nanoseconds.
+		 */
+		uint64_t period_ns() const {
+			return update_period_ns;
+		}
+
+		/**
+		 * @brief	Method staleness_bound_ns gets how far behind now_ns a read of the cached time has been able to be.
+		 * @return	uint64_t the period plus the latest the updater has woken after an update was due.
+		 * @details	The bound covers every read made before the latest update, so it only grows when the
+		 * 			updater is preempted or woken late by the kernel.
+		 */
+		uint64_t staleness_bound_ns() const {
+			return update_period_ns + max_lateness_ns.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief	Method updates gets the number of times the background thread has published the time.
+		 * @return	uint64_t number of updates since construction.
+		 */
+		uint64_t updates() const {
+			return update_count.load(std::memory_order_relaxed);
+		}
+
+	private:
+		/**
+		 * @brief	Method update is the body of the background thread, which publishes the time at each
+		 * 			deadline until woken by stop.
+		 * @param	start_ns	uint64_t time published by start, from which the deadlines are counted.
+		 */
+		void update(const uint64_t start_ns) {
+			uint64_t deadline_ns = start_ns + update_period_ns;
+			while (true) {
+				const bool stopping = sleeper.sleep_until_ns(deadline_ns) == WakeReason::Woken;
+				const uint64_t current_ns = high_resolution_sleep::now_ns();
+				cached.time_ns.store(current_ns, std::memory_order_relaxed);
+				update_count.fetch_add(1, std::memory_order_relaxed);
+				if (current_ns > deadline_ns && current_ns - deadline_ns > max_lateness_ns.load(std::memory_order_relaxed)) {
+					max_lateness_ns.store(current_ns - deadline_ns, std::memory_order_relaxed);
+				}
+				if (stopping) return;
+				// Count the next deadline from now rather than catching up on missed updates one by one.
+				deadline_ns += update_period_ns;
+				if (deadline_ns <= current_ns) deadline_ns = current_ns + update_period_ns;
+			}
+		}
+
+		/**
+		 * @brief	Struct cached_time holds the published time on a cache line of its own, so that updates
+		 * 			do not invalidate the line of any other data the readers use.
+		 */
+		struct alignas(64) cached_time {
+			/// Last published time in nanoseconds.
+			std::atomic<uint64_t> time_ns{0};
+		};
+
+		/// Published time, read by any number of threads.
+		cached_time cached;
+		/// Number of nanoseconds between updates.
+		const uint64_t update_period_ns;
+		/// Greatest number of nanoseconds an update has been published after it was due.
+		std::atomic<uint64_t> max_lateness_ns{0};
+		/// Number of updates published.
+		std::atomic<uint64_t> update_count{0};
+		/// Sleeper the updater waits on between updates, woken by stop.
+		Sleeper sleeper;
+		/// Background thread publishing the time.
+		std::thread updater;
+	};
+}
+
+#endif /* CACHED_CLOCK_HPP */
@@ -0,0 +1,237 @@
+/**
+ * @file 	coalescing_sleep.hpp
+ * @brief 	coalescing_sleep.hpp defines sleeps that may wake late by a caller-declared tolerance, so that
+ * 			the wakeups of many threads can be batched together.
+ * @details	A tolerant sleep wakes at the first instant of a grid of wakeup instants that is no earlier
+ * 			than its deadline, where the spacing of the grid is the largest power of two nanoseconds no
+ * 			greater than the tolerance. Every thread rounds onto the same grids of the now_ns time base,
+ * 			and the instants of a coarse grid are also instants of every finer grid, so sleeps with
+ * 			nearby deadlines land on common instants even when their tolerances differ. The threads
+ * 			waiting for an instant meet in a WakeupCoalescer, where the first of them sleeps in the
+ * 			kernel until the instant and then releases the others with one futex broadcast (a condition
+ * 			variable on platforms other than Linux), so the host services one timer per instant rather
+ * 			than one per thread.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef COALESCING_SLEEP_HPP
+#define COALESCING_SLEEP_HPP
+
+// C++ Standard Library Headers
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Platform Dependant System Libraries
+#ifdef __linux__
+	#include <climits>
+	#include <linux/futex.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#else
+	#include <condition_variable>
+#endif /* __linux__ */
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/**************************************************************************************************/
+	/* Wakeup Instants 																				  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Function coalesced_wakeup_ns gets the instant a tolerant sleep wakes at.
+	 * @param	deadline_ns		uint64_t earliest time to wake up at, in the same time base as now_ns.
+	 * @param	tolerance_ns	uint64_t number of nanoseconds the wakeup may be later than the deadline.
+	 * @return	uint64_t first instant no earlier than the deadline on the grid spaced by the largest power
+	 * 			of two no greater than the tolerance, which is less than the deadline plus the tolerance.
+	 */
+	inline uint64_t coalesced_wakeup_ns(const uint64_t deadline_ns, const uint64_t tolerance_ns) {
+		if (tolerance_ns == 0) return deadline_ns;
+		uint64_t granularity_ns = 1;
+		while (granularity_ns <= tolerance_ns / 2) granularity_ns <<= 1;
+		const uint64_t offset_ns = deadline_ns & (granularity_ns - 1);
+		if (offset_ns == 0) return deadline_ns;
+		const uint64_t wakeup_ns = deadline_ns - offset_ns + granularity_ns;
+		// Saturate rather than wrap for deadlines at the end of the time base.
+		return wakeup_ns > deadline_ns ? wakeup_ns : UINT64_MAX;
+	}
+
+	/**************************************************************************************************/
+	/* Wakeup Coalescer 																			  */
+	/**************************************************************************************************/
+	/// Number of wakeup instants that can be waited for at once without colliding.
+	const static size_t wakeup_coalescer_slots = 256;
+
+	/**
+	 * @brief	Struct wakeup_coalescer_stats holds the number of sleeps a WakeupCoalescer has served.
+	 */
+	struct wakeup_coalescer_stats {
+		/// Sleeps that slept in the kernel to wake the other sleeps of their instant.
+		uint64_t leaders = 0;
+		/// Sleeps that were released by the leader of their instant.
+		uint64_t followers = 0;
+		/// Sleeps that slept in the kernel alone because their slot was taken by another instant.
+		uint64_t collisions = 0;
+	};
+
+	/**
+	 * @brief	Class WakeupCoalescer releases every thread waiting for the same instant together.
+	 * @details	Each instant hashes to a slot. The first thread to wait for an instant claims its slot and
+	 * 			sleeps in the kernel until the instant, while later threads block on the slot until the
+	 * 			first releases them all at once. A thread whose slot is held by a different instant sleeps
+	 * 			in the kernel alone. The coalescer is thread safe, use shared_wakeup_coalescer to get the
+	 * 			one the tolerant sleeps use.
+	 */
+	class WakeupCoalescer {
+	public:
+		WakeupCoalescer() = default;
+		WakeupCoalescer(const WakeupCoalescer &) = delete;
+		WakeupCoalescer &operator=(const WakeupCoalescer &) = delete;
+
+		/**
+		 * @brief	Method sleep_until_ns sleeps until the specified instant, together with every other thread
+		 * 			sleeping until the same instant.
+		 * @param	wakeup_ns	uint64_t time to wake up at, in the same time base as now_ns.
+		 */
+		void sleep_until_ns(const uint64_t wakeup_ns) {
+			if (now_ns() >= wakeup_ns) return;
+			slot &instant_slot = slots[slot_index(wakeup_ns)];
+			std::unique_lock<std::mutex> lock(instant_slot.mutex);
+			// Follow the leader of the instant if there is one.
+			if (instant_slot.wakeup_ns == wakeup_ns) {
+				const uint32_t generation = instant_slot.generation.load(std::memory_order_relaxed);
+				lock.unlock();
+				followers.fetch_add(1, std::memory_order_relaxed);
+				wait_for_release(instant_slot, generation);
+				return;
+			}
+			// Sleep alone if the slot is led by another instant.
+			if (instant_slot.wakeup_ns != 0) {
+				lock.unlock();
+				collisions.fetch_add(1, std::memory_order_relaxed);
+				high_resolution_sleep::sleep_until_ns(wakeup_ns);
+				return;
+			}
+			// Otherwise lead the instant, sleeping until it and then releasing the followers.
+			instant_slot.wakeup_ns = wakeup_ns;
+			lock.unlock();
+			leaders.fetch_add(1, std::memory_order_relaxed);
+			high_resolution_sleep::sleep_until_ns(wakeup_ns);
+			lock.lock();
+			instant_slot.wakeup_ns = 0;
+			instant_slot.generation.fetch_add(1, std::memory_order_release);
+			#ifdef __linux__
+			lock.unlock();
+			syscall(SYS_futex, reinterpret_cast<uint32_t *>(&instant_slot.generation), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX, nullptr, nullptr, 0);
+			#else
+			lock.unlock();
+			instant_slot.condition.notify_all();
+			#endif /* __linux__ */
+		}
+
+		/**
+		 * @brief	Method stats gets the number of sleeps served so far.
+		 * @return	wakeup_coalescer_stats counts of leading, following and colliding sleeps.
+		 */
+		wakeup_coalescer_stats stats() const {
+			return wakeup_coalescer_stats{leaders.load(std::memory_order_relaxed), followers.load(std::memory_order_relaxed), collisions.load(std::memory_order_relaxed)};
+		}
+
+	private:
+		/**
+		 * @brief	Struct slot is where the threads waiting for one instant meet.
+		 */
+		struct alignas(64) slot {
+			/// Mutex protecting the instant.
+			std::mutex mutex;
+			/// Instant the slot is led for, or zero while the slot is free.
+			uint64_t wakeup_ns = 0;
+			/// Number of instants released from the slot, and the futex the followers block on.
+			std::atomic<uint32_t> generation{0};
+			#ifndef __linux__
+			/// Condition variable the followers block on.
+			std::condition_variable condition;
+			#endif /* __linux__ */
+		};
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free, "the futex word must be a plain 32 bit integer");
+
+		/**
+		 * @brief	Method slot_index gets the slot an instant is waited for in.
+		 * @param	wakeup_ns	uint64_t instant to wait for.
+		 * @return	size_t index of the slot.
+		 */
+		static size_t slot_index(const uint64_t wakeup_ns) {
+			// Fibonacci hashing spreads the instants of every grid evenly over the slots.
+			return static_cast<size_t>((wakeup_ns * 11'400'714'819'323'198'485ull) >> 56) % wakeup_coalescer_slots;
+		}
+
+		/**
+		 * @brief	Method wait_for_release blocks until the leader of the slot releases the given generation.
+		 * @param	instant_slot	slot to wait in.
+		 * @param	generation		uint32_t generation of the slot when the thread started following.
+		 */
+		static void wait_for_release(slot &instant_slot, const uint32_t generation) {
+			#ifdef __linux__
+			while (instant_slot.generation.load(std::memory_order_acquire) == generation) {
+				syscall(SYS_futex, reinterpret_cast<uint32_t *>(&instant_slot.generation), FUTEX_WAIT | FUTEX_PRIVATE_FLAG, generation, nullptr, nullptr, 0);
+			}
+			#else
+			std::unique_lock<std::mutex> lock(instant_slot.mutex);
+			instant_slot.condition.wait(lock, [&]() { return instant_slot.generation.load(std::memory_order_relaxed) != generation; });
+			#endif /* __linux__ */
+		}
+
+		/// Slots the instants are waited for in.
+		std::array<slot, wakeup_coalescer_slots> slots{};
+		/// Number of sleeps that led their instant.
+		std::atomic<uint64_t> leaders{0};
+		/// Number of sleeps that followed the leader of their instant.
+		std::atomic<uint64_t> followers{0};
+		/// Number of sleeps that found their slot led by another instant.
+		std::atomic<uint64_t> collisions{0};
+	};
+
+	/**
+	 * @brief	Function shared_wakeup_coalescer gets the coalescer shared by the tolerant sleeps of the process.
+	 * @return	WakeupCoalescer& coalescer used by sleep_until_ns_tolerant and sleep_us_tolerant.
+	 */
+	inline WakeupCoalescer &shared_wakeup_coalescer() {
+		static WakeupCoalescer coalescer;
+		return coalescer;
+	}
+
+	/**************************************************************************************************/
+	/* Tolerant Sleep Implementations 																  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Function sleep_until_ns_tolerant sleeps until the specified absolute time in nanoseconds or
+	 * 			up to the tolerance later, waking together with other tolerant sleeps where it can.
+	 * @param	deadline_ns		uint64_t earliest time to wake up at, in the same time base as now_ns.
+	 * @param	tolerance_ns	uint64_t number of nanoseconds the wakeup may be later than the deadline,
+	 * 							zero sleeps precisely with sleep_until_ns.
+	 */
+	inline void sleep_until_ns_tolerant(const uint64_t deadline_ns, const uint64_t tolerance_ns) {
+		if (tolerance_ns == 0) {
+			high_resolution_sleep::sleep_until_ns(deadline_ns);
+			return;
+		}
+		shared_wakeup_coalescer().sleep_until_ns(coalesced_wakeup_ns(deadline_ns, tolerance_ns));
+	}
+
+	/**
+	 * @brief	Function sleep_us_tolerant sleeps for the specified number of microseconds or up to the
+	 * 			tolerance longer, waking together with other tolerant sleeps where it can.
+	 * @param	us				uint32_t number of microseconds to sleep for.
+	 * @param	tolerance_us	uint32_t number of microseconds the sleep may be longer than asked for.
+	 */
+	inline void sleep_us_tolerant(const uint32_t us, const uint32_t tolerance_us) {
+		sleep_until_ns_tolerant(now_ns() + static_cast<uint64_t>(us) * 1'000, static_cast<uint64_t>(tolerance_us) * 1'000);
+	}
+}
+
+#endif /* COALESCING_SLEEP_HPP */
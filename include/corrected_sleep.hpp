@@ -0,0 +1,270 @@
+/**
+ * @file 	corrected_sleep.hpp
+ * @brief 	corrected_sleep.hpp defines a periodic sleep that holds a loop to a fixed schedule in
+ * 			nanoseconds, correcting the slip of each iteration with a proportional-integral controller.
+ * @details	sleep_ms_corrected corrects the slip of a periodic loop in whole milliseconds, so up to a
+ * 			millisecond of slip is left uncorrected and it cannot pace periods shorter than a millisecond.
+ * 			A CorrectedSleep instead tracks the schedule error of each wakeup, how far it landed from the
+ * 			ideal deadline start + n * period, and times each period from the last wakeup, shortened or
+ * 			lengthened by the correction of a ScheduleController. The integral term learns the steady
+ * 			slip of the wakeups past the time asked for, such as the wakeup latency of the kernel, so
+ * 			that the mean wakeup converges onto the schedule, while the proportional term removes the
+ * 			schedule error left by one-off delays. The proportional term is limited to a fraction of
+ * 			the period, so after a long stall each period is shortened by at most that fraction beyond
+ * 			the learnt slip and the schedule is caught up over several periods rather than with a burst
+ * 			of back to back wakeups, and the integral only learns from sleeps that waited so that a
+ * 			stall does not wind it up.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef CORRECTED_SLEEP_HPP
+#define CORRECTED_SLEEP_HPP
+
+// C++ Standard Library Headers
+#include <cstdint>
+#include <stdexcept>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/**************************************************************************************************/
+	/* Schedule Controller 																			  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Struct corrected_sleep_config holds the parameters of the schedule controller.
+	 */
+	struct corrected_sleep_config {
+		/// Fraction of the schedule error of the last wakeup that the next period is shortened by.
+		double proportional_gain = 0.5;
+		/// Fraction of the difference between the slip of each wakeup and the learnt steady slip that is
+		/// added to the learnt steady slip.
+		double integral_gain = 0.2;
+		/// Largest fraction of the period the proportional term may move a wakeup by, which bounds how
+		/// quickly the schedule is caught up after a stall.
+		double max_catch_up = 0.25;
+	};
+
+	/**
+	 * @brief	Class ScheduleController computes how much to shorten the next period by from the
+	 * 			schedule error of each wakeup.
+	 * @details	The correction is the sum of the proportional term of the schedule error, limited to
+	 * 			max_catch_up of the period, and the integral term, the learnt slip of the wakeups past the
+	 * 			time asked for, limited to one period. The integral term only learns from learn_slip, so the
+	 * 			schedule error of a stall is caught up by the proportional term alone and does not wind it
+	 * 			up. The controller is not thread safe.
+	 */
+	class ScheduleController {
+	public:
+		/**
+		 * @brief	Constructor for ScheduleController.
+		 * @param	period_ns	uint64_t number of nanoseconds between the deadlines of the schedule.
+		 * @param	config		corrected_sleep_config parameters of the controller.
+		 * @throws	std::invalid_argument if the period is zero, a gain is negative, the integral gain is
+		 * 			greater than one or max_catch_up is not between zero and one.
+		 */
+		explicit ScheduleController(const uint64_t period_ns, const corrected_sleep_config &config = corrected_sleep_config{}) :
+			config(config), schedule_period_ns(period_ns) {
+			if (period_ns == 0 || period_ns > INT64_MAX) {
+				throw std::invalid_argument("ScheduleController::ScheduleController: period_ns must be greater than zero and at most INT64_MAX.");
+			}
+			if (config.proportional_gain < 0.0 || config.integral_gain < 0.0) {
+				throw std::invalid_argument("ScheduleController::ScheduleController: the gains must not be negative.");
+			}
+			if (config.integral_gain > 1.0) {
+				throw std::invalid_argument("ScheduleController::ScheduleController: integral_gain must be at most one.");
+			}
+			if (config.max_catch_up < 0.0 || config.max_catch_up > 1.0) {
+				throw std::invalid_argument("ScheduleController::ScheduleController: max_catch_up must be between zero and one.");
+			}
+		}
+
+		/**
+		 * @brief	Method update computes the correction for the next period from the schedule error of a
+		 * 			wakeup and the learnt slip.
+		 * @param	error_ns	int64_t number of nanoseconds the wakeup was after its ideal deadline, negative if before.
+		 * @return	int64_t number of nanoseconds to shorten the next period by, negative to lengthen it.
+		 */
+		int64_t update(const int64_t error_ns) {
+			const double limit_ns = config.max_catch_up * static_cast<double>(schedule_period_ns);
+			double proportional_ns = config.proportional_gain * static_cast<double>(error_ns);
+			if (proportional_ns > limit_ns) proportional_ns = limit_ns;
+			else if (proportional_ns < -limit_ns) proportional_ns = -limit_ns;
+			next_correction_ns = static_cast<int64_t>(proportional_ns + integral_term_ns);
+			return next_correction_ns;
+		}
+
+		/**
+		 * @brief	Method learn_slip learns how late a wakeup was past the time asked for, such as the wakeup
+		 * 			latency of the kernel. Call it before update for the same wakeup.
+		 * @param	slip_ns	int64_t number of nanoseconds the wakeup was after the time asked for.
+		 */
+		void learn_slip(const int64_t slip_ns) {
+			integral_term_ns += config.integral_gain * (static_cast<double>(slip_ns) - integral_term_ns);
+			const double period_ns = static_cast<double>(schedule_period_ns);
+			if (integral_term_ns > period_ns) integral_term_ns = period_ns;
+			else if (integral_term_ns < -period_ns) integral_term_ns = -period_ns;
+		}
+
+		/**
+		 * @brief	Method correction_ns gets the correction computed by the last update.
+		 * @return	int64_t number of nanoseconds to shorten the next period by, negative to lengthen it.
+		 */
+		int64_t correction_ns() const {
+			return next_correction_ns;
+		}
+
+		/**
+		 * @brief	Method integral_ns gets the learnt steady slip of the wakeups.
+		 * @return	double integral term of the correction in nanoseconds.
+		 */
+		double integral_ns() const {
+			return integral_term_ns;
+		}
+
+		/**
+		 * @brief	Method period_ns gets the number of nanoseconds between the deadlines of the schedule.
+		 * @return	uint64_t period in nanoseconds.
+		 */
+		uint64_t period_ns() const {
+			return schedule_period_ns;
+		}
+
+		/**
+		 * @brief	Method reset forgets the learnt slip and the correction.
+		 */
+		void reset() {
+			integral_term_ns = 0.0;
+			next_correction_ns = 0;
+		}
+
+	private:
+		/// Parameters of the controller.
+		corrected_sleep_config config;
+		/// Number of nanoseconds between the deadlines of the schedule.
+		uint64_t schedule_period_ns;
+		/// Integral term of the correction in nanoseconds.
+		double integral_term_ns = 0.0;
+		/// Correction computed by the last update in nanoseconds.
+		int64_t next_correction_ns = 0;
+	};
+
+	/**************************************************************************************************/
+	/* Corrected Sleep Implementation 																  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Class CorrectedSleep paces a loop to a fixed period, sleeping at the end of each iteration
+	 * 			until the corrected deadline of the next one.
+	 * @details	The schedule starts at the first call to sleep, or the first call after reset, and each call
+	 * 			sleeps until a period after the last wakeup less the correction of the controller, using
+	 * 			the strategy of Policy. Since the correction only includes the proportional term up to
+	 * 			max_catch_up of the period, a wakeup is never sooner than (1 - max_catch_up) of a period
+	 * 			less the learnt slip after the last one, however far behind the schedule is. The kernel policy learns to wake early by the wakeup latency of the
+	 * 			kernel, so it can pace periods down to about 100 microseconds without spinning, while the
+	 * 			hybrid policy leaves the controller only the slip of the loop itself to correct. Time spent
+	 * 			in the body of the loop counts towards the period, so a body longer than the period falls
+	 * 			behind the schedule for as long as it runs long.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::CorrectedSleep pacer(250'000);
+	 * 			while (CONDITION) {
+	 * 				do_work();
+	 * 				pacer.sleep();
+	 * 			}
+	 * @endcode
+	 */
+	template <typename Policy = sleep_policy::kernel>
+	class CorrectedSleep {
+	public:
+		/**
+		 * @brief	Constructor for CorrectedSleep.
+		 * @param	period_ns	uint64_t number of nanoseconds between the deadlines of the schedule.
+		 * @param	config		corrected_sleep_config parameters of the controller.
+		 * @throws	std::invalid_argument if the controller parameters are invalid.
+		 */
+		explicit CorrectedSleep(const uint64_t period_ns, const corrected_sleep_config &config = corrected_sleep_config{}) :
+			schedule_controller(period_ns, config) {}
+
+		/**
+		 * @brief	Method sleep sleeps until the corrected deadline of the next period and learns from how
+		 * 			far the wakeup landed from it.
+		 * @return	int64_t number of nanoseconds the wakeup was after its ideal deadline, negative if before.
+		 */
+		int64_t sleep() {
+			if (!started) {
+				last_wake_ns = now_ns();
+				schedule_deadline_ns = last_wake_ns;
+				started = true;
+			}
+			schedule_deadline_ns += schedule_controller.period_ns();
+			// The period is timed from the last wakeup rather than the deadline, so that deadlines left in
+			// the past by a stall are caught up at the rate the controller allows instead of all at once.
+			const int64_t correction_ns = schedule_controller.correction_ns();
+			uint64_t wake_ns = last_wake_ns + schedule_controller.period_ns();
+			if (correction_ns >= 0) wake_ns -= static_cast<uint64_t>(correction_ns) < wake_ns ? static_cast<uint64_t>(correction_ns) : wake_ns;
+			else wake_ns += static_cast<uint64_t>(-correction_ns);
+			const bool waits = now_ns() < wake_ns;
+			sleep_until_ns_with<Policy>(wake_ns);
+			last_wake_ns = now_ns();
+			last_error_ns = static_cast<int64_t>(last_wake_ns - schedule_deadline_ns);
+			// A body that ran past the wakeup is not slip, so only sleeps that waited are learnt from.
+			if (waits) schedule_controller.learn_slip(static_cast<int64_t>(last_wake_ns - wake_ns));
+			schedule_controller.update(last_error_ns);
+			return last_error_ns;
+		}
+
+		/**
+		 * @brief	Method error_ns gets the schedule error of the last wakeup.
+		 * @return	int64_t number of nanoseconds the last wakeup was after its ideal deadline, negative if before.
+		 */
+		int64_t error_ns() const {
+			return last_error_ns;
+		}
+
+		/**
+		 * @brief	Method deadline_ns gets the ideal deadline of the last wakeup.
+		 * @return	uint64_t deadline in the time base of now_ns, zero before the first sleep.
+		 */
+		uint64_t deadline_ns() const {
+			return schedule_deadline_ns;
+		}
+
+		/**
+		 * @brief	Method controller gets the controller correcting the wakeups.
+		 * @return	const ScheduleController& controller of the schedule.
+		 */
+		const ScheduleController &controller() const {
+			return schedule_controller;
+		}
+
+		/**
+		 * @brief	Method reset restarts the schedule at the next call to sleep, dropping any slip still to
+		 * 			be caught up. The learnt steady slip is kept unless forget is true.
+		 * @param	forget	bool whether to also forget the learnt slip of the controller.
+		 */
+		void reset(const bool forget = false) {
+			started = false;
+			schedule_deadline_ns = 0;
+			last_wake_ns = 0;
+			last_error_ns = 0;
+			if (forget) schedule_controller.reset();
+			// An error of zero keeps the learnt slip but drops the proportional term of the last wakeup.
+			else schedule_controller.update(0);
+		}
+
+	private:
+		/// Controller computing the correction of each wakeup.
+		ScheduleController schedule_controller;
+		/// Whether the schedule has been started by a call to sleep.
+		bool started = false;
+		/// Ideal deadline of the last wakeup.
+		uint64_t schedule_deadline_ns = 0;
+		/// Time of the last wakeup, which the next period is timed from.
+		uint64_t last_wake_ns = 0;
+		/// Schedule error of the last wakeup.
+		int64_t last_error_ns = 0;
+	};
+}
+
+#endif /* CORRECTED_SLEEP_HPP */
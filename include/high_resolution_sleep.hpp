@@ -9,7 +9,20 @@
  * 			slightly better resolution than sleep at little performance cost. The sleep_us 
  * 			function uses a combination of sleeping and busy waiting to attain the minimal 
  * 			error possible, at the cost of performance, thus it is advisable to use sleep_ms
- * 			where possible on Windows platforms
+ * 			where possible on Windows platforms. On UNIX platforms the sleep_us function 
+ * 			sleeps in the kernel, while sleep_us_hybrid opts in to sleeping for most of the
+ * 			interval using nanosleep, then yielding and busy waiting for the remainder, with
+ * 			configurable thresholds. Busy waits use pause with exponential backoff, or tpause
+ * 			where WAITPKG is available.
+ * 			The clock_source tags choose the clock read by now_ns_on and waited on by sleep_until_ns_on,
+ * 			sleep_until_ns_hybrid_on, sleep_for_on and sleep_until_on, and now_ms_coarse reads the
+ * 			coarse clock for hot paths needing millisecond accuracy.
+ * 			Defining HIGH_RESOLUTION_SLEEP_INSTRUMENTATION before including the file records the
+ * 			accuracy of every sleep_ms, sleep_ms_corrected and sleep_us call into the per-thread
+ * 			histograms of sleep_latency_histogram.hpp.
+ * 			Every function is inline so the header can be included in any number of translation units.
+ * 			Defining HIGH_RESOLUTION_SLEEP_COMPILED, as the precompiled sleep::sleep CMake target does,
+ * 			instead compiles the calibration and initialisation functions once into the library.
  * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
  * @date 	2023-06-13
  */
@@ -18,25 +31,248 @@
 #define SLEEP_HPP
 
 // C++ Standard Library Headers
+#include <chrono>
 #include <cstdint>
+#include <ratio>
+#include <type_traits>
 
 // Platform Dependant System Libraries
+#if defined(__x86_64__) || defined(_M_X64)
+	#define HIGH_RESOLUTION_SLEEP_HAS_PAUSE
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+		#include <x86intrin.h>
+	#endif /* _MSC_VER */
+#endif /* __x86_64__ || _M_X64 */
+
 #ifdef _WIN32
-	#define WIN32_LEAN_AND_MEAN
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif /* WIN32_LEAN_AND_MEAN */
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif /* NOMINMAX */
 	#include <windows.h>
 	#include <timeapi.h>
 #else /* UNIX */
 	#include <time.h>
 	#include <errno.h>
+	#include <sched.h>
 
 	#ifdef __APPLE__
 		#include <mach/clock.h>
 		#include <mach/mach.h>
 	#endif	/* __APPLE__ */
+
+	#ifdef __linux__
+		#include <sys/prctl.h>
+	#endif	/* __linux__ */
 #endif /* _WIN32 */
 
+// Optional Instrumentation
+#ifdef HIGH_RESOLUTION_SLEEP_INSTRUMENTATION
+	#include "sleep_latency_histogram.hpp"
+	/// Records the enclosing sleep call into the calling thread's latency histograms.
+	#define HIGH_RESOLUTION_SLEEP_RECORD(function, requested_ns) \
+		::high_resolution_sleep::sleep_latency_recorder sleep_latency_recorder_scope(::high_resolution_sleep::InstrumentedSleep::function, requested_ns)
+	/// Stops instrumented sleeps made within the enclosing scope from being recorded.
+	#define HIGH_RESOLUTION_SLEEP_SUPPRESS_RECORDING() \
+		::high_resolution_sleep::sleep_latency_recorder sleep_latency_recorder_scope
+#else
+	#define HIGH_RESOLUTION_SLEEP_RECORD(function, requested_ns)
+	#define HIGH_RESOLUTION_SLEEP_SUPPRESS_RECORDING()
+#endif /* HIGH_RESOLUTION_SLEEP_INSTRUMENTATION */
+
+// Compiled Library Configuration
+#ifdef HIGH_RESOLUTION_SLEEP_COMPILED
+	/// Calibration and initialisation functions are compiled once into the sleep library rather than inlined.
+	#define HIGH_RESOLUTION_SLEEP_COLD
+#else
+	#define HIGH_RESOLUTION_SLEEP_COLD inline
+#endif /* HIGH_RESOLUTION_SLEEP_COMPILED */
+#if !defined(HIGH_RESOLUTION_SLEEP_COMPILED) || defined(HIGH_RESOLUTION_SLEEP_IMPLEMENTATION)
+	/// Defined in the translation units that provide the definitions of the calibration and initialisation functions.
+	#define HIGH_RESOLUTION_SLEEP_DEFINE_COLD
+#endif /* !HIGH_RESOLUTION_SLEEP_COMPILED || HIGH_RESOLUTION_SLEEP_IMPLEMENTATION */
 
 namespace high_resolution_sleep {
+	/// Declaration of now_ns, which is defined for each platform below, for use by the spin wait.
+	inline const uint64_t now_ns();
+
+	/**************************************************************************************************/
+	/* Spin Wait Implementations		 															  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Enum SpinStrategy is the instruction used while busy waiting for a deadline.
+	 */
+	enum class SpinStrategy {
+		/// Reads the clock in a tight loop.
+		Busy,
+		/// Issues pause instructions between reads of the clock, backing off exponentially.
+		Pause,
+		/// Waits in the C0.1 power state with tpause until a TSC deadline, requires WAITPKG.
+		WaitPkg
+	};
+
+	/// Maximum number of pause instructions issued between reads of the clock.
+	const static uint32_t spin_max_pauses = 64;
+	/// Number of pause instructions timed to measure the cost of one.
+	const static uint32_t spin_pause_calibration_count = 1'000;
+
+	/**
+	 * @brief	Function cpu_relax hints to the processor that the thread is busy waiting, which saves power
+	 * 			and yields execution resources to the SMT sibling.
+	 */
+	inline void cpu_relax() {
+		#if defined(HIGH_RESOLUTION_SLEEP_HAS_PAUSE)
+		_mm_pause();
+		#elif defined(__aarch64__)
+		asm volatile("yield" ::: "memory");
+		#endif /* HIGH_RESOLUTION_SLEEP_HAS_PAUSE */
+	}
+
+	/**
+	 * @brief	Function waitpkg_is_supported checks whether the processor supports the tpause instruction.
+	 * @return	bool true if the WAITPKG extension is available.
+	 */
+	inline bool waitpkg_is_supported() {
+		#ifdef HIGH_RESOLUTION_SLEEP_HAS_PAUSE
+		// The WAITPKG flag is bit 5 of ECX in the structured extended feature leaf.
+		#ifdef _MSC_VER
+		int registers[4];
+		__cpuid(registers, 0);
+		if (registers[0] < 7) return false;
+		__cpuidex(registers, 7, 0);
+		return (registers[2] & (1 << 5)) != 0;
+		#else
+		unsigned int eax, ebx, ecx, edx;
+		if (__get_cpuid_max(0, nullptr) < 7) return false;
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		return (ecx & (1 << 5)) != 0;
+		#endif /* _MSC_VER */
+		#else
+		return false;
+		#endif /* HIGH_RESOLUTION_SLEEP_HAS_PAUSE */
+	}
+
+	/**
+	 * @brief	Function default_spin_strategy gets the most power efficient spin strategy supported by the processor.
+	 * @return	SpinStrategy WaitPkg where tpause is supported, otherwise Pause.
+	 */
+	inline SpinStrategy default_spin_strategy() {
+		static const SpinStrategy strategy = waitpkg_is_supported() ? SpinStrategy::WaitPkg : SpinStrategy::Pause;
+		return strategy;
+	}
+
+	/**
+	 * @brief	Function measure_pause_cost_ps measures how long one cpu_relax takes on the calling processor.
+	 * @return	uint64_t number of picoseconds per cpu_relax, at least one.
+	 */
+	#ifdef HIGH_RESOLUTION_SLEEP_DEFINE_COLD
+	HIGH_RESOLUTION_SLEEP_COLD uint64_t measure_pause_cost_ps() {
+		const uint64_t start_ns = now_ns();
+		for (uint32_t i = 0; i < spin_pause_calibration_count; i++) cpu_relax();
+		const uint64_t cost_ps = (now_ns() - start_ns) * 1'000 / spin_pause_calibration_count;
+		return cost_ps > 0 ? cost_ps : 1;
+	}
+	#else
+	uint64_t measure_pause_cost_ps();
+	#endif /* HIGH_RESOLUTION_SLEEP_DEFINE_COLD */
+
+	/**
+	 * @brief	Function pause_cost_ps gets the cost of one cpu_relax, measuring it on first use.
+	 * @return	uint64_t number of picoseconds per cpu_relax.
+	 * @details	The measurement takes spin_pause_calibration_count pauses, at most tens of microseconds,
+	 * 			which delays the first spin of the process unless pause_cost_ps is called beforehand.
+	 */
+	inline uint64_t pause_cost_ps() {
+		static const uint64_t cost_ps = measure_pause_cost_ps();
+		return cost_ps;
+	}
+
+	#ifdef HIGH_RESOLUTION_SLEEP_HAS_PAUSE
+	/**
+	 * @brief	Function tpause_until_ns waits with tpause until the specified absolute time in nanoseconds.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 * @details	The remaining nanoseconds are used as the number of TSC ticks to wait for. Every processor
+	 * 			with WAITPKG has a TSC of at least 1 GHz, so each tpause ends at or before the deadline and
+	 * 			the remainder shrinks geometrically. Must only be called when waitpkg_is_supported.
+	 */
+	#ifndef _MSC_VER
+	__attribute__((target("waitpkg")))
+	#endif /* _MSC_VER */
+	inline void tpause_until_ns(const uint64_t deadline_ns) {
+		uint64_t current_ns = now_ns();
+		while (current_ns < deadline_ns) {
+			// Control value 1 selects the C0.1 state, which wakes faster than C0.2.
+			_tpause(1, __rdtsc() + (deadline_ns - current_ns));
+			current_ns = now_ns();
+		}
+	}
+	#endif /* HIGH_RESOLUTION_SLEEP_HAS_PAUSE */
+
+	/**
+	 * @brief	Function spin_until_ns busy waits until the specified absolute time in nanoseconds using the
+	 * 			provided spin strategy.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 * @param	strategy	SpinStrategy to wait with, WaitPkg falls back to Pause where tpause is unsupported.
+	 * @details	The Pause strategy doubles the number of pauses between reads of the clock up to
+	 * 			spin_max_pauses, while never pausing for more than half of the remaining time.
+	 */
+	inline void spin_until_ns(const uint64_t deadline_ns, const SpinStrategy strategy) {
+		if (strategy == SpinStrategy::Busy) {
+			while (now_ns() < deadline_ns);
+			return;
+		}
+		#ifdef HIGH_RESOLUTION_SLEEP_HAS_PAUSE
+		if (strategy == SpinStrategy::WaitPkg && default_spin_strategy() == SpinStrategy::WaitPkg) {
+			tpause_until_ns(deadline_ns);
+			return;
+		}
+		#endif /* HIGH_RESOLUTION_SLEEP_HAS_PAUSE */
+		const uint64_t cost_ps = pause_cost_ps();
+		uint64_t pauses = 1;
+		uint64_t current_ns = now_ns();
+		while (current_ns < deadline_ns) {
+			// Limit the pauses to half of the remaining time, which is capped to keep the product in range.
+			const uint64_t remaining_ns = deadline_ns - current_ns < 1'000'000 ? deadline_ns - current_ns : 1'000'000;
+			const uint64_t limit = remaining_ns * 500 / cost_ps;
+			const uint64_t count = pauses < limit ? pauses : (limit > 0 ? limit : 1);
+			for (uint64_t i = 0; i < count; i++) cpu_relax();
+			if (pauses < spin_max_pauses) pauses *= 2;
+			current_ns = now_ns();
+		}
+	}
+
+	/**
+	 * @brief	Function spin_until_ns busy waits until the specified absolute time in nanoseconds using the
+	 * 			most power efficient spin strategy supported by the processor.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 */
+	inline void spin_until_ns(const uint64_t deadline_ns) {
+		spin_until_ns(deadline_ns, default_spin_strategy());
+	}
+
+	/**
+	 * @brief	Struct hybrid_sleep_config holds the thresholds used by the hybrid sleep-then-spin strategy.
+	 * @details	The hybrid strategy sleeps in the kernel until sleep_margin_ns before the deadline, then
+	 * 			yields the processor until spin_threshold_ns before the deadline, then busy waits for the
+	 * 			remainder. Setting both thresholds to zero gives a plain kernel sleep. The thresholds are
+	 * 			also used by other sleep-then-spin waits, such as the Sleeper of sleeper.hpp.
+	 * 			The default margin covers the 50 microsecond default timer slack of Linux and the wakeup
+	 * 			latency of an idle host, so each wait keeps a core busy yielding and spinning for up to
+	 * 			60 microseconds, and waits shorter than the margin never sleep in the kernel at all.
+	 */
+	struct hybrid_sleep_config {
+		/// Number of nanoseconds before the deadline at which the kernel sleep phase ends, should cover the wakeup latency and timer slack.
+		uint64_t sleep_margin_ns = 60'000;
+		/// Number of nanoseconds before the deadline at which yielding stops and busy waiting begins.
+		uint64_t spin_threshold_ns = 5'000;
+	};
+
 	/**************************************************************************************************/
 	/* UNIX Implementations			 																  */
 	/**************************************************************************************************/
@@ -45,7 +281,8 @@ namespace high_resolution_sleep {
 	 * @brief	Function sleep_ms sleeps for the specified number of milliseconds.
 	 * @param	ms	uint32_t number of milliseconds to sleep for.
 	 */
-	const void sleep_ms(const uint32_t ms) {
+	inline const void sleep_ms(const uint32_t ms) {
+		HIGH_RESOLUTION_SLEEP_RECORD(SleepMs, static_cast<uint64_t>(ms) * 1'000'000);
 		struct timespec ts;
 		ts.tv_sec = ms / 1000;
 		ts.tv_nsec = ms % 1000 * 1000000;
@@ -53,17 +290,6 @@ namespace high_resolution_sleep {
 		while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
 	}
 
-	/**
-	 * @brief	Function sleep_us sleeps for the specified number of microseconds.
-	 * @param	us	uint32_t number of microseconds to sleep for.
-	 */
-	const void sleep_us(const uint32_t us) {
-		struct timespec ts;
-		ts.tv_sec = us / 1000000;
-		ts.tv_nsec = us % 1000000 * 1000;
-
-		while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
-	}
 
 	/**
 	 * 	@brief		Function sleep_ms_corrected sleeps for the specified number of milliseconds minus
@@ -72,7 +298,8 @@ namespace high_resolution_sleep {
 	 *	@param		error_us 	int64_t number of microseconds of error accumulated by sleeping.
 	 *	@details	This function is intended to be used in the included kind of error tracking pattern,
 	 *				where the schedule slip is tracked with each iteration, so when the slip gets too large
-	 *				a sleep is skipped and the schedule catches back up.
+	 *				a sleep is skipped and the schedule catches back up. The slip is only corrected in
+	 *				whole milliseconds, CorrectedSleep from corrected_sleep.hpp corrects it in nanoseconds.
 	 *	@code 		{.cpp}
 	 *				int64_t start_time_us, error_us = 0;
 	 *				uint32_t duration_ms = 1;
@@ -83,11 +310,12 @@ namespace high_resolution_sleep {
 	 *				}
 	 * 	@endcode
 	 */
-	const void sleep_ms_corrected(const uint32_t ms, const int64_t error_us) {
+	inline const void sleep_ms_corrected(const uint32_t ms, const int64_t error_us) {
 		// If the error is greater than or equal to the requested sleep duration, skip the sleep.
-		int32_t adjusted_sleep_ms = ms - (error_us / 1'000);
+		const int64_t adjusted_sleep_ms = static_cast<int64_t>(ms) - (error_us / 1'000);
+		HIGH_RESOLUTION_SLEEP_RECORD(SleepMsCorrected, adjusted_sleep_ms > 0 ? static_cast<uint64_t>(adjusted_sleep_ms) * 1'000'000 : 0);
 		if (adjusted_sleep_ms > 0) {
-			sleep_ms(adjusted_sleep_ms);
+			sleep_ms(adjusted_sleep_ms < UINT32_MAX ? static_cast<uint32_t>(adjusted_sleep_ms) : UINT32_MAX);
 		}
 		return;
 	}
@@ -100,7 +328,7 @@ namespace high_resolution_sleep {
 	 * @brief	Function now_us gets the current system time in microseconds.
 	 * @return	uint64_t current system time in microseconds.
 	 */
-	const uint64_t now_us() {
+	inline const uint64_t now_us() {
 		struct timespec now;
 		clock_gettime(CLOCK_MONOTONIC, &now);
 		return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
@@ -110,18 +338,32 @@ namespace high_resolution_sleep {
 	 * @brief	Function now_ns gets the current system time in nanoseconds.
 	 * @return	uint64_t current system time in nanoseconds.
 	 */
-	const uint64_t now_ns() {
+	inline const uint64_t now_ns() {
 		struct timespec now;
 		clock_gettime(CLOCK_MONOTONIC, &now);
 		return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
 	}
 
+	/**
+	 * @brief	Function sleep_until_ns sleeps until the specified absolute time in nanoseconds.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 * @details	The deadline is passed to clock_nanosleep as an absolute CLOCK_MONOTONIC time, so neither
+	 * 			preemption before the call nor restarting after a signal shifts the wakeup time.
+	 */
+	inline const void sleep_until_ns(const uint64_t deadline_ns) {
+		struct timespec ts;
+		ts.tv_sec = deadline_ns / 1'000'000'000;
+		ts.tv_nsec = deadline_ns % 1'000'000'000;
+
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+	}
+
 	#else /* APPLE */
 	/**
 	 * @brief	Function now_us gets the current system time in microseconds.
 	 * @return	uint64_t current system time in microseconds.
 	 */
-	const uint64_t now_us() {
+	inline const uint64_t now_us() {
 		clock_serv_t cs;
 		mach_timespec_t ts;
 
@@ -136,7 +378,7 @@ namespace high_resolution_sleep {
 	 * @brief	Function now_ns gets the current system time in nanoseconds.
 	 * @return	uint64_t current system time in nanoseconds.
 	 */
-	const uint64_t now_ns() {
+	inline const uint64_t now_ns() {
 		clock_serv_t cs;
 		mach_timespec_t ts;
 
@@ -146,7 +388,153 @@ namespace high_resolution_sleep {
 
 		return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
 	}
+
+	/**
+	 * @brief	Function sleep_until_ns sleeps until the specified absolute time in nanoseconds.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 * @details	Apple platforms do not provide clock_nanosleep, so the remaining time is recalculated
+	 * 			against now_ns each time the relative nanosleep is interrupted.
+	 */
+	inline const void sleep_until_ns(const uint64_t deadline_ns) {
+		uint64_t current_ns = now_ns();
+		while (current_ns < deadline_ns) {
+			struct timespec ts;
+			ts.tv_sec = (deadline_ns - current_ns) / 1'000'000'000;
+			ts.tv_nsec = (deadline_ns - current_ns) % 1'000'000'000;
+			if (nanosleep(&ts, NULL) == 0) break;
+			current_ns = now_ns();
+		}
+	}
 	#endif /* __APPLE__ */
+
+	/**
+	 * @brief	Function sleep_until_us sleeps until the specified absolute time in microseconds.
+	 * @param	deadline_us	uint64_t time to wake up at, in the same time base as now_us.
+	 */
+	inline const void sleep_until_us(const uint64_t deadline_us) {
+		sleep_until_ns(deadline_us * 1'000);
+	}
+
+	/**************************************************************************************************/
+	/* Linux Timer Slack Implementations	 														  */
+	/**************************************************************************************************/
+	#ifdef __linux__
+	/**
+	 * @brief	Function set_timer_slack_ns sets the timer slack of the calling thread.
+	 * @param	slack_ns	uint64_t number of nanoseconds the kernel may delay the thread's timer wakeups
+	 * 						by so that they can be grouped with others, or zero to restore the default.
+	 * @return	bool true if the timer slack was set.
+	 * @details	Linux applies a default timer slack of 50 microseconds to normal priority threads, which
+	 * 			dominates the overshoot of short kernel sleeps.
+	 */
+	inline bool set_timer_slack_ns(const uint64_t slack_ns) {
+		return prctl(PR_SET_TIMERSLACK, static_cast<unsigned long>(slack_ns), 0, 0, 0) == 0;
+	}
+
+	/**
+	 * @brief	Function get_timer_slack_ns gets the timer slack of the calling thread.
+	 * @return	uint64_t number of nanoseconds of timer slack.
+	 */
+	inline uint64_t get_timer_slack_ns() {
+		return static_cast<uint64_t>(prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0));
+	}
+
+	/**
+	 * @brief	Class TimerSlackGuard sets the timer slack of the calling thread for the lifetime of the guard.
+	 * @details	The guard must be destroyed on the thread that created it, since timer slack is per thread.
+	 * @code 	{.cpp}
+	 * 			{
+	 * 				high_resolution_sleep::TimerSlackGuard guard(1);
+	 * 				high_resolution_sleep::sleep_us(50);
+	 * 			}
+	 * @endcode
+	 */
+	class TimerSlackGuard {
+	public:
+		/**
+		 * @brief	Constructor for TimerSlackGuard that saves the current timer slack and sets a new one.
+		 * @param	slack_ns	uint64_t number of nanoseconds of timer slack to use within the scope.
+		 */
+		explicit TimerSlackGuard(const uint64_t slack_ns) : previous_slack_ns(get_timer_slack_ns()) {
+			applied = set_timer_slack_ns(slack_ns);
+		}
+
+		TimerSlackGuard(const TimerSlackGuard &) = delete;
+		TimerSlackGuard &operator=(const TimerSlackGuard &) = delete;
+
+		/**
+		 * @brief	Destructor for TimerSlackGuard that restores the saved timer slack.
+		 */
+		~TimerSlackGuard() {
+			if (applied) set_timer_slack_ns(previous_slack_ns);
+		}
+
+		/**
+		 * @brief	Method is_applied gets whether the timer slack was set by the guard.
+		 * @return	bool true if the timer slack was set.
+		 */
+		bool is_applied() const {
+			return applied;
+		}
+
+	private:
+		/// Timer slack of the thread before the guard was created.
+		uint64_t previous_slack_ns;
+		/// Flag for if the new timer slack was set.
+		bool applied = false;
+	};
+	#endif /* __linux__ */
+
+	/**************************************************************************************************/
+	/* UNIX Hybrid Sleep Implementations	 														  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Function sleep_until_ns_hybrid sleeps until the specified absolute time in nanoseconds using
+	 * 			the hybrid sleep-then-spin strategy with the provided thresholds.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 * @param	config		hybrid_sleep_config thresholds to use for the sleep, yield and spin phases.
+	 */
+	inline const void sleep_until_ns_hybrid(const uint64_t deadline_ns, const hybrid_sleep_config &config) {
+		uint64_t current_ns = now_ns();
+		while (current_ns < deadline_ns) {
+			uint64_t remaining_ns = deadline_ns - current_ns;
+			// If there is more time remaining than the margin, sleep in the kernel until the margin.
+			if (remaining_ns > config.sleep_margin_ns) {
+				sleep_until_ns(deadline_ns - config.sleep_margin_ns);
+			}
+			// Else if there is more time remaining than the spin threshold, give up the processor.
+			else if (remaining_ns > config.spin_threshold_ns) {
+				sched_yield();
+			}
+			// Otherwise we spin until the deadline.
+			else {
+				spin_until_ns(deadline_ns);
+				return;
+			}
+			current_ns = now_ns();
+		}
+	}
+
+	/**
+	 * @brief	Function sleep_us_hybrid sleeps for the specified number of microseconds using the hybrid
+	 * 			sleep-then-spin strategy with the provided thresholds.
+	 * @param	us		uint32_t number of microseconds to sleep for.
+	 * @param	config	hybrid_sleep_config thresholds to use for the sleep, yield and spin phases.
+	 */
+	inline const void sleep_us_hybrid(const uint32_t us, const hybrid_sleep_config &config = hybrid_sleep_config{}) {
+		sleep_until_ns_hybrid(now_ns() + static_cast<uint64_t>(us) * 1'000, config);
+	}
+
+	/**
+	 * @brief	Function sleep_us sleeps for the specified number of microseconds.
+	 * @param	us	uint32_t number of microseconds to sleep for.
+	 * @details	The sleep is a kernel sleep, so it overshoots by the wakeup latency and timer slack of the
+	 * 			kernel but uses no processor time, use sleep_us_hybrid to trade processor time for accuracy.
+	 */
+	inline const void sleep_us(const uint32_t us) {
+		HIGH_RESOLUTION_SLEEP_RECORD(SleepUs, static_cast<uint64_t>(us) * 1'000);
+		sleep_until_ns(now_ns() + static_cast<uint64_t>(us) * 1'000);
+	}
 	#endif /* _WIN32 */
 
 	/**************************************************************************************************/
@@ -189,23 +577,24 @@ namespace high_resolution_sleep {
 	/* Non-Static Variables and Functions															  */
 	/**************************************************************************************************/
 	/// Flag for if the Windows static variables have been initialised.
-	static bool windows_timers_initialised = false;
+	inline bool windows_timers_initialised = false;
 	/// Result of the timeBeginPeriod call to set the minimum Windows timer object resolution.
-	static MMRESULT begin_period_result;
+	inline MMRESULT begin_period_result;
 	/// Number of cycles per second of the Windows performance counter.
-	static uint64_t cycles_per_s;
+	inline uint64_t cycles_per_s;
 	/// Number of cycles per millisecond of the Windows performance counter.
-	static uint64_t cycles_per_ms;
+	inline uint64_t cycles_per_ms;
 	/// Number of cycles per microsecond of the Windows performance counter.
-	static uint64_t cycles_per_us;
+	inline uint64_t cycles_per_us;
 	/// Number of cycles of the Windows performance counter that a Windows timer objects can reliably sleep for.
-	static uint64_t min_sleep_time_cycles;
+	inline uint64_t min_sleep_time_cycles;
 
 	/**
 	 * @brief	Function initialise_windows_timers initialises the static variables for using Windows
 	 * 			timer objects for sleeping.
 	 */
-	const void initialise_windows_timers() {
+	#ifdef HIGH_RESOLUTION_SLEEP_DEFINE_COLD
+	HIGH_RESOLUTION_SLEEP_COLD const void initialise_windows_timers() {
 		// Try to set the minimum Windows timer object resolution and store the result.
 		begin_period_result = timeBeginPeriod(1);
 
@@ -222,12 +611,15 @@ namespace high_resolution_sleep {
 		// Confirm that the timer variables have been initialised if there was no error in setting the timer resolution. 
 		windows_timers_initialised = (begin_period_result == TIMERR_NOERROR);
 	}
+	#else
+	const void initialise_windows_timers();
+	#endif /* HIGH_RESOLUTION_SLEEP_DEFINE_COLD */
 
 	/**
 	 * @brief	Function now_us gets the current system time in microseconds.
 	 * @return	uint64_t current system time in microseconds.
 	 */
-	const uint64_t now_us() {
+	inline const uint64_t now_us() {
 		// Initialise the Windows timer object variables if they haven't been already.
 		if (!windows_timers_initialised) initialise_windows_timers();
 
@@ -239,7 +631,7 @@ namespace high_resolution_sleep {
 	 * @brief	Function now_ns gets the current system time in nanoseconds.
 	 * @return	uint64_t current system time in nanoseconds.
 	 */
-	const uint64_t now_ns() {
+	inline const uint64_t now_ns() {
 		// Initialise the Windows timer object variables if they haven't been already.
 		if (!windows_timers_initialised) initialise_windows_timers();
 
@@ -251,13 +643,14 @@ namespace high_resolution_sleep {
 	 * @brief	Function sleep_ms sleeps for the specified number of milliseconds.
 	 * @param	ms	uint32_t number of milliseconds to sleep for.
 	 */
-	const void sleep_ms(const uint32_t ms) {
+	inline const void sleep_ms(const uint32_t ms) {
+		HIGH_RESOLUTION_SLEEP_RECORD(SleepMs, static_cast<uint64_t>(ms) * 1'000'000);
 		// Initialise the Windows timer object variables if they haven't been already.
 		if (!windows_timers_initialised) initialise_windows_timers();
 
 		// Convert the number of milliseconds to 100s of nanoseconds for SetWaitableTimer.
 		LARGE_INTEGER ft;
-		ft.QuadPart = -static_cast<int64_t>(ms * 10'000);
+		ft.QuadPart = -(static_cast<int64_t>(ms) * 10'000);
 
 		// Create a Windows timer object to wait on. 
 		HANDLE timer = CreateWaitableTimerA(NULL, TRUE, NULL);
@@ -276,7 +669,8 @@ namespace high_resolution_sleep {
 	 *	@param		error_us 	int64_t number of microseconds of error accumulated by sleeping.
 	 *	@details	This function is intended to be used in the included kind of error tracking pattern,
 	 *				where the schedule slip is tracked with each iteration, so when the slip gets too large
-	 *				a sleep is skipped and the schedule catches back up.
+	 *				a sleep is skipped and the schedule catches back up. The slip is only corrected in
+	 *				whole milliseconds, CorrectedSleep from corrected_sleep.hpp corrects it in nanoseconds.
 	 *	@code 		{.cpp}
 	 *				int64_t start_time_us, error_us = 0;
 	 *				uint32_t duration_ms = 1;
@@ -287,11 +681,12 @@ namespace high_resolution_sleep {
 	 *				}
 	 * 	@endcode
 	 */
-	const void sleep_ms_corrected(const uint32_t ms, const int64_t error_us) {
+	inline const void sleep_ms_corrected(const uint32_t ms, const int64_t error_us) {
 		// If the error is greater than or equal to the requested sleep duration, skip the sleep.
-		int32_t adjusted_sleep_ms = ms - (error_us / 1'000);
+		const int64_t adjusted_sleep_ms = static_cast<int64_t>(ms) - (error_us / 1'000);
+		HIGH_RESOLUTION_SLEEP_RECORD(SleepMsCorrected, adjusted_sleep_ms > 0 ? static_cast<uint64_t>(adjusted_sleep_ms) * 1'000'000 : 0);
 		if (adjusted_sleep_ms > 0) {
-			sleep_ms(adjusted_sleep_ms);
+			sleep_ms(adjusted_sleep_ms < UINT32_MAX ? static_cast<uint32_t>(adjusted_sleep_ms) : UINT32_MAX);
 		}
 		return;
 	}
@@ -300,7 +695,8 @@ namespace high_resolution_sleep {
 	 * @brief	Function sleep_us sleeps for the specified number of microseconds.
 	 * @param	us	uint32_t number of microseconds to sleep for.
 	 */
-	const void sleep_us(const uint32_t us) {
+	inline const void sleep_us(const uint32_t us) {
+		HIGH_RESOLUTION_SLEEP_RECORD(SleepUs, static_cast<uint64_t>(us) * 1'000);
 		// Initialise the Windows timer object variables if they haven't been already.
 		if (!windows_timers_initialised) initialise_windows_timers();
 
@@ -325,11 +721,551 @@ namespace high_resolution_sleep {
 				// Try to sleep for a portion of the remaining count. 
 				sleep_ms((uint32_t)((remaining_count * remaining_count_sleep_percent) / cycles_per_ms));
 			}
+			// Otherwise we are busy waiting, so let the processor save power between reads of the counter.
+			else {
+				cpu_relax();
+			}
 			// Decrement the number of counts left.
 			remaining_count = end_counter - GetPerfCounter();
 		}
 	}
+
+	/**
+	 * @brief	Function sleep_until_ns sleeps until the specified absolute time in nanoseconds.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+	 */
+	inline const void sleep_until_ns(const uint64_t deadline_ns) {
+		// The sleep_ms calls used to wait are not sleeps requested by the caller, so are not recorded.
+		HIGH_RESOLUTION_SLEEP_SUPPRESS_RECORDING();
+		// Initialise the Windows timer object variables if they haven't been already.
+		if (!windows_timers_initialised) initialise_windows_timers();
+
+		// While the deadline has not been reached, we should wait.
+		uint64_t current_ns = now_ns();
+		while (current_ns < deadline_ns) {
+			// If the remaining time is greater than the sleep threshold,
+			if (deadline_ns - current_ns > min_sleep_time_us * 1'000) {
+				// Try to sleep for a portion of the remaining time.
+				sleep_ms((uint32_t)(((deadline_ns - current_ns) * remaining_count_sleep_percent) / 1'000'000));
+			}
+			// Otherwise spin for the remainder.
+			else {
+				spin_until_ns(deadline_ns);
+				return;
+			}
+			current_ns = now_ns();
+		}
+	}
+
+	/**
+	 * @brief	Function sleep_until_us sleeps until the specified absolute time in microseconds.
+	 * @param	deadline_us	uint64_t time to wake up at, in the same time base as now_us.
+	 */
+	inline const void sleep_until_us(const uint64_t deadline_us) {
+		sleep_until_ns(deadline_us * 1'000);
+	}
 #endif // _WIN32
+
+	/**************************************************************************************************/
+	/* Clock Source Implementations	 																  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Namespace clock_source holds the tag types used to choose the clock read by now_ns_on and
+	 * 			waited on by sleep_until_ns_on.
+	 * @details	Every clock has its own time base, so deadlines must be taken from now_ns_on of the same
+	 * 			clock. A clock the platform does not provide falls back to the closest one it does.
+	 */
+	namespace clock_source {
+		#ifndef _WIN32
+		/**
+		 * @brief	Function posix_clock_ns reads a POSIX clock in nanoseconds.
+		 * @param	clock_id	clockid_t clock to read.
+		 * @return	uint64_t current time of the clock in nanoseconds.
+		 */
+		inline uint64_t posix_clock_ns(const clockid_t clock_id) {
+			struct timespec now;
+			clock_gettime(clock_id, &now);
+			return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+		}
+
+		/**
+		 * @brief	Function posix_clock_resolution_ns gets the resolution of a POSIX clock reported by clock_getres.
+		 * @param	clock_id	clockid_t clock to query.
+		 * @return	uint64_t resolution of the clock in nanoseconds, or zero if it is not reported.
+		 */
+		inline uint64_t posix_clock_resolution_ns(const clockid_t clock_id) {
+			struct timespec resolution;
+			if (clock_getres(clock_id, &resolution) != 0) return 0;
+			return static_cast<uint64_t>(resolution.tv_sec) * 1'000'000'000 + resolution.tv_nsec;
+		}
+
+		/**
+		 * @brief	Function posix_clock_sleep_until_ns sleeps until an absolute time of a POSIX clock using clock_nanosleep.
+		 * @param	deadline_ns	uint64_t time to wake up at, in the time base of ClockId.
+		 * @details	clock_nanosleep fails with EINVAL for clocks that are not backed by a timer, so those are
+		 * 			rejected at compile time rather than returning immediately, and must be waited on with
+		 * 			sleep_until_ns_relative instead.
+		 */
+		template <clockid_t ClockId>
+		void posix_clock_sleep_until_ns(const uint64_t deadline_ns) {
+			#ifdef CLOCK_MONOTONIC_RAW
+			static_assert(ClockId != CLOCK_MONOTONIC_RAW, "clock_nanosleep does not accept CLOCK_MONOTONIC_RAW");
+			#endif /* CLOCK_MONOTONIC_RAW */
+			#ifdef CLOCK_MONOTONIC_COARSE
+			static_assert(ClockId != CLOCK_MONOTONIC_COARSE, "clock_nanosleep does not accept CLOCK_MONOTONIC_COARSE");
+			#endif /* CLOCK_MONOTONIC_COARSE */
+			#ifdef CLOCK_REALTIME_COARSE
+			static_assert(ClockId != CLOCK_REALTIME_COARSE, "clock_nanosleep does not accept CLOCK_REALTIME_COARSE");
+			#endif /* CLOCK_REALTIME_COARSE */
+			static_assert(ClockId != CLOCK_THREAD_CPUTIME_ID, "clock_nanosleep does not accept CLOCK_THREAD_CPUTIME_ID");
+			struct timespec ts;
+			ts.tv_sec = deadline_ns / 1'000'000'000;
+			ts.tv_nsec = deadline_ns % 1'000'000'000;
+			while (clock_nanosleep(ClockId, TIMER_ABSTIME, &ts, NULL) == EINTR);
+		}
+		#endif /* _WIN32 */
+
+		/**
+		 * @brief	Function sleep_until_ns_relative sleeps until an absolute time of a clock the kernel cannot
+		 * 			wait on, by sleeping on now_ns for the time remaining on that clock.
+		 * @param	deadline_ns	uint64_t time to wake up at, in the time base of ClockSource.
+		 * @details	The remaining time is measured again after each sleep, so clocks that run slower than now_ns
+		 * 			or only advance at each scheduler tick never wake before the deadline.
+		 */
+		template <typename ClockSource>
+		void sleep_until_ns_relative(const uint64_t deadline_ns) {
+			uint64_t current_ns = ClockSource::now_ns();
+			while (current_ns < deadline_ns) {
+				high_resolution_sleep::sleep_until_ns(high_resolution_sleep::now_ns() + (deadline_ns - current_ns));
+				current_ns = ClockSource::now_ns();
+			}
+		}
+
+		/**
+		 * @brief	Struct monotonic is the clock of now_ns and sleep_until_ns, CLOCK_MONOTONIC on Linux.
+		 */
+		struct monotonic {
+			static uint64_t now_ns() {
+				return high_resolution_sleep::now_ns();
+			}
+
+			static void sleep_until_ns(const uint64_t deadline_ns) {
+				high_resolution_sleep::sleep_until_ns(deadline_ns);
+			}
+
+			static uint64_t resolution_ns() {
+				#ifdef _WIN32
+				if (!windows_timers_initialised) initialise_windows_timers();
+				return (1'000'000'000 + cycles_per_s - 1) / cycles_per_s;
+				#else
+				return posix_clock_resolution_ns(CLOCK_MONOTONIC);
+				#endif /* _WIN32 */
+			}
+		};
+
+		/**
+		 * @brief	Struct monotonic_coarse is a monotonic clock that only advances at each scheduler tick, so is
+		 * 			read without touching the hardware counter, for hot paths that need millisecond accuracy.
+		 * @details	Uses CLOCK_MONOTONIC_COARSE on Linux, CLOCK_MONOTONIC_RAW_APPROX on Apple platforms and
+		 * 			GetTickCount64 on Windows.
+		 */
+		struct monotonic_coarse {
+			static uint64_t now_ns() {
+				#if defined(_WIN32)
+				return GetTickCount64() * 1'000'000;
+				#elif defined(CLOCK_MONOTONIC_COARSE)
+				return posix_clock_ns(CLOCK_MONOTONIC_COARSE);
+				#elif defined(__APPLE__)
+				return posix_clock_ns(CLOCK_MONOTONIC_RAW_APPROX);
+				#else
+				return posix_clock_ns(CLOCK_MONOTONIC);
+				#endif /* _WIN32 */
+			}
+
+			static void sleep_until_ns(const uint64_t deadline_ns) {
+				sleep_until_ns_relative<monotonic_coarse>(deadline_ns);
+			}
+
+			static uint64_t resolution_ns() {
+				#if defined(_WIN32)
+				// The tick count advances once per clock interrupt, whose interval is given in units of 100 ns.
+				DWORD adjustment, increment;
+				BOOL adjustment_disabled;
+				if (!GetSystemTimeAdjustment(&adjustment, &increment, &adjustment_disabled)) return 0;
+				return static_cast<uint64_t>(increment) * 100;
+				#elif defined(CLOCK_MONOTONIC_COARSE)
+				return posix_clock_resolution_ns(CLOCK_MONOTONIC_COARSE);
+				#elif defined(__APPLE__)
+				return posix_clock_resolution_ns(CLOCK_MONOTONIC_RAW_APPROX);
+				#else
+				return posix_clock_resolution_ns(CLOCK_MONOTONIC);
+				#endif /* _WIN32 */
+			}
+		};
+
+		/**
+		 * @brief	Struct monotonic_raw is a monotonic clock that is not slewed by NTP, for measuring intervals
+		 * 			against the hardware counter.
+		 * @details	Uses CLOCK_MONOTONIC_RAW on Linux and Apple platforms, and the performance counter of now_ns
+		 * 			on Windows, which is never slewed.
+		 */
+		struct monotonic_raw {
+			static uint64_t now_ns() {
+				#if defined(_WIN32)
+				return high_resolution_sleep::now_ns();
+				#elif defined(CLOCK_MONOTONIC_RAW)
+				return posix_clock_ns(CLOCK_MONOTONIC_RAW);
+				#else
+				return posix_clock_ns(CLOCK_MONOTONIC);
+				#endif /* _WIN32 */
+			}
+
+			static void sleep_until_ns(const uint64_t deadline_ns) {
+				#ifdef _WIN32
+				high_resolution_sleep::sleep_until_ns(deadline_ns);
+				#else
+				// clock_nanosleep does not accept CLOCK_MONOTONIC_RAW.
+				sleep_until_ns_relative<monotonic_raw>(deadline_ns);
+				#endif /* _WIN32 */
+			}
+
+			static uint64_t resolution_ns() {
+				#if defined(_WIN32)
+				return monotonic::resolution_ns();
+				#elif defined(CLOCK_MONOTONIC_RAW)
+				return posix_clock_resolution_ns(CLOCK_MONOTONIC_RAW);
+				#else
+				return posix_clock_resolution_ns(CLOCK_MONOTONIC);
+				#endif /* _WIN32 */
+			}
+		};
+
+		/**
+		 * @brief	Struct boottime is a monotonic clock that keeps counting while the system is suspended.
+		 * @details	Uses CLOCK_BOOTTIME on Linux, CLOCK_MONOTONIC on Apple platforms, where it counts across
+		 * 			sleep, and the performance counter of now_ns on Windows.
+		 */
+		struct boottime {
+			static uint64_t now_ns() {
+				#if defined(__linux__)
+				return posix_clock_ns(CLOCK_BOOTTIME);
+				#elif defined(_WIN32)
+				return high_resolution_sleep::now_ns();
+				#else
+				return posix_clock_ns(CLOCK_MONOTONIC);
+				#endif /* __linux__ */
+			}
+
+			static void sleep_until_ns(const uint64_t deadline_ns) {
+				#if defined(__linux__)
+				// clock_nanosleep waits on CLOCK_BOOTTIME directly, so a suspend does not delay the wakeup.
+				posix_clock_sleep_until_ns<CLOCK_BOOTTIME>(deadline_ns);
+				#elif defined(_WIN32)
+				high_resolution_sleep::sleep_until_ns(deadline_ns);
+				#else
+				sleep_until_ns_relative<boottime>(deadline_ns);
+				#endif /* __linux__ */
+			}
+
+			static uint64_t resolution_ns() {
+				#if defined(__linux__)
+				return posix_clock_resolution_ns(CLOCK_BOOTTIME);
+				#elif defined(_WIN32)
+				return monotonic::resolution_ns();
+				#else
+				return posix_clock_resolution_ns(CLOCK_MONOTONIC);
+				#endif /* __linux__ */
+			}
+		};
+	}
+
+	/**
+	 * @brief	Function now_ns_on gets the current time of the chosen clock in nanoseconds.
+	 * @return	uint64_t current time in nanoseconds, in the time base of ClockSource.
+	 * @details	ClockSource must be one of the tag types of clock_source, or a type providing the same
+	 * 			static now_ns, sleep_until_ns and resolution_ns methods.
+	 * @code 		{.cpp}
+	 *				uint64_t start_ns = high_resolution_sleep::now_ns_on<high_resolution_sleep::clock_source::monotonic_raw>();
+	 * 	@endcode
+	 */
+	template <typename ClockSource>
+	uint64_t now_ns_on() {
+		return ClockSource::now_ns();
+	}
+
+	/**
+	 * @brief	Function now_us_on gets the current time of the chosen clock in microseconds.
+	 * @return	uint64_t current time in microseconds, in the time base of ClockSource.
+	 */
+	template <typename ClockSource>
+	uint64_t now_us_on() {
+		return ClockSource::now_ns() / 1'000;
+	}
+
+	/**
+	 * @brief	Function sleep_until_ns_on sleeps until the specified absolute time of the chosen clock.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns_on<ClockSource>.
+	 * @details	The kernel waits on clock_source::monotonic and clock_source::boottime directly, the other
+	 * 			clocks are waited on with relative sleeps that are repeated until the clock reaches the deadline.
+	 */
+	template <typename ClockSource>
+	void sleep_until_ns_on(const uint64_t deadline_ns) {
+		ClockSource::sleep_until_ns(deadline_ns);
+	}
+
+	/**
+	 * @brief	Function sleep_until_us_on sleeps until the specified absolute time of the chosen clock in microseconds.
+	 * @param	deadline_us	uint64_t time to wake up at, in the same time base as now_us_on<ClockSource>.
+	 */
+	template <typename ClockSource>
+	void sleep_until_us_on(const uint64_t deadline_us) {
+		ClockSource::sleep_until_ns(deadline_us * 1'000);
+	}
+
+	/**
+	 * @brief	Function spin_until_ns_on busy waits until the specified absolute time of the chosen clock.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns_on<ClockSource>.
+	 * @details	clock_source::monotonic spins with the default strategy of spin_until_ns, the other clocks
+	 * 			issue a pause between reads of the clock, since tpause deadlines are only known for now_ns.
+	 */
+	template <typename ClockSource>
+	void spin_until_ns_on(const uint64_t deadline_ns) {
+		if constexpr (std::is_same_v<ClockSource, clock_source::monotonic>) {
+			spin_until_ns(deadline_ns);
+		}
+		else {
+			while (ClockSource::now_ns() < deadline_ns) cpu_relax();
+		}
+	}
+
+	#ifndef _WIN32
+	/**
+	 * @brief	Function sleep_until_ns_hybrid_on sleeps until the specified absolute time of the chosen clock
+	 * 			using the hybrid sleep-then-spin strategy with the provided thresholds.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns_on<ClockSource>.
+	 * @param	config		hybrid_sleep_config thresholds to use for the sleep, yield and spin phases.
+	 * @details	The kernel sleep phase waits with sleep_until_ns_on, so clocks the kernel cannot wait on
+	 * 			sleep for the time remaining on the clock. clock_source::monotonic_coarse only advances at
+	 * 			each scheduler tick, so its spin phase can last up to a tick and the kernel policy suits it better.
+	 */
+	template <typename ClockSource>
+	void sleep_until_ns_hybrid_on(const uint64_t deadline_ns, const hybrid_sleep_config &config = hybrid_sleep_config{}) {
+		uint64_t current_ns = ClockSource::now_ns();
+		while (current_ns < deadline_ns) {
+			uint64_t remaining_ns = deadline_ns - current_ns;
+			// If there is more time remaining than the margin, sleep in the kernel until the margin.
+			if (remaining_ns > config.sleep_margin_ns) {
+				ClockSource::sleep_until_ns(deadline_ns - config.sleep_margin_ns);
+			}
+			// Else if there is more time remaining than the spin threshold, give up the processor.
+			else if (remaining_ns > config.spin_threshold_ns) {
+				sched_yield();
+			}
+			// Otherwise we spin until the deadline.
+			else {
+				spin_until_ns_on<ClockSource>(deadline_ns);
+				return;
+			}
+			current_ns = ClockSource::now_ns();
+		}
+	}
+
+	/**
+	 * @brief	Function sleep_us_hybrid_on sleeps for the specified number of microseconds of the chosen clock
+	 * 			using the hybrid sleep-then-spin strategy with the provided thresholds.
+	 * @param	us		uint32_t number of microseconds to sleep for.
+	 * @param	config	hybrid_sleep_config thresholds to use for the sleep, yield and spin phases.
+	 */
+	template <typename ClockSource>
+	void sleep_us_hybrid_on(const uint32_t us, const hybrid_sleep_config &config = hybrid_sleep_config{}) {
+		sleep_until_ns_hybrid_on<ClockSource>(ClockSource::now_ns() + static_cast<uint64_t>(us) * 1'000, config);
+	}
+	#endif /* _WIN32 */
+
+	/**
+	 * @brief	Function now_ms_coarse gets the current time of clock_source::monotonic_coarse in milliseconds,
+	 * 			at a fraction of the cost of now_ns for hot paths that only need millisecond accuracy.
+	 * @return	uint64_t current time in milliseconds, in the time base of clock_source::monotonic_coarse.
+	 */
+	inline const uint64_t now_ms_coarse() {
+		#ifdef _WIN32
+		return GetTickCount64();
+		#else
+		return clock_source::monotonic_coarse::now_ns() / 1'000'000;
+		#endif /* _WIN32 */
+	}
+
+	/**************************************************************************************************/
+	/* Cross-Platform Implementations 																  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Function time_point_to_ns_on converts a std::chrono time point to an absolute time of the chosen clock.
+	 * @param	time_point	std::chrono::time_point to convert.
+	 * @return	uint64_t time in the time base of now_ns_on<ClockSource>.
+	 * @details	Time points of std::chrono::steady_clock share the time base of clock_source::monotonic on
+	 * 			Linux and are passed through directly, other time points are converted relative to Clock::now.
+	 */
+	template <typename ClockSource, typename Clock, typename Duration>
+	uint64_t time_point_to_ns_on(const std::chrono::time_point<Clock, Duration> &time_point) {
+		#ifdef __linux__
+		if constexpr (std::is_same_v<Clock, std::chrono::steady_clock> && std::is_same_v<ClockSource, clock_source::monotonic>) {
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch()).count());
+		}
+		#endif /* __linux__ */
+		const int64_t remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time_point - Clock::now()).count();
+		return ClockSource::now_ns() + (remaining_ns > 0 ? remaining_ns : 0);
+	}
+
+	/**
+	 * @brief	Function time_point_to_ns converts a std::chrono time point to an absolute time in nanoseconds.
+	 * @param	time_point	std::chrono::time_point to convert.
+	 * @return	uint64_t time in the time base of now_ns.
+	 */
+	template <typename Clock, typename Duration>
+	uint64_t time_point_to_ns(const std::chrono::time_point<Clock, Duration> &time_point) {
+		return time_point_to_ns_on<clock_source::monotonic>(time_point);
+	}
+
+	/**
+	 * @brief	Function sleep_until_ns sleeps until the specified std::chrono time point.
+	 * @param	deadline	std::chrono::time_point to wake up at.
+	 */
+	template <typename Clock, typename Duration>
+	void sleep_until_ns(const std::chrono::time_point<Clock, Duration> &deadline) {
+		sleep_until_ns(time_point_to_ns(deadline));
+	}
+
+	/**
+	 * @brief	Namespace sleep_policy holds the tag types used to choose the strategy of sleep_for and sleep_until.
+	 */
+	namespace sleep_policy {
+		/// Chooses hybrid for periods below a millisecond and kernel otherwise, never spinning unless asked to.
+		struct automatic {};
+		/// Busy waits for the whole duration, for sleeps shorter than the cost of a system call.
+		struct spin {};
+		/// Sleeps in the kernel then busy waits, using sleep_until_ns_hybrid on UNIX and sleep_until_ns on Windows.
+		struct hybrid {};
+		/// Sleeps in the kernel only, trading wakeup accuracy for the lowest CPU use.
+		struct kernel {};
+	}
+
+	/**
+	 * @brief	Alias resolve_sleep_policy_t resolves the strategy used for a duration with the given period.
+	 * @details	Explicit policies are used as they are, sleep_policy::automatic is resolved from the period
+	 * 			of the duration, so the choice is made at compile time. The period says nothing about the
+	 * 			length of the duration, a std::chrono::nanoseconds can hold seconds, so automatic never
+	 * 			resolves to spin and busy waiting the whole duration is left to sleep_policy::spin.
+	 */
+	template <typename Policy, typename Period>
+	using resolve_sleep_policy_t = std::conditional_t<!std::is_same_v<Policy, sleep_policy::automatic>, Policy,
+		std::conditional_t<std::ratio_less_v<Period, std::milli>, sleep_policy::hybrid, sleep_policy::kernel>>;
+
+	/**
+	 * @brief	Function duration_to_ns converts a std::chrono duration to a number of nanoseconds.
+	 * @param	duration	std::chrono::duration to convert.
+	 * @return	uint64_t number of nanoseconds, zero for negative durations and saturated at INT64_MAX
+	 * 			for durations too long to be represented in nanoseconds.
+	 */
+	template <typename Rep, typename Period>
+	constexpr uint64_t duration_to_ns(const std::chrono::duration<Rep, Period> &duration) {
+		if (duration <= std::chrono::duration<Rep, Period>::zero()) return 0;
+		if (std::chrono::duration<double, std::nano>(duration).count() >= static_cast<double>(INT64_MAX)) return INT64_MAX;
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+	}
+
+	/**
+	 * @brief	Function sleep_until_ns_with sleeps until the specified absolute time in nanoseconds using
+	 * 			the strategy of the provided policy.
+	 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns_on<ClockSource>.
+	 * @details	Policy must be one of sleep_policy::spin, sleep_policy::hybrid or sleep_policy::kernel, and
+	 * 			ClockSource defaults to clock_source::monotonic, the clock of now_ns.
+	 */
+	template <typename Policy, typename ClockSource = clock_source::monotonic>
+	void sleep_until_ns_with(const uint64_t deadline_ns) {
+		if constexpr (std::is_same_v<Policy, sleep_policy::spin>) {
+			spin_until_ns_on<ClockSource>(deadline_ns);
+		}
+		else if constexpr (std::is_same_v<Policy, sleep_policy::hybrid>) {
+			#ifdef _WIN32
+			ClockSource::sleep_until_ns(deadline_ns);
+			#else
+			sleep_until_ns_hybrid_on<ClockSource>(deadline_ns, hybrid_sleep_config{});
+			#endif /* _WIN32 */
+		}
+		else {
+			static_assert(std::is_same_v<Policy, sleep_policy::kernel>, "sleep policy must be spin, hybrid, kernel or automatic");
+			#ifdef _WIN32
+			if constexpr (std::is_same_v<ClockSource, clock_source::monotonic>) {
+				// Round up to whole milliseconds so that the kernel sleep never wakes before the deadline.
+				const uint64_t current_ns = now_ns();
+				if (current_ns < deadline_ns) {
+					const uint64_t remaining_ms = (deadline_ns - current_ns + 999'999) / 1'000'000;
+					sleep_ms(remaining_ms < UINT32_MAX ? static_cast<uint32_t>(remaining_ms) : UINT32_MAX);
+				}
+			}
+			else {
+				ClockSource::sleep_until_ns(deadline_ns);
+			}
+			#else
+			ClockSource::sleep_until_ns(deadline_ns);
+			#endif /* _WIN32 */
+		}
+	}
+
+	/**
+	 * @brief	Function sleep_for_on sleeps for the specified std::chrono duration of the chosen clock.
+	 * @param	duration	std::chrono::duration to sleep for, negative durations return immediately.
+	 * @details	The strategy is chosen from Policy as for sleep_for, and both the deadline and every phase of
+	 * 			the strategy are measured on ClockSource.
+	 * @code 		{.cpp}
+	 *				using namespace std::chrono_literals;
+	 *				high_resolution_sleep::sleep_for_on<high_resolution_sleep::clock_source::boottime>(30s);
+	 * 	@endcode
+	 */
+	template <typename ClockSource, typename Policy = sleep_policy::automatic, typename Rep, typename Period>
+	void sleep_for_on(const std::chrono::duration<Rep, Period> &duration) {
+		sleep_until_ns_with<resolve_sleep_policy_t<Policy, Period>, ClockSource>(ClockSource::now_ns() + duration_to_ns(duration));
+	}
+
+	/**
+	 * @brief	Function sleep_until_on sleeps until the specified std::chrono time point, measured on the chosen clock.
+	 * @param	deadline	std::chrono::time_point to wake up at.
+	 * @details	The time point is converted with time_point_to_ns_on and the strategy is chosen as for sleep_until.
+	 */
+	template <typename ClockSource, typename Policy = sleep_policy::automatic, typename Clock, typename Duration>
+	void sleep_until_on(const std::chrono::time_point<Clock, Duration> &deadline) {
+		sleep_until_ns_with<resolve_sleep_policy_t<Policy, typename Duration::period>, ClockSource>(time_point_to_ns_on<ClockSource>(deadline));
+	}
+
+	/**
+	 * @brief	Function sleep_for sleeps for the specified std::chrono duration.
+	 * @param	duration	std::chrono::duration to sleep for, negative durations return immediately.
+	 * @details	The strategy is chosen at compile time from the Policy template parameter, which by
+	 * 			default picks from the period of the duration: nanosecond and microsecond durations use
+	 * 			the hybrid strategy and millisecond or longer durations sleep in the kernel. Spinning for
+	 * 			the whole duration must be asked for with sleep_policy::spin. Use sleep_for_on to measure
+	 * 			the duration on a clock other than clock_source::monotonic.
+	 * @code 		{.cpp}
+	 *				using namespace std::chrono_literals;
+	 *				high_resolution_sleep::sleep_for(250us);
+	 *				high_resolution_sleep::sleep_for<high_resolution_sleep::sleep_policy::spin>(2us);
+	 * 	@endcode
+	 */
+	template <typename Policy = sleep_policy::automatic, typename Rep, typename Period>
+	void sleep_for(const std::chrono::duration<Rep, Period> &duration) {
+		sleep_for_on<clock_source::monotonic, Policy>(duration);
+	}
+
+	/**
+	 * @brief	Function sleep_until sleeps until the specified std::chrono time point.
+	 * @param	deadline	std::chrono::time_point to wake up at.
+	 * @details	The strategy is chosen at compile time from the period of the time point as for sleep_for,
+	 * 			so clock time points, which carry nanosecond periods, use the hybrid strategy.
+	 */
+	template <typename Policy = sleep_policy::automatic, typename Clock, typename Duration>
+	void sleep_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+		sleep_until_on<clock_source::monotonic, Policy>(deadline);
+	}
 }
 
 #endif /* SLEEP_HPP */
\ No newline at end of file
@@ -0,0 +1,667 @@
+/**
+ * @file 	io_uring_engine.hpp
+ * @brief 	io_uring_engine.hpp defines a Linux timeout engine that submits many absolute deadlines in
+ * 			batches to a single io_uring.
+ * @details	The IoUringEngine class queues an IORING_OP_TIMEOUT request with an absolute CLOCK_MONOTONIC
+ * 			deadline for each timeout and submits the whole queue with one io_uring_enter, so a single
+ * 			thread can manage tens of thousands of deadlines per second for a handful of system calls
+ * 			rather than one blocked thread and one nanosleep each. Completions are delivered through a
+ * 			callback or a std::future on the thread that calls dispatch. Any io_uring operation can also
+ * 			be bounded by a deadline with a linked IORING_OP_LINK_TIMEOUT, and timeouts and bounded
+ * 			operations can be cancelled. The ring is set up with raw system calls so liburing is not
+ * 			needed. Where io_uring_is_supported finds that the kernel lacks io_uring or the timeout
+ * 			operations, or that io_uring has been disabled, the engine falls back to keeping the deadlines
+ * 			itself and sleeping until them with sleep_until_ns. Deadlines share the time base of now_ns.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef IO_URING_ENGINE_HPP
+#define IO_URING_ENGINE_HPP
+
+#ifdef __linux__
+
+// C++ Standard Library Headers
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Platform Dependant System Libraries
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/**************************************************************************************************/
+	/* io_uring Support 																			  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Function io_uring_setup_ring wraps the io_uring_setup system call.
+	 * @param	entries	uint32_t number of submission queue entries.
+	 * @param	params	io_uring_params to configure the ring with and to receive its layout.
+	 * @return	int file descriptor of the ring, or -1 with errno set.
+	 */
+	inline int io_uring_setup_ring(const uint32_t entries, io_uring_params &params) {
+		return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+	}
+
+	/**
+	 * @brief	Function io_uring_is_supported probes once whether io_uring can run the timeout engine.
+	 * @details	The probe sets up a small ring and asks the kernel which operations it supports, so it
+	 * 			fails cleanly on kernels without io_uring, kernels older than 5.6 without the probe, systems
+	 * 			with io_uring disabled by sysctl or seccomp, and kernels missing any of the timeout
+	 * 			operations.
+	 * @return	bool true if IORING_OP_TIMEOUT, IORING_OP_TIMEOUT_REMOVE, IORING_OP_LINK_TIMEOUT and
+	 * 			IORING_OP_ASYNC_CANCEL are supported.
+	 */
+	inline bool io_uring_is_supported() {
+		static const bool supported = []() {
+			io_uring_params params{};
+			const int ring_fd = io_uring_setup_ring(2, params);
+			if (ring_fd < 0) return false;
+			const size_t probe_size = sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op);
+			std::vector<uint64_t> probe_storage((probe_size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+			io_uring_probe *probe = reinterpret_cast<io_uring_probe *>(probe_storage.data());
+			bool result = syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == 0;
+			for (const uint8_t op : {IORING_OP_TIMEOUT, IORING_OP_TIMEOUT_REMOVE, IORING_OP_LINK_TIMEOUT, IORING_OP_ASYNC_CANCEL}) {
+				result = result && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+			}
+			close(ring_fd);
+			return result;
+		}();
+		return supported;
+	}
+
+	/**************************************************************************************************/
+	/* io_uring Timeout Engine 																		  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Enum TimeoutBackend is how an IoUringEngine waits for its deadlines.
+	 */
+	enum class TimeoutBackend {
+		/// io_uring where io_uring_is_supported, otherwise Blocking.
+		Automatic,
+		/// Batches of IORING_OP_TIMEOUT requests on an io_uring.
+		IoUring,
+		/// Deadlines kept by the engine and slept until with sleep_until_ns in dispatch.
+		Blocking
+	};
+
+	/**
+	 * @brief	Enum TimeoutStatus is how a timeout or bounded operation completed.
+	 */
+	enum class TimeoutStatus {
+		/// The deadline was reached, so a bounded operation was cancelled.
+		Expired,
+		/// The timeout or bounded operation was cancelled with cancel.
+		Cancelled,
+		/// A bounded operation completed before its deadline.
+		Completed
+	};
+
+	/**
+	 * @brief	Struct timeout_completion describes the completion of a timeout or bounded operation.
+	 */
+	struct timeout_completion {
+		/// How the timeout or operation completed.
+		TimeoutStatus status = TimeoutStatus::Expired;
+		/// Result of the completion queue entry, the result of the operation for Completed bounded operations.
+		int32_t result = 0;
+		/// Time the completion was reaped at, in the time base of now_ns.
+		uint64_t completed_ns = 0;
+	};
+
+	/**
+	 * @brief	Class IoUringEngine batches absolute timeouts onto one io_uring.
+	 * @details	Timeouts and bounded operations are queued by the schedule methods and handed to the kernel
+	 * 			in one system call by submit or dispatch, or as soon as the submission queue fills up.
+	 * 			Callbacks and futures are completed on the thread that calls dispatch, which should be
+	 * 			called whenever fd is readable or in a loop. Timeouts may be scheduled and cancelled from any
+	 * 			thread, but a deadline scheduled while another thread is blocked in dispatch only reaches the
+	 * 			kernel at the next submit or dispatch.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::IoUringEngine engine;
+	 * 			for (uint64_t deadline_ns : deadlines) {
+	 * 				engine.schedule_at_ns(deadline_ns, [](high_resolution_sleep::timeout_completion completion) { on_timeout(); });
+	 * 			}
+	 * 			// One system call submits every deadline, then each call waits for and runs completions.
+	 * 			while (engine.size() > 0) engine.dispatch(1);
+	 * @endcode
+	 */
+	class IoUringEngine {
+	public:
+		/// Callback type for a timeout or bounded operation, given how it completed.
+		using completion_callback = std::function<void(timeout_completion completion)>;
+		/// Function type that prepares the operation bounded by a linked timeout in a submission queue entry.
+		using operation_preparer = std::function<void(io_uring_sqe &sqe)>;
+
+		/**
+		 * @brief	Struct timeout_handle identifies a scheduled timeout so it can be cancelled.
+		 */
+		struct timeout_handle {
+			/// Unique identifier of the timeout.
+			uint64_t id = UINT64_MAX;
+		};
+
+		/**
+		 * @brief	Constructor for IoUringEngine that sets up the ring, unless it falls back to blocking.
+		 * @param	entries	uint32_t number of submission queue entries, the most timeouts submitted per system call.
+		 * @param	backend	TimeoutBackend to use, Automatic falls back to Blocking without io_uring support.
+		 * @throws	std::system_error if the io_uring cannot be set up, or IoUring is asked for but not supported.
+		 */
+		explicit IoUringEngine(const uint32_t entries = 4'096, const TimeoutBackend backend = TimeoutBackend::Automatic) {
+			if (backend == TimeoutBackend::Blocking || (backend == TimeoutBackend::Automatic && !io_uring_is_supported())) {
+				selected_backend = TimeoutBackend::Blocking;
+				return;
+			}
+			if (!io_uring_is_supported()) {
+				throw std::system_error(std::make_error_code(std::errc::function_not_supported), "IoUringEngine::IoUringEngine: io_uring timeouts are not supported");
+			}
+			selected_backend = TimeoutBackend::IoUring;
+			setup_ring(entries);
+		}
+
+		IoUringEngine(const IoUringEngine &) = delete;
+		IoUringEngine &operator=(const IoUringEngine &) = delete;
+
+		/**
+		 * @brief	Destructor for IoUringEngine that tears down the ring, dropping outstanding timeouts.
+		 */
+		~IoUringEngine() {
+			if (ring_fd < 0) return;
+			munmap(sqes, sqes_size);
+			if (cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+			munmap(sq_ring, sq_ring_size);
+			close(ring_fd);
+		}
+
+		/**
+		 * @brief	Method backend gets how the engine waits for its deadlines.
+		 * @return	TimeoutBackend IoUring or Blocking.
+		 */
+		TimeoutBackend backend() const {
+			return selected_backend;
+		}
+
+		/**
+		 * @brief	Method fd gets the ring to register for readability in an event loop.
+		 * @return	int file descriptor of the ring, which is readable while completions are waiting, or -1
+		 * 			for the Blocking backend.
+		 */
+		int fd() const {
+			return ring_fd;
+		}
+
+		/**
+		 * @brief	Method schedule_at_ns schedules a timeout at an absolute time.
+		 * @param	deadline_ns	uint64_t time in the time base of now_ns at which to complete.
+		 * @param	callback	completion_callback to call when the timeout completes.
+		 * @return	timeout_handle handle that can be used to cancel the timeout.
+		 */
+		timeout_handle schedule_at_ns(const uint64_t deadline_ns, completion_callback callback) {
+			std::lock_guard<std::mutex> lock(mutex);
+			const uint64_t id = next_id++;
+			pending_timeout &timeout = pending.emplace(id, pending_timeout{deadline_ns, false, false, {}, std::move(callback)}).first->second;
+			if (selected_backend == TimeoutBackend::Blocking) {
+				blocking_deadlines.emplace(std::make_pair(deadline_ns, id));
+				return timeout_handle{id};
+			}
+			set_timespec(timeout.deadline, deadline_ns);
+			io_uring_sqe &sqe = next_sqe(1);
+			sqe.opcode = IORING_OP_TIMEOUT;
+			sqe.fd = -1;
+			sqe.addr = reinterpret_cast<uint64_t>(&timeout.deadline);
+			sqe.len = 1;
+			sqe.off = 0;
+			sqe.timeout_flags = IORING_TIMEOUT_ABS;
+			sqe.user_data = id;
+			queue_sqe();
+			return timeout_handle{id};
+		}
+
+		/**
+		 * @brief	Method schedule_after_ns schedules a timeout after a delay from now.
+		 * @param	delay_ns	uint64_t number of nanoseconds from now at which to complete.
+		 * @param	callback	completion_callback to call when the timeout completes.
+		 * @return	timeout_handle handle that can be used to cancel the timeout.
+		 */
+		timeout_handle schedule_after_ns(const uint64_t delay_ns, completion_callback callback) {
+			return schedule_at_ns(now_ns() + delay_ns, std::move(callback));
+		}
+
+		/**
+		 * @brief	Method sleep_until_ns schedules a timeout at an absolute time that completes a future.
+		 * @param	deadline_ns	uint64_t time in the time base of now_ns at which to complete.
+		 * @return	std::future<timeout_completion> future that is ready once dispatch reaps the timeout.
+		 */
+		std::future<timeout_completion> sleep_until_ns(const uint64_t deadline_ns) {
+			auto promise = std::make_shared<std::promise<timeout_completion>>();
+			std::future<timeout_completion> future = promise->get_future();
+			schedule_at_ns(deadline_ns, [promise](timeout_completion completion) { promise->set_value(completion); });
+			return future;
+		}
+
+		/**
+		 * @brief	Method schedule_with_timeout_ns submits an io_uring operation bounded by a linked timeout at
+		 * 			an absolute time.
+		 * @param	prepare		operation_preparer that fills in the operation, the engine sets its user_data
+		 * 						and links it to the timeout.
+		 * @param	deadline_ns	uint64_t time in the time base of now_ns at which to cancel the operation.
+		 * @param	callback	completion_callback to call with the result of the operation, or Expired.
+		 * @return	timeout_handle handle that can be used to cancel the operation.
+		 * @throws	std::logic_error for the Blocking backend, which cannot run io_uring operations.
+		 */
+		timeout_handle schedule_with_timeout_ns(const operation_preparer &prepare, const uint64_t deadline_ns, completion_callback callback) {
+			if (selected_backend == TimeoutBackend::Blocking) {
+				throw std::logic_error("IoUringEngine::schedule_with_timeout_ns: linked timeouts need the io_uring backend.");
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			const uint64_t id = next_id++;
+			pending_timeout &timeout = pending.emplace(id, pending_timeout{deadline_ns, true, false, {}, std::move(callback)}).first->second;
+			set_timespec(timeout.deadline, deadline_ns);
+			// The operation and its timeout must be submitted together, so make room for both first.
+			io_uring_sqe &operation = next_sqe(2);
+			prepare(operation);
+			operation.flags |= IOSQE_IO_LINK;
+			operation.user_data = id;
+			queue_sqe();
+			io_uring_sqe &link = next_sqe(1);
+			link.opcode = IORING_OP_LINK_TIMEOUT;
+			link.fd = -1;
+			link.addr = reinterpret_cast<uint64_t>(&timeout.deadline);
+			link.len = 1;
+			link.timeout_flags = IORING_TIMEOUT_ABS;
+			link.user_data = internal_user_data;
+			queue_sqe();
+			return timeout_handle{id};
+		}
+
+		/**
+		 * @brief	Method cancel cancels a scheduled timeout or bounded operation, which then completes with
+		 * 			the Cancelled status unless the kernel completed it before the cancellation reached it.
+		 * @param	handle	timeout_handle returned when the timeout was scheduled.
+		 * @return	bool true if the cancellation was queued, false if the timeout had already been reaped or
+		 * 			been cancelled.
+		 */
+		bool cancel(const timeout_handle handle) {
+			std::lock_guard<std::mutex> lock(mutex);
+			auto iterator = pending.find(handle.id);
+			if (iterator == pending.end() || iterator->second.cancelled) return false;
+			iterator->second.cancelled = true;
+			if (selected_backend == TimeoutBackend::Blocking) {
+				blocking_deadlines.erase(std::make_pair(iterator->second.deadline_ns, handle.id));
+				blocking_cancelled.push_back(handle.id);
+				return true;
+			}
+			io_uring_sqe &sqe = next_sqe(1);
+			sqe.opcode = iterator->second.linked ? IORING_OP_ASYNC_CANCEL : IORING_OP_TIMEOUT_REMOVE;
+			sqe.fd = -1;
+			sqe.addr = handle.id;
+			sqe.user_data = internal_user_data;
+			queue_sqe();
+			return true;
+		}
+
+		/**
+		 * @brief	Method submit hands every queued request to the kernel in one system call.
+		 * @return	size_t number of requests submitted.
+		 * @throws	std::system_error if io_uring_enter fails.
+		 */
+		size_t submit() {
+			if (selected_backend == TimeoutBackend::Blocking) return 0;
+			std::lock_guard<std::mutex> lock(mutex);
+			return submit_queued();
+		}
+
+		/**
+		 * @brief	Method dispatch submits the queued requests, waits for completions and runs the callback of
+		 * 			every timeout and bounded operation that has completed.
+		 * @param	min_complete	uint32_t number of completions to wait for, zero only runs those already
+		 * 							complete. The wait ends early if nothing is outstanding, may be ended by
+		 * 							internal completions such as those of cancellations, and is always ended
+		 * 							by the kernel when a timeout expires, so the batching saves the system
+		 * 							calls that arm the timeouts rather than those that wait for them.
+		 * @return	size_t number of callbacks run.
+		 * @throws	std::system_error if io_uring_enter fails.
+		 */
+		size_t dispatch(const uint32_t min_complete = 0) {
+			if (selected_backend == TimeoutBackend::Blocking) return dispatch_blocking(min_complete);
+			uint32_t to_submit = 0, wait_for = 0;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				// Every outstanding request completes at least once, so never wait for more than are outstanding.
+				wait_for = static_cast<uint32_t>(pending.size() < min_complete ? pending.size() : min_complete);
+				if (completions_ready() >= wait_for) wait_for = 0;
+				// Submit the queued entries and wait for them in one system call.
+				to_submit = unsubmitted();
+			}
+			// Enter outside the lock so that other threads can keep scheduling and cancelling while it waits.
+			// Entries stay unsubmitted until the kernel moves the head past them, so a thread that finds the
+			// queue full meanwhile submits them itself rather than overwriting them, and any the kernel does
+			// not take here are submitted by the next submit or dispatch.
+			if (to_submit > 0 || wait_for > 0) {
+				enter(to_submit, wait_for, wait_for > 0 ? IORING_ENTER_GETEVENTS : 0);
+			}
+
+			std::vector<std::pair<completion_callback, timeout_completion>> completed;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				reap(completed);
+			}
+			for (auto &[callback, completion] : completed) callback(completion);
+			return completed.size();
+		}
+
+		/**
+		 * @brief	Method size gets the number of timeouts and bounded operations that have not completed.
+		 * @return	size_t number of outstanding timeouts and bounded operations.
+		 */
+		size_t size() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return pending.size();
+		}
+
+		/**
+		 * @brief	Method system_calls gets the number of io_uring_enter calls made, to size the batching.
+		 * @return	uint64_t number of io_uring_enter system calls, or of sleeps for the Blocking backend.
+		 */
+		uint64_t system_calls() const {
+			return enter_calls.load(std::memory_order_relaxed);
+		}
+
+	private:
+		/**
+		 * @brief	Struct pending_timeout holds an outstanding timeout or bounded operation.
+		 */
+		struct pending_timeout {
+			/// Deadline in the time base of now_ns.
+			uint64_t deadline_ns;
+			/// Whether the timeout bounds a linked operation.
+			bool linked;
+			/// Whether cancel has been called.
+			bool cancelled;
+			/// Absolute deadline read by the kernel when the request is submitted.
+			__kernel_timespec deadline;
+			/// Callback to call on completion.
+			completion_callback callback;
+		};
+
+		/// User data of requests whose completions are consumed by the engine, such as cancellations.
+		const static uint64_t internal_user_data = UINT64_MAX;
+
+		/**
+		 * @brief	Method setup_ring sets up the io_uring and maps its queues.
+		 * @param	entries	uint32_t number of submission queue entries.
+		 * @throws	std::system_error if the ring cannot be set up or mapped.
+		 */
+		void setup_ring(const uint32_t entries) {
+			io_uring_params params{};
+			// Outstanding timeouts do not hold completion queue entries, but a burst of expirations does.
+			params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+			params.cq_entries = entries * 4;
+			ring_fd = io_uring_setup_ring(entries, params);
+			if (ring_fd < 0) {
+				throw std::system_error(errno, std::generic_category(), "IoUringEngine::setup_ring: io_uring_setup failed");
+			}
+			sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+			cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			if (params.features & IORING_FEAT_SINGLE_MMAP) {
+				sq_ring_size = cq_ring_size = sq_ring_size > cq_ring_size ? sq_ring_size : cq_ring_size;
+			}
+			sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+			cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP) || sq_ring == MAP_FAILED ? sq_ring
+				: mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+			sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+			void *sqes_map = sq_ring == MAP_FAILED || cq_ring == MAP_FAILED ? MAP_FAILED
+				: mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+			if (sqes_map == MAP_FAILED) {
+				const int error = errno;
+				if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+				if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_size);
+				close(ring_fd);
+				ring_fd = -1;
+				throw std::system_error(error, std::generic_category(), "IoUringEngine::setup_ring: mmap failed");
+			}
+			sqes = static_cast<io_uring_sqe *>(sqes_map);
+			char *sq = static_cast<char *>(sq_ring), *cq = static_cast<char *>(cq_ring);
+			sq_head = reinterpret_cast<uint32_t *>(sq + params.sq_off.head);
+			sq_tail = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+			sq_mask = *reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+			sq_entries = params.sq_entries;
+			cq_head = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+			cq_tail = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+			cq_mask = *reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+			cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+			// Submission queue entries are used in ring order, so the indirection array is the identity.
+			uint32_t *sq_array = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+			for (uint32_t i = 0; i < sq_entries; i++) sq_array[i] = i;
+			sqe_tail = *sq_tail;
+		}
+
+		/**
+		 * @brief	Method set_timespec converts a deadline into the kernel's timespec.
+		 * @param	timespec	__kernel_timespec to set.
+		 * @param	deadline_ns	uint64_t deadline in the time base of now_ns, which is CLOCK_MONOTONIC.
+		 */
+		static void set_timespec(__kernel_timespec &timespec, const uint64_t deadline_ns) {
+			timespec.tv_sec = static_cast<int64_t>(deadline_ns / 1'000'000'000);
+			timespec.tv_nsec = static_cast<int64_t>(deadline_ns % 1'000'000'000);
+		}
+
+		/**
+		 * @brief	Method next_sqe gets the next submission queue entry, submitting the queue first if fewer
+		 * 			than the given number of entries are free. Must be called with the mutex held.
+		 * @param	needed	uint32_t number of entries about to be queued together.
+		 * @return	io_uring_sqe& cleared entry.
+		 */
+		io_uring_sqe &next_sqe(const uint32_t needed) {
+			if (unsubmitted() + needed > sq_entries) submit_queued();
+			io_uring_sqe &sqe = sqes[sqe_tail & sq_mask];
+			sqe = io_uring_sqe{};
+			return sqe;
+		}
+
+		/**
+		 * @brief	Method queue_sqe publishes the entry returned by next_sqe to the kernel. Must be called with
+		 * 			the mutex held.
+		 */
+		void queue_sqe() {
+			sqe_tail++;
+			__atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+		}
+
+		/**
+		 * @brief	Method unsubmitted gets the number of published entries the kernel has not yet consumed.
+		 * 			Must be called with the mutex held.
+		 * @return	uint32_t number of entries between the kernel's head and the published tail.
+		 */
+		uint32_t unsubmitted() const {
+			return sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+		}
+
+		/**
+		 * @brief	Method submit_queued submits every queued entry, including those a dispatch on another
+		 * 			thread is submitting outside the mutex. Must be called with the mutex held.
+		 * @return	size_t number of entries submitted by this call.
+		 * @throws	std::system_error if io_uring_enter fails.
+		 */
+		size_t submit_queued() {
+			size_t submitted = 0;
+			for (uint32_t remaining = unsubmitted(); remaining > 0; remaining = unsubmitted()) {
+				const int result = enter(remaining, 0, 0);
+				if (result > 0) {
+					submitted += static_cast<size_t>(result);
+				}
+				// The kernel holds back submissions while completions have overflowed, so reap them first.
+				else if (result < 0 && reap_queue(deferred_completions) == 0) {
+					enter(0, 1, IORING_ENTER_GETEVENTS);
+				}
+			}
+			return submitted;
+		}
+
+		/**
+		 * @brief	Method enter wraps the io_uring_enter system call, retrying interrupted calls.
+		 * @param	to_submit		uint32_t number of queued entries to submit.
+		 * @param	min_complete	uint32_t number of completions to wait for.
+		 * @param	flags			uint32_t io_uring_enter flags.
+		 * @return	int number of entries submitted, or -1 if the completion queue must be reaped first.
+		 * @throws	std::system_error if io_uring_enter fails for another reason.
+		 */
+		int enter(const uint32_t to_submit, const uint32_t min_complete, const uint32_t flags) {
+			while (true) {
+				enter_calls.fetch_add(1, std::memory_order_relaxed);
+				const long result = syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0);
+				if (result >= 0) return static_cast<int>(result);
+				if (errno == EINTR) continue;
+				if (errno == EBUSY || errno == EAGAIN) return -1;
+				throw std::system_error(errno, std::generic_category(), "IoUringEngine::enter: io_uring_enter failed");
+			}
+		}
+
+		/**
+		 * @brief	Method completions_ready gets the number of completion queue entries waiting to be reaped.
+		 * @return	uint32_t number of entries in the completion queue.
+		 */
+		uint32_t completions_ready() const {
+			return __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE) - *cq_head + static_cast<uint32_t>(deferred_completions.size());
+		}
+
+		/**
+		 * @brief	Method reap collects the callbacks to run for the deferred completions and the completion
+		 * 			queue. Must be called with the mutex held.
+		 * @param	completed	std::vector to append the callbacks and their completions to.
+		 */
+		void reap(std::vector<std::pair<completion_callback, timeout_completion>> &completed) {
+			for (auto &deferred : deferred_completions) completed.push_back(std::move(deferred));
+			deferred_completions.clear();
+			reap_queue(completed);
+		}
+
+		/**
+		 * @brief	Method reap_queue consumes the completion queue, collecting the callbacks to run. Must be
+		 * 			called with the mutex held.
+		 * @param	completed	std::vector to append the callbacks and their completions to.
+		 * @return	size_t number of completion queue entries consumed.
+		 */
+		size_t reap_queue(std::vector<std::pair<completion_callback, timeout_completion>> &completed) {
+			const uint64_t current_ns = now_ns();
+			uint32_t head = *cq_head;
+			const uint32_t tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+			for (; head != tail; head++) {
+				const io_uring_cqe &cqe = cqes[head & cq_mask];
+				if (cqe.user_data == internal_user_data) continue;
+				auto iterator = pending.find(cqe.user_data);
+				if (iterator == pending.end()) continue;
+				// The result decides the status, since a cancel that lost the race with the deadline or the
+				// operation finds nothing to cancel and the request completes as it would have without it.
+				timeout_completion completion{iterator->second.linked ? TimeoutStatus::Completed : TimeoutStatus::Expired, cqe.res, current_ns};
+				if (cqe.res == -ECANCELED) {
+					// A linked operation is also cancelled by the kernel when its timeout fires.
+					completion.status = iterator->second.cancelled || !iterator->second.linked ? TimeoutStatus::Cancelled : TimeoutStatus::Expired;
+				}
+				completed.emplace_back(std::move(iterator->second.callback), completion);
+				pending.erase(iterator);
+			}
+			const size_t consumed = head - *cq_head;
+			__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+			return consumed;
+		}
+
+		/**
+		 * @brief	Method dispatch_blocking runs the due and cancelled timeouts of the Blocking backend, sleeping
+		 * 			until the earliest deadline while fewer than the given number have completed.
+		 * @param	min_complete	uint32_t number of completions to wait for.
+		 * @return	size_t number of callbacks run.
+		 */
+		size_t dispatch_blocking(const uint32_t min_complete) {
+			size_t run = 0;
+			while (true) {
+				std::vector<std::pair<completion_callback, timeout_completion>> completed;
+				uint64_t earliest_ns = UINT64_MAX;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					const uint64_t current_ns = now_ns();
+					for (const uint64_t id : blocking_cancelled) {
+						auto iterator = pending.find(id);
+						completed.emplace_back(std::move(iterator->second.callback), timeout_completion{TimeoutStatus::Cancelled, -ECANCELED, current_ns});
+						pending.erase(iterator);
+					}
+					blocking_cancelled.clear();
+					while (!blocking_deadlines.empty() && blocking_deadlines.begin()->first <= current_ns) {
+						auto iterator = pending.find(blocking_deadlines.begin()->second);
+						completed.emplace_back(std::move(iterator->second.callback), timeout_completion{TimeoutStatus::Expired, -ETIME, current_ns});
+						pending.erase(iterator);
+						blocking_deadlines.erase(blocking_deadlines.begin());
+					}
+					if (!blocking_deadlines.empty()) earliest_ns = blocking_deadlines.begin()->first;
+				}
+				for (auto &[callback, completion] : completed) callback(completion);
+				run += completed.size();
+				if (run >= min_complete || earliest_ns == UINT64_MAX) return run;
+				enter_calls.fetch_add(1, std::memory_order_relaxed);
+				high_resolution_sleep::sleep_until_ns(earliest_ns);
+			}
+		}
+
+		/// How the engine waits for its deadlines.
+		TimeoutBackend selected_backend = TimeoutBackend::Blocking;
+		/// File descriptor of the ring, or -1 for the Blocking backend.
+		int ring_fd = -1;
+		/// Mapped submission queue ring, and its size.
+		void *sq_ring = nullptr;
+		size_t sq_ring_size = 0;
+		/// Mapped completion queue ring, which is the submission queue ring with IORING_FEAT_SINGLE_MMAP, and its size.
+		void *cq_ring = nullptr;
+		size_t cq_ring_size = 0;
+		/// Mapped submission queue entries, and their size.
+		io_uring_sqe *sqes = nullptr;
+		size_t sqes_size = 0;
+		/// Submission queue head, consumed by the kernel, and tail, published by the engine.
+		uint32_t *sq_head = nullptr, *sq_tail = nullptr;
+		/// Mask and number of submission queue entries.
+		uint32_t sq_mask = 0, sq_entries = 0;
+		/// Completion queue head, consumed by the engine, and tail, published by the kernel.
+		uint32_t *cq_head = nullptr, *cq_tail = nullptr;
+		/// Mask of the completion queue.
+		uint32_t cq_mask = 0;
+		/// Completion queue entries.
+		io_uring_cqe *cqes = nullptr;
+		/// Tail of the submission queue including entries being prepared.
+		uint32_t sqe_tail = 0;
+		/// Number of io_uring_enter system calls made.
+		std::atomic<uint64_t> enter_calls{0};
+		/// Identifier to give the next timeout.
+		uint64_t next_id = 0;
+		/// Outstanding timeouts and bounded operations by identifier.
+		std::unordered_map<uint64_t, pending_timeout> pending;
+		/// Completions reaped while making room to submit, run by the next dispatch.
+		std::vector<std::pair<completion_callback, timeout_completion>> deferred_completions;
+		/// Deadlines of the Blocking backend ordered by time, then by identifier.
+		std::set<std::pair<uint64_t, uint64_t>> blocking_deadlines;
+		/// Cancelled timeouts of the Blocking backend waiting to be completed by dispatch.
+		std::vector<uint64_t> blocking_cancelled;
+		/// Mutex protecting the queues and the outstanding timeouts.
+		mutable std::mutex mutex;
+	};
+}
+
+#endif /* __linux__ */
+
+#endif /* IO_URING_ENGINE_HPP */
@@ -0,0 +1,254 @@
+/**
+ * @file 	periodic_executive.hpp
+ * @brief 	periodic_executive.hpp defines a single threaded cyclic scheduler for running multiple
+ * 			periodic tasks at different rates.
+ * @details	The PeriodicExecutive class runs a set of registered callbacks, each with its own period
+ * 			and phase, from the thread that calls run. Release times are tracked as absolute deadlines
+ * 			in the time base of now_ns, so the schedule does not drift regardless of how long the tasks
+ * 			or the sleeps take. When the executive falls behind, each task's OverrunPolicy decides
+ * 			whether the missed releases are skipped, run back to back, or coalesced into one call.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef PERIODIC_EXECUTIVE_HPP
+#define PERIODIC_EXECUTIVE_HPP
+
+// C++ Standard Library Headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "sleeper.hpp"
+
+
+namespace high_resolution_sleep {
+	/**
+	 * @brief	Enum OverrunPolicy selects what a task does when one or more of its releases were missed.
+	 */
+	enum class OverrunPolicy {
+		/// Missed releases are dropped and the task resumes at its next release that is still in the future.
+		Skip,
+		/// Every missed release is run back to back until the task has caught up with its schedule.
+		CatchUp,
+		/// All missed releases are run as a single call that is told how many releases it covers.
+		Coalesce
+	};
+
+	/**
+	 * @brief	Struct periodic_task_statistics holds counters describing how a periodic task has run.
+	 */
+	struct periodic_task_statistics {
+		/// Number of times the task callback has been called.
+		uint64_t runs = 0;
+		/// Number of releases that were skipped, coalesced, or run at least one period late.
+		uint64_t overruns = 0;
+		/// Largest delay between a release time and the start of its callback in nanoseconds.
+		uint64_t max_release_delay_ns = 0;
+	};
+
+	/**
+	 * @brief	Class PeriodicExecutive runs several periodic callbacks with independent rates on one thread.
+	 * @details	Tasks are registered with add_task before the executive is run. The executive then sleeps
+	 * 			precisely until the earliest release of all the tasks, runs every task that is due, and
+	 * 			repeats. Tasks that are due at the same instant run in order of increasing period, so
+	 * 			higher rate tasks go first.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::PeriodicExecutive executive;
+	 * 			executive.add_task(1'000'000, [](uint64_t release_ns, uint64_t releases) { control(); });
+	 * 			executive.add_task(4'000'000, [](uint64_t release_ns, uint64_t releases) { estimate(); });
+	 * 			executive.add_task(100'000'000, [](uint64_t release_ns, uint64_t releases) { report(); }, 500'000);
+	 * 			executive.run();
+	 * @endcode
+	 */
+	class PeriodicExecutive {
+	public:
+		/// Callback type for a periodic task, given the scheduled release time in ns and the number of releases it covers.
+		using task_callback = std::function<void(uint64_t release_ns, uint64_t releases)>;
+
+		PeriodicExecutive() = default;
+		PeriodicExecutive(const PeriodicExecutive &) = delete;
+		PeriodicExecutive &operator=(const PeriodicExecutive &) = delete;
+
+		/**
+		 * @brief	Constructor for PeriodicExecutive that sets the thresholds used to sleep between releases.
+		 * @param	config	hybrid_sleep_config thresholds of the Sleeper that waits for each release.
+		 */
+		explicit PeriodicExecutive(const hybrid_sleep_config &config) : sleeper(config) {}
+
+		/**
+		 * @brief	Method add_task registers a periodic task with the executive.
+		 * @param	period_ns	uint64_t number of nanoseconds between releases of the task.
+		 * @param	callback	task_callback to call at each release.
+		 * @param	phase_ns	uint64_t offset in nanoseconds of the first release from the start of run.
+		 * @param	policy		OverrunPolicy applied when releases of the task are missed.
+		 * @return	size_t index of the task, used to query its statistics.
+		 * @throws	std::invalid_argument if the period is zero.
+		 * @throws	std::logic_error if the executive is currently running.
+		 */
+		size_t add_task(const uint64_t period_ns, task_callback callback, const uint64_t phase_ns = 0, const OverrunPolicy policy = OverrunPolicy::Skip) {
+			if (period_ns == 0) {
+				throw std::invalid_argument("PeriodicExecutive::add_task: period_ns must be greater than zero.");
+			}
+			if (running.load()) {
+				throw std::logic_error("PeriodicExecutive::add_task: tasks cannot be added while the executive is running.");
+			}
+			tasks.push_back(periodic_task{period_ns, phase_ns, policy, std::move(callback), 0, {}});
+			return tasks.size() - 1;
+		}
+
+		/**
+		 * @brief	Method run runs the registered tasks on the calling thread until stop is called.
+		 */
+		void run() {
+			run_until_ns(UINT64_MAX);
+		}
+
+		/**
+		 * @brief	Method run_until_ns runs the registered tasks on the calling thread until stop is called
+		 * 			or the specified absolute time is reached.
+		 * @param	end_ns	uint64_t time in the time base of now_ns at which to return.
+		 */
+		void run_until_ns(const uint64_t end_ns) {
+			if (tasks.empty()) return;
+			running.store(true);
+
+			// Release all tasks relative to a common start time so their phases stay aligned.
+			const uint64_t start_ns = now_ns();
+			for (periodic_task &task : tasks) {
+				task.next_release_ns = start_ns + task.phase_ns;
+			}
+
+			while (!stop_requested.load(std::memory_order_relaxed)) {
+				// Find the earliest release of all the tasks, breaking ties in favour of the shortest period.
+				periodic_task *next = &tasks.front();
+				for (periodic_task &task : tasks) {
+					if (task.next_release_ns < next->next_release_ns ||
+						(task.next_release_ns == next->next_release_ns && task.period_ns < next->period_ns)) {
+						next = &task;
+					}
+				}
+				if (next->next_release_ns >= end_ns) break;
+
+				// Sleep until the release if it is still in the future. A wake from stop ends the sleep early,
+				// and a wake left over from an earlier stop just restarts the sleep.
+				if (sleeper.sleep_until_ns(next->next_release_ns) == WakeReason::Woken) continue;
+				if (stop_requested.load(std::memory_order_relaxed)) break;
+
+				release(*next, now_ns());
+			}
+			stop_requested.store(false);
+			running.store(false);
+		}
+
+		/**
+		 * @brief	Method stop requests that a running executive returns before its next release.
+		 * @details	This method may be called from any thread, including from within a task callback, and
+		 * 			ends a sleep until the next release without waiting for it.
+		 */
+		void stop() {
+			stop_requested.store(true);
+			sleeper.wake();
+		}
+
+		/**
+		 * @brief	Method is_running gets whether the executive is currently running.
+		 * @return	bool true if run or run_until_ns is executing.
+		 */
+		bool is_running() const {
+			return running.load();
+		}
+
+		/**
+		 * @brief	Method task_count gets the number of registered tasks.
+		 * @return	size_t number of registered tasks.
+		 */
+		size_t task_count() const {
+			return tasks.size();
+		}
+
+		/**
+		 * @brief	Method statistics gets the run statistics of a registered task.
+		 * @param	index	size_t index of the task returned by add_task.
+		 * @return	const periodic_task_statistics& statistics of the task.
+		 */
+		const periodic_task_statistics &statistics(const size_t index) const {
+			return tasks.at(index).statistics;
+		}
+
+	private:
+		/**
+		 * @brief	Struct periodic_task holds the schedule and state of one registered task.
+		 */
+		struct periodic_task {
+			uint64_t period_ns;
+			uint64_t phase_ns;
+			OverrunPolicy policy;
+			task_callback callback;
+			uint64_t next_release_ns;
+			periodic_task_statistics statistics;
+		};
+
+		/**
+		 * @brief	Method release runs a task that is due according to its overrun policy and advances
+		 * 			its next release time.
+		 * @param	task	periodic_task that is due.
+		 * @param	current_ns	uint64_t current time in the time base of now_ns.
+		 */
+		void release(periodic_task &task, const uint64_t current_ns) {
+			const uint64_t delay_ns = current_ns > task.next_release_ns ? current_ns - task.next_release_ns : 0;
+			// Number of whole periods by which this release is late, each of which is a missed release.
+			const uint64_t missed = delay_ns / task.period_ns;
+
+			switch (task.policy) {
+				case OverrunPolicy::Skip:
+					// Drop the missed releases and run only the most recent one.
+					task.statistics.overruns += missed;
+					task.next_release_ns += missed * task.period_ns;
+					run_task(task, 1, delay_ns - missed * task.period_ns);
+					task.next_release_ns += task.period_ns;
+					break;
+				case OverrunPolicy::CatchUp:
+					// Run this release only, if we are behind the next one is already due so they run back to back.
+					task.statistics.overruns += missed > 0 ? 1 : 0;
+					run_task(task, 1, delay_ns);
+					task.next_release_ns += task.period_ns;
+					break;
+				case OverrunPolicy::Coalesce:
+					// Run every release that is due in a single call.
+					task.statistics.overruns += missed;
+					run_task(task, missed + 1, delay_ns);
+					task.next_release_ns += (missed + 1) * task.period_ns;
+					break;
+			}
+		}
+
+		/**
+		 * @brief	Method run_task calls a task's callback and updates its statistics.
+		 * @param	task		periodic_task to run.
+		 * @param	releases	uint64_t number of releases covered by the call.
+		 * @param	delay_ns	uint64_t delay between the release time and now.
+		 */
+		void run_task(periodic_task &task, const uint64_t releases, const uint64_t delay_ns) {
+			if (delay_ns > task.statistics.max_release_delay_ns) task.statistics.max_release_delay_ns = delay_ns;
+			task.statistics.runs++;
+			task.callback(task.next_release_ns, releases);
+		}
+
+		/// Registered tasks, scanned linearly for the next release since executives have few tasks.
+		std::vector<periodic_task> tasks;
+		/// Flag for if the executive is currently running.
+		std::atomic<bool> running{false};
+		/// Flag for if the executive has been asked to stop.
+		std::atomic<bool> stop_requested{false};
+		/// Sleeper waiting for the next release, woken by stop.
+		Sleeper sleeper;
+	};
+}
+
+#endif /* PERIODIC_EXECUTIVE_HPP */
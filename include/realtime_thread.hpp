@@ -0,0 +1,265 @@
+/**
+ * @file 	realtime_thread.hpp
+ * @brief 	realtime_thread.hpp defines helpers for running a thread with a real-time scheduling profile.
+ * @details	Sleep accuracy, and in particular its tail latency, depends heavily on how the sleeping thread
+ * 			is scheduled. A realtime_profile declares the scheduling policy, priority, CPU affinity and
+ * 			memory locking that a thread wants, apply_realtime_profile applies as much of it as the process
+ * 			is allowed to, and the realtime_status it returns reports what was actually obtained. Missing
+ * 			privileges are not errors: the parts of the profile that cannot be applied are left at the
+ * 			system defaults and reported as such.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef REALTIME_THREAD_HPP
+#define REALTIME_THREAD_HPP
+
+// C++ Standard Library Headers
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Platform Dependant System Libraries
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif /* WIN32_LEAN_AND_MEAN */
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif /* NOMINMAX */
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+	#include <sys/mman.h>
+#endif /* _WIN32 */
+
+
+namespace high_resolution_sleep {
+	/// Number of bytes of stack touched when pre-faulting the stack of a real-time thread.
+	const static size_t realtime_prefault_stack_bytes = 256 * 1'024;
+	/// Stride between the bytes touched when pre-faulting the stack, no larger than the smallest page size.
+	const static size_t realtime_prefault_stride_bytes = 4'096;
+
+	/**
+	 * @brief	Enum SchedulingPolicy selects the scheduling policy of a thread.
+	 */
+	enum class SchedulingPolicy {
+		/// The default time sharing policy of the system.
+		Default,
+		/// First in first out real-time scheduling (SCHED_FIFO), or time critical priority on Windows.
+		Fifo,
+		/// Round robin real-time scheduling (SCHED_RR), or time critical priority on Windows.
+		RoundRobin
+	};
+
+	/**
+	 * @brief	Struct realtime_profile declares the scheduling a thread would like to run with.
+	 */
+	struct realtime_profile {
+		/// Scheduling policy of the thread.
+		SchedulingPolicy policy = SchedulingPolicy::Fifo;
+		/// Priority of the thread within the policy, clamped to the range the policy allows.
+		int priority = 80;
+		/// CPUs the thread may run on, or empty to leave the affinity unchanged.
+		std::vector<int> cpus{};
+		/// Flag for locking all current and future memory of the process into RAM, off by default since it
+		/// affects the whole process and lasts after the thread exits.
+		bool lock_memory = false;
+		/// Flag for touching the top of the thread's stack so that it does not page fault later.
+		bool prefault_stack = true;
+	};
+
+	/**
+	 * @brief	Struct realtime_status reports the scheduling a thread actually obtained.
+	 */
+	struct realtime_status {
+		/// Scheduling policy the thread is running with.
+		SchedulingPolicy policy = SchedulingPolicy::Default;
+		/// Priority the thread is running with.
+		int priority = 0;
+		/// Flag for if the requested policy and priority were applied.
+		bool policy_applied = false;
+		/// Flag for if the requested CPU affinity was applied.
+		bool affinity_applied = false;
+		/// Flag for if the memory of the process was locked.
+		bool memory_locked = false;
+		/// Flag for if the stack of the thread was pre-faulted.
+		bool stack_prefaulted = false;
+
+		/**
+		 * @brief	Method is_realtime gets whether the thread is running with a real-time policy.
+		 * @return	bool true if the policy is not SchedulingPolicy::Default.
+		 */
+		bool is_realtime() const {
+			return policy != SchedulingPolicy::Default;
+		}
+	};
+
+	/**
+	 * @brief	Function prefault_stack touches the top of the calling thread's stack one page at a time.
+	 * @details	The function is kept out of line so the buffer is always placed in a stack frame of its own.
+	 */
+	#ifdef _MSC_VER
+	__declspec(noinline)
+	#else
+	__attribute__((noinline))
+	#endif /* _MSC_VER */
+	inline void prefault_stack() {
+		volatile unsigned char buffer[realtime_prefault_stack_bytes];
+		for (size_t i = 0; i < realtime_prefault_stack_bytes; i += realtime_prefault_stride_bytes) {
+			buffer[i] = 0;
+		}
+		static_cast<void>(buffer[0]);
+	}
+
+	/**
+	 * @brief	Function apply_realtime_profile applies as much of a real-time profile as possible to the calling thread.
+	 * @param	profile	realtime_profile declaring the scheduling to apply.
+	 * @return	realtime_status describing the scheduling the thread actually obtained.
+	 * @details	Real-time policies and memory locking usually require elevated privileges (CAP_SYS_NICE and
+	 * 			CAP_IPC_LOCK or a suitable RLIMIT_RTPRIO and RLIMIT_MEMLOCK on Linux). Without them the thread
+	 * 			keeps its current scheduling, which is reported in the returned status.
+	 */
+	inline realtime_status apply_realtime_profile(const realtime_profile &profile) {
+		realtime_status status;
+		#ifdef _WIN32
+		// Windows has no real-time policies for threads, the closest is the time critical priority.
+		const int priority = profile.policy == SchedulingPolicy::Default ? THREAD_PRIORITY_NORMAL : THREAD_PRIORITY_TIME_CRITICAL;
+		status.policy_applied = SetThreadPriority(GetCurrentThread(), priority) != 0;
+		status.priority = GetThreadPriority(GetCurrentThread());
+		status.policy = status.priority == THREAD_PRIORITY_TIME_CRITICAL ? profile.policy : SchedulingPolicy::Default;
+		if (!profile.cpus.empty()) {
+			DWORD_PTR mask = 0;
+			for (int cpu : profile.cpus) {
+				if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) mask |= static_cast<DWORD_PTR>(1) << cpu;
+			}
+			status.affinity_applied = mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+		}
+		#else
+		int policy = SCHED_OTHER;
+		if (profile.policy == SchedulingPolicy::Fifo) policy = SCHED_FIFO;
+		else if (profile.policy == SchedulingPolicy::RoundRobin) policy = SCHED_RR;
+		struct sched_param parameters{};
+		if (policy != SCHED_OTHER) {
+			const int minimum = sched_get_priority_min(policy), maximum = sched_get_priority_max(policy);
+			parameters.sched_priority = profile.priority < minimum ? minimum : (profile.priority > maximum ? maximum : profile.priority);
+		}
+		status.policy_applied = pthread_setschedparam(pthread_self(), policy, &parameters) == 0;
+
+		// Report what the thread is actually running with rather than what was requested.
+		int current_policy = SCHED_OTHER;
+		struct sched_param current_parameters{};
+		if (pthread_getschedparam(pthread_self(), &current_policy, &current_parameters) == 0) {
+			if (current_policy == SCHED_FIFO) status.policy = SchedulingPolicy::Fifo;
+			else if (current_policy == SCHED_RR) status.policy = SchedulingPolicy::RoundRobin;
+			status.priority = current_parameters.sched_priority;
+		}
+
+		#ifdef __linux__
+		if (!profile.cpus.empty()) {
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			for (int cpu : profile.cpus) {
+				if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &cpu_set);
+			}
+			status.affinity_applied = CPU_COUNT(&cpu_set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+		}
+		#endif /* __linux__ */
+
+		if (profile.lock_memory) {
+			status.memory_locked = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+		}
+		#endif /* _WIN32 */
+
+		if (profile.prefault_stack) {
+			prefault_stack();
+			status.stack_prefaulted = true;
+		}
+		return status;
+	}
+
+	/**
+	 * @brief	Class realtime_thread runs a function on a new thread after applying a real-time profile to it.
+	 * @details	The class mirrors std::thread, and as with std::thread it must be joined or detached before
+	 * 			it is destroyed. The status of the profile is available once the thread has applied it.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::realtime_profile profile;
+	 * 			profile.cpus = {3};
+	 * 			high_resolution_sleep::realtime_thread thread(profile, []() { control_loop(); });
+	 * 			if (!thread.status().is_realtime()) std::cerr << "running without real-time scheduling\n";
+	 * 			thread.join();
+	 * @endcode
+	 */
+	class realtime_thread {
+	public:
+		realtime_thread() = default;
+		realtime_thread(realtime_thread &&) = default;
+		realtime_thread &operator=(realtime_thread &&) = default;
+		realtime_thread(const realtime_thread &) = delete;
+		realtime_thread &operator=(const realtime_thread &) = delete;
+
+		/**
+		 * @brief	Constructor for realtime_thread that starts the thread.
+		 * @param	profile		realtime_profile to apply to the thread before calling the function.
+		 * @param	function	callable to run on the thread.
+		 * @param	arguments	arguments to call the function with, copied or moved into the thread.
+		 */
+		template <typename Function, typename... Arguments>
+		explicit realtime_thread(const realtime_profile &profile, Function &&function, Arguments &&...arguments) {
+			std::promise<realtime_status> status_promise;
+			applied_status = status_promise.get_future().share();
+			thread = std::thread(
+				[profile, status_promise = std::move(status_promise)](auto function, auto... arguments) mutable {
+					status_promise.set_value(apply_realtime_profile(profile));
+					std::invoke(std::move(function), std::move(arguments)...);
+				},
+				std::forward<Function>(function), std::forward<Arguments>(arguments)...
+			);
+		}
+
+		/**
+		 * @brief	Method status gets the scheduling the thread obtained, waiting until it has been applied.
+		 * @return	realtime_status describing the scheduling of the thread.
+		 */
+		realtime_status status() const {
+			return applied_status.get();
+		}
+
+		/**
+		 * @brief	Method joinable gets whether the thread can be joined.
+		 * @return	bool true if the thread is running or finished and has not been joined or detached.
+		 */
+		bool joinable() const {
+			return thread.joinable();
+		}
+
+		/**
+		 * @brief	Method join waits for the thread to finish.
+		 */
+		void join() {
+			thread.join();
+		}
+
+		/**
+		 * @brief	Method detach lets the thread run independently of the realtime_thread object.
+		 */
+		void detach() {
+			thread.detach();
+		}
+
+	private:
+		/// Underlying thread.
+		std::thread thread;
+		/// Status of the profile, set by the thread before it calls the function.
+		std::shared_future<realtime_status> applied_status;
+	};
+}
+
+#endif /* REALTIME_THREAD_HPP */
@@ -0,0 +1,156 @@
+/**
+ * @file 	sleep_awaitable.hpp
+ * @brief 	sleep_awaitable.hpp defines C++20 coroutine awaitables for high resolution sleeps.
+ * @details	co_await after(duration) and co_await until(deadline) suspend the calling coroutine and
+ * 			schedule it on a SleepExecutor, which keeps the suspended coroutines in a TimingWheel and
+ * 			resumes each one on the wheel's service thread when its deadline arrives. Because no thread
+ * 			is blocked per sleeping coroutine, thousands of paced coroutines can share one thread. The
+ * 			header is empty when compiled as C++17, so the rest of the library is unaffected.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef SLEEP_AWAITABLE_HPP
+#define SLEEP_AWAITABLE_HPP
+
+#if (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)) && __has_include(<coroutine>)
+
+// C++ Standard Library Headers
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "timing_wheel.hpp"
+
+
+namespace high_resolution_sleep {
+	/// Default number of coroutines that can be sleeping on a SleepExecutor at once.
+	const static size_t sleep_executor_default_capacity = 65'536;
+
+	/**
+	 * @brief	Class SleepExecutor resumes sleeping coroutines from the service thread of a timing wheel.
+	 * @details	Coroutines are resumed inline on the service thread, so each executor runs its coroutines
+	 * 			one at a time between their awaits. Long running coroutine bodies delay the others, and
+	 * 			separate executors can be used to spread coroutines over more threads.
+	 */
+	class SleepExecutor {
+	public:
+		/**
+		 * @brief	Constructor for SleepExecutor that starts its timing wheel.
+		 * @param	capacity	size_t maximum number of coroutines that can be sleeping at once.
+		 * @param	tick_ns		uint64_t granularity of the timing wheel in nanoseconds.
+		 */
+		explicit SleepExecutor(const size_t capacity = sleep_executor_default_capacity, const uint64_t tick_ns = 1'000) : wheel(capacity, tick_ns) {
+			wheel.start();
+		}
+
+		/**
+		 * @brief	Method instance gets the default executor used by after and until.
+		 * @return	SleepExecutor& process wide executor.
+		 */
+		static SleepExecutor &instance() {
+			static SleepExecutor executor;
+			return executor;
+		}
+
+		/**
+		 * @brief	Method schedule resumes a suspended coroutine at an absolute time.
+		 * @param	deadline_ns	uint64_t time in the time base of now_ns at which to resume.
+		 * @param	handle		std::coroutine_handle of the suspended coroutine.
+		 * @throws	std::length_error if the executor already has capacity coroutines sleeping.
+		 */
+		void schedule(const uint64_t deadline_ns, std::coroutine_handle<> handle) {
+			wheel.schedule_at_ns(deadline_ns, &SleepExecutor::resume, handle.address());
+		}
+
+		/**
+		 * @brief	Method size gets the number of coroutines sleeping on the executor.
+		 * @return	size_t number of sleeping coroutines.
+		 */
+		size_t size() const {
+			return wheel.size();
+		}
+
+	private:
+		/**
+		 * @brief	Function resume is the timing wheel callback that resumes a coroutine.
+		 * @param	address	void* address of the coroutine handle.
+		 */
+		static void resume(void *address) {
+			std::coroutine_handle<>::from_address(address).resume();
+		}
+
+		/// Timing wheel holding the sleeping coroutines.
+		TimingWheel wheel;
+	};
+
+	/**
+	 * @brief	Struct sleep_awaiter suspends a coroutine until an absolute time.
+	 */
+	struct sleep_awaiter {
+		/// Time in the time base of now_ns at which to resume.
+		uint64_t deadline_ns;
+		/// Executor that resumes the coroutine.
+		SleepExecutor &executor;
+
+		/**
+		 * @brief	Method await_ready skips suspending if the deadline has already passed.
+		 * @return	bool true if the deadline has passed.
+		 */
+		bool await_ready() const {
+			return deadline_ns <= now_ns();
+		}
+
+		/**
+		 * @brief	Method await_suspend schedules the coroutine on the executor.
+		 * @param	handle	std::coroutine_handle of the suspending coroutine.
+		 */
+		void await_suspend(std::coroutine_handle<> handle) const {
+			executor.schedule(deadline_ns, handle);
+		}
+
+		/**
+		 * @brief	Method await_resume does nothing, sleeping has no result.
+		 */
+		void await_resume() const noexcept {}
+	};
+
+	/**
+	 * @brief	Function until creates an awaitable that resumes the coroutine at an absolute time.
+	 * @param	deadline_ns	uint64_t time in the time base of now_ns at which to resume.
+	 * @param	executor	SleepExecutor& executor that resumes the coroutine.
+	 * @return	sleep_awaiter awaitable to co_await.
+	 */
+	inline sleep_awaiter until(const uint64_t deadline_ns, SleepExecutor &executor = SleepExecutor::instance()) {
+		return sleep_awaiter{deadline_ns, executor};
+	}
+
+	/**
+	 * @brief	Function until creates an awaitable that resumes the coroutine at a std::chrono time point.
+	 * @param	deadline	std::chrono::time_point at which to resume.
+	 * @param	executor	SleepExecutor& executor that resumes the coroutine.
+	 * @return	sleep_awaiter awaitable to co_await.
+	 */
+	template <typename Clock, typename Duration>
+	sleep_awaiter until(const std::chrono::time_point<Clock, Duration> &deadline, SleepExecutor &executor = SleepExecutor::instance()) {
+		return sleep_awaiter{time_point_to_ns(deadline), executor};
+	}
+
+	/**
+	 * @brief	Function after creates an awaitable that resumes the coroutine after a std::chrono duration.
+	 * @param	duration	std::chrono::duration to sleep for, negative durations do not suspend.
+	 * @param	executor	SleepExecutor& executor that resumes the coroutine.
+	 * @return	sleep_awaiter awaitable to co_await.
+	 */
+	template <typename Rep, typename Period>
+	sleep_awaiter after(const std::chrono::duration<Rep, Period> &duration, SleepExecutor &executor = SleepExecutor::instance()) {
+		return sleep_awaiter{now_ns() + duration_to_ns(duration), executor};
+	}
+}
+
+#endif /* C++20 coroutines */
+
+#endif /* SLEEP_AWAITABLE_HPP */
@@ -0,0 +1,393 @@
+/**
+ * @file 	sleep_latency_histogram.hpp
+ * @brief 	sleep_latency_histogram.hpp defines lock-free log-linear histograms for recording the accuracy
+ * 			of sleep calls in production.
+ * @details	When HIGH_RESOLUTION_SLEEP_INSTRUMENTATION is defined before high_resolution_sleep.hpp is
+ * 			included, every call to sleep_ms, sleep_ms_corrected and sleep_us records its requested
+ * 			duration and its overshoot into histograms owned by the calling thread. Each thread only ever
+ * 			writes its own histograms, so recording is a handful of relaxed atomic loads and stores with
+ * 			no locks or read-modify-write instructions, and snapshot_sleep_latency can merge the
+ * 			histograms of every thread from another thread without stopping the writers. Without the
+ * 			definition the instrumentation is compiled out entirely.
+ *
+ * 			The histograms are HDR style: values below 32 ns each have their own bucket, and every power
+ * 			of two above that is split into 16 linear buckets, so any recorded value is reported to
+ * 			within 6.25% across the full 64 bit range using under 1000 buckets.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef SLEEP_LATENCY_HISTOGRAM_HPP
+#define SLEEP_LATENCY_HISTOGRAM_HPP
+
+// C++ Standard Library Headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif /* _MSC_VER */
+
+
+namespace high_resolution_sleep {
+	/// Number of bits of each value kept by the linear buckets within a power of two.
+	const static size_t latency_histogram_sub_bucket_bits = 4;
+	/// Number of linear buckets within each power of two.
+	const static size_t latency_histogram_sub_buckets = static_cast<size_t>(1) << latency_histogram_sub_bucket_bits;
+	/// Total number of buckets needed to cover every uint64_t value.
+	const static size_t latency_histogram_buckets = (64 - latency_histogram_sub_bucket_bits) * latency_histogram_sub_buckets + latency_histogram_sub_buckets;
+
+	/**
+	 * @brief	Function latency_histogram_index gets the bucket a value is counted in.
+	 * @param	value	uint64_t value to find the bucket of.
+	 * @return	size_t index of the bucket.
+	 */
+	inline size_t latency_histogram_index(const uint64_t value) {
+		if (value < 2 * latency_histogram_sub_buckets) return static_cast<size_t>(value);
+		#if defined(_MSC_VER)
+		unsigned long most_significant_bit;
+		_BitScanReverse64(&most_significant_bit, value);
+		#else
+		const size_t most_significant_bit = 63 - __builtin_clzll(value);
+		#endif /* _MSC_VER */
+		const size_t shift = most_significant_bit - latency_histogram_sub_bucket_bits;
+		return shift * latency_histogram_sub_buckets + static_cast<size_t>(value >> shift);
+	}
+
+	/**
+	 * @brief	Function latency_histogram_lowest_value gets the smallest value counted in a bucket.
+	 * @param	index	size_t index of the bucket.
+	 * @return	uint64_t smallest value in the bucket.
+	 */
+	inline uint64_t latency_histogram_lowest_value(const size_t index) {
+		if (index < 2 * latency_histogram_sub_buckets) return index;
+		const size_t shift = index / latency_histogram_sub_buckets - 1;
+		return static_cast<uint64_t>(index % latency_histogram_sub_buckets + latency_histogram_sub_buckets) << shift;
+	}
+
+	/**
+	 * @brief	Function latency_histogram_highest_value gets the largest value counted in a bucket.
+	 * @param	index	size_t index of the bucket.
+	 * @return	uint64_t largest value in the bucket.
+	 */
+	inline uint64_t latency_histogram_highest_value(const size_t index) {
+		return index + 1 < latency_histogram_buckets ? latency_histogram_lowest_value(index + 1) - 1 : UINT64_MAX;
+	}
+
+	/**
+	 * @brief	Class LatencyHistogram is a plain log-linear histogram, used for snapshots and merging.
+	 */
+	class LatencyHistogram {
+	public:
+		/**
+		 * @brief	Method record counts a value.
+		 * @param	value	uint64_t value to count.
+		 * @param	count	uint64_t number of times to count it.
+		 */
+		void record(const uint64_t value, const uint64_t count = 1) {
+			counts[latency_histogram_index(value)] += count;
+			total += count;
+		}
+
+		/**
+		 * @brief	Method merge adds the counts of another histogram to this one.
+		 * @param	other	LatencyHistogram to add.
+		 */
+		void merge(const LatencyHistogram &other) {
+			for (size_t i = 0; i < latency_histogram_buckets; i++) counts[i] += other.counts[i];
+			total += other.total;
+		}
+
+		/**
+		 * @brief	Method count gets the number of values counted.
+		 * @return	uint64_t number of values.
+		 */
+		uint64_t count() const {
+			return total;
+		}
+
+		/**
+		 * @brief	Method bucket_count gets the number of values counted in a bucket.
+		 * @param	index	size_t index of the bucket.
+		 * @return	uint64_t number of values in the bucket.
+		 */
+		uint64_t bucket_count(const size_t index) const {
+			return counts[index];
+		}
+
+		/**
+		 * @brief	Method percentile gets the value below which a fraction of the counted values fall.
+		 * @param	fraction	double fraction of values between 0 and 1, e.g. 0.99 for the 99th percentile.
+		 * @return	uint64_t largest value in the bucket holding the percentile, or 0 if the histogram is empty.
+		 */
+		uint64_t percentile(const double fraction) const {
+			if (total == 0) return 0;
+			const double clamped = fraction < 0.0 ? 0.0 : (fraction > 1.0 ? 1.0 : fraction);
+			uint64_t target = static_cast<uint64_t>(clamped * static_cast<double>(total) + 0.5);
+			if (target == 0) target = 1;
+			uint64_t seen = 0;
+			for (size_t i = 0; i < latency_histogram_buckets; i++) {
+				seen += counts[i];
+				if (seen >= target) return latency_histogram_highest_value(i);
+			}
+			return UINT64_MAX;
+		}
+
+		/**
+		 * @brief	Method max gets the largest counted value to the precision of the histogram.
+		 * @return	uint64_t largest value in the highest non-empty bucket, or 0 if the histogram is empty.
+		 */
+		uint64_t max() const {
+			for (size_t i = latency_histogram_buckets; i > 0; i--) {
+				if (counts[i - 1] != 0) return latency_histogram_highest_value(i - 1);
+			}
+			return 0;
+		}
+
+	private:
+		/// Number of values counted in each bucket.
+		std::array<uint64_t, latency_histogram_buckets> counts{};
+		/// Number of values counted.
+		uint64_t total = 0;
+	};
+
+	/**
+	 * @brief	Class ConcurrentLatencyHistogram is a log-linear histogram with one writer and any number of readers.
+	 * @details	The single writer increments the counters with a relaxed load and store rather than an atomic
+	 * 			read-modify-write, which keeps recording to a few nanoseconds. Readers may see a snapshot
+	 * 			that is missing the values recorded while it was taken, but never a torn counter.
+	 */
+	class ConcurrentLatencyHistogram {
+	public:
+		/**
+		 * @brief	Method record counts a value, must only be called by the owning thread.
+		 * @param	value	uint64_t value to count.
+		 */
+		void record(const uint64_t value) {
+			std::atomic<uint64_t> &counter = counts[latency_histogram_index(value)];
+			counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief	Method snapshot_into adds the current counts to a plain histogram, callable from any thread.
+		 * @param	histogram	LatencyHistogram to add the counts to.
+		 */
+		void snapshot_into(LatencyHistogram &histogram) const {
+			for (size_t i = 0; i < latency_histogram_buckets; i++) {
+				const uint64_t count = counts[i].load(std::memory_order_relaxed);
+				if (count != 0) histogram.record(latency_histogram_lowest_value(i), count);
+			}
+		}
+
+	private:
+		/// Number of values counted in each bucket.
+		std::array<std::atomic<uint64_t>, latency_histogram_buckets> counts{};
+	};
+
+	/**
+	 * @brief	Enum InstrumentedSleep identifies the sleep function a latency was recorded for.
+	 */
+	enum class InstrumentedSleep {
+		/// Calls to sleep_ms.
+		SleepMs,
+		/// Calls to sleep_ms_corrected, recorded against the corrected duration that was slept.
+		SleepMsCorrected,
+		/// Calls to sleep_us.
+		SleepUs
+	};
+
+	/// Number of instrumented sleep functions.
+	const static size_t instrumented_sleep_count = 3;
+
+	/**
+	 * @brief	Struct sleep_latency_snapshot holds the merged histograms of every thread at one instant.
+	 */
+	struct sleep_latency_snapshot {
+		/// Histograms of the requested durations in nanoseconds, indexed by InstrumentedSleep.
+		std::array<LatencyHistogram, instrumented_sleep_count> requested_ns{};
+		/// Histograms of the time slept beyond the requested duration in nanoseconds, indexed by InstrumentedSleep.
+		std::array<LatencyHistogram, instrumented_sleep_count> overshoot_ns{};
+
+		/**
+		 * @brief	Method requested gets the requested duration histogram of a sleep function.
+		 * @param	function	InstrumentedSleep function to get the histogram of.
+		 * @return	const LatencyHistogram& histogram of requested durations.
+		 */
+		const LatencyHistogram &requested(const InstrumentedSleep function) const {
+			return requested_ns[static_cast<size_t>(function)];
+		}
+
+		/**
+		 * @brief	Method overshoot gets the overshoot histogram of a sleep function.
+		 * @param	function	InstrumentedSleep function to get the histogram of.
+		 * @return	const LatencyHistogram& histogram of overshoots.
+		 */
+		const LatencyHistogram &overshoot(const InstrumentedSleep function) const {
+			return overshoot_ns[static_cast<size_t>(function)];
+		}
+	};
+
+	/**
+	 * @brief	Class SleepLatencyRegistry owns the histograms of every thread that has recorded a sleep.
+	 * @details	Threads register their histograms the first time they record, and when a thread exits its
+	 * 			counts are folded into a set of retired histograms so they still appear in snapshots.
+	 */
+	class SleepLatencyRegistry {
+	public:
+		/**
+		 * @brief	Struct thread_histograms holds the histograms written by one thread.
+		 */
+		struct thread_histograms {
+			/// Histograms of the requested durations in nanoseconds, indexed by InstrumentedSleep.
+			std::array<ConcurrentLatencyHistogram, instrumented_sleep_count> requested_ns{};
+			/// Histograms of the overshoots in nanoseconds, indexed by InstrumentedSleep.
+			std::array<ConcurrentLatencyHistogram, instrumented_sleep_count> overshoot_ns{};
+			/// Number of instrumented calls the thread is currently inside, only the outermost is recorded.
+			uint32_t depth = 0;
+		};
+
+		/**
+		 * @brief	Method instance gets the process wide registry.
+		 * @return	SleepLatencyRegistry& registry.
+		 */
+		static SleepLatencyRegistry &instance() {
+			static SleepLatencyRegistry registry;
+			return registry;
+		}
+
+		/**
+		 * @brief	Method local gets the histograms of the calling thread, registering them on first use.
+		 * @return	thread_histograms& histograms of the calling thread.
+		 */
+		static thread_histograms &local() {
+			thread_local thread_registration registration(instance());
+			return *registration.histograms;
+		}
+
+		/**
+		 * @brief	Method snapshot merges the histograms of every thread, past and present.
+		 * @return	sleep_latency_snapshot merged histograms.
+		 */
+		sleep_latency_snapshot snapshot() {
+			std::lock_guard<std::mutex> lock(mutex);
+			sleep_latency_snapshot merged = retired;
+			for (thread_histograms *histograms : threads) {
+				for (size_t i = 0; i < instrumented_sleep_count; i++) {
+					histograms->requested_ns[i].snapshot_into(merged.requested_ns[i]);
+					histograms->overshoot_ns[i].snapshot_into(merged.overshoot_ns[i]);
+				}
+			}
+			return merged;
+		}
+
+	private:
+		/**
+		 * @brief	Struct thread_registration registers a thread's histograms for the lifetime of the thread.
+		 */
+		struct thread_registration {
+			explicit thread_registration(SleepLatencyRegistry &registry) : registry(registry), histograms(new thread_histograms()) {
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				registry.threads.push_back(histograms.get());
+			}
+
+			~thread_registration() {
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				for (size_t i = 0; i < instrumented_sleep_count; i++) {
+					histograms->requested_ns[i].snapshot_into(registry.retired.requested_ns[i]);
+					histograms->overshoot_ns[i].snapshot_into(registry.retired.overshoot_ns[i]);
+				}
+				for (size_t i = 0; i < registry.threads.size(); i++) {
+					if (registry.threads[i] == histograms.get()) {
+						registry.threads[i] = registry.threads.back();
+						registry.threads.pop_back();
+						break;
+					}
+				}
+			}
+
+			/// Registry the histograms are registered with.
+			SleepLatencyRegistry &registry;
+			/// Histograms of the thread.
+			std::unique_ptr<thread_histograms> histograms;
+		};
+
+		/// Histograms of the threads that are currently registered.
+		std::vector<thread_histograms *> threads;
+		/// Merged histograms of the threads that have exited.
+		sleep_latency_snapshot retired{};
+		/// Mutex protecting the list of threads and the retired histograms, never taken while recording.
+		std::mutex mutex;
+	};
+
+	/**
+	 * @brief	Function snapshot_sleep_latency merges the sleep latency histograms of every thread.
+	 * @return	sleep_latency_snapshot merged histograms.
+	 */
+	inline sleep_latency_snapshot snapshot_sleep_latency() {
+		return SleepLatencyRegistry::instance().snapshot();
+	}
+
+	/**
+	 * @brief	Class sleep_latency_recorder times the enclosing scope and records it as a sleep call.
+	 * @details	Only the outermost recorder on a thread records, so sleeps that are implemented in terms of
+	 * 			other instrumented sleeps are counted once. A recorder constructed without a function
+	 * 			records nothing, which hides any instrumented sleeps that an uninstrumented function makes.
+	 */
+	class sleep_latency_recorder {
+	public:
+		/**
+		 * @brief	Constructor for sleep_latency_recorder that suppresses recording within its scope.
+		 */
+		sleep_latency_recorder() : histograms(SleepLatencyRegistry::local()), recording(false) {
+			histograms.depth++;
+		}
+
+		/**
+		 * @brief	Constructor for sleep_latency_recorder that starts timing a sleep call.
+		 * @param	function		InstrumentedSleep function being called.
+		 * @param	requested_ns	uint64_t requested duration of the sleep in nanoseconds.
+		 */
+		sleep_latency_recorder(const InstrumentedSleep function, const uint64_t requested_ns) :
+			histograms(SleepLatencyRegistry::local()),
+			recording(histograms.depth++ == 0),
+			function(static_cast<size_t>(function)),
+			requested_ns(requested_ns),
+			start(recording ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {}
+
+		sleep_latency_recorder(const sleep_latency_recorder &) = delete;
+		sleep_latency_recorder &operator=(const sleep_latency_recorder &) = delete;
+
+		/**
+		 * @brief	Destructor for sleep_latency_recorder that records the requested duration and overshoot.
+		 * @details	Sleeps that return early are recorded with an overshoot of zero.
+		 */
+		~sleep_latency_recorder() {
+			histograms.depth--;
+			if (!recording) return;
+			const int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			const int64_t overshoot_ns = elapsed_ns - static_cast<int64_t>(requested_ns);
+			histograms.requested_ns[function].record(requested_ns);
+			histograms.overshoot_ns[function].record(overshoot_ns > 0 ? static_cast<uint64_t>(overshoot_ns) : 0);
+		}
+
+	private:
+		/// Histograms of the calling thread.
+		SleepLatencyRegistry::thread_histograms &histograms;
+		/// Flag for if this is the outermost recorder and should record.
+		bool recording;
+		/// Index of the sleep function being recorded.
+		size_t function = 0;
+		/// Requested duration of the sleep in nanoseconds.
+		uint64_t requested_ns = 0;
+		/// Time at which the sleep started.
+		std::chrono::steady_clock::time_point start;
+	};
+}
+
+#endif /* SLEEP_LATENCY_HISTOGRAM_HPP */
@@ -0,0 +1,408 @@
+/**
+ * @file 	sleep_trace.hpp
+ * @brief 	sleep_trace.hpp defines an allocation-free recorder for traces of sleep calls, a compact binary
+ * 			file format for storing them, and a replayer that re-issues a recorded sequence of sleeps.
+ * @details	A SleepTraceRecorder preallocates a ring of fixed size binary records, so recording a sleep
+ * 			from any thread is a few atomic operations and a 32 byte copy with no allocation or
+ * 			formatting. The ring is drained off the hot path, either explicitly or by a background thread
+ * 			that appends the records to a trace file. Trace files are a 16 byte header followed by the
+ * 			raw records, so a million samples take 32 MB and can be read back with a single read.
+ * 			replay_sleep_trace re-issues the sleeps of a trace with their original spacing, so timing
+ * 			patterns captured in production can be reproduced in benchmarks.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef SLEEP_TRACE_HPP
+#define SLEEP_TRACE_HPP
+
+// C++ Standard Library Headers
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/// Default number of records a SleepTraceRecorder can hold before it is drained.
+	const static size_t sleep_trace_default_capacity = 1 << 16;
+	/// Default number of nanoseconds between drains of the background drain thread.
+	const static uint64_t sleep_trace_drain_interval_ns = 10'000'000;
+	/// Magic bytes at the start of a trace file.
+	const static char sleep_trace_magic[8] = {'H', 'R', 'S', 'T', 'R', 'A', 'C', 'E'};
+	/// Version of the trace file format.
+	const static uint32_t sleep_trace_version = 1;
+
+	/**
+	 * @brief	Enum SleepStrategy identifies the function used for a recorded sleep.
+	 */
+	enum class SleepStrategy : uint32_t {
+		/// A call to sleep_ms.
+		SleepMs = 0,
+		/// A call to sleep_ms_corrected, recorded with the corrected duration.
+		SleepMsCorrected = 1,
+		/// A call to sleep_us.
+		SleepUs = 2,
+		/// A call to sleep_until_ns, recorded with the duration until the deadline.
+		SleepUntilNs = 3,
+		/// A call to sleep_us_hybrid.
+		SleepUsHybrid = 4,
+		/// A sleep made by some other means, such as an event loop timer.
+		Other = 255
+	};
+
+	/**
+	 * @brief	Struct sleep_trace_record is the fixed size binary record of one sleep.
+	 */
+	struct sleep_trace_record {
+		/// Time the sleep started in the time base of now_ns.
+		uint64_t start_ns;
+		/// Time the sleep ended in the time base of now_ns.
+		uint64_t end_ns;
+		/// Requested duration of the sleep in nanoseconds.
+		uint64_t requested_ns;
+		/// SleepStrategy used for the sleep.
+		uint32_t strategy;
+		/// Identifier of the thread that slept, see sleep_trace_thread_id.
+		uint32_t thread_id;
+	};
+	static_assert(sizeof(sleep_trace_record) == 32, "sleep_trace_record must be packed into 32 bytes.");
+
+	/**
+	 * @brief	Struct sleep_trace_header is the header at the start of a trace file.
+	 */
+	struct sleep_trace_header {
+		/// Magic bytes identifying the file as a trace.
+		char magic[8];
+		/// Version of the file format.
+		uint32_t version;
+		/// Size of each record in bytes.
+		uint32_t record_size;
+	};
+	static_assert(sizeof(sleep_trace_header) == 16, "sleep_trace_header must be packed into 16 bytes.");
+
+	/**
+	 * @brief	Function sleep_trace_thread_id gets a small identifier for the calling thread.
+	 * @return	uint32_t identifier, assigned in the order threads first call the function.
+	 */
+	inline uint32_t sleep_trace_thread_id() {
+		static std::atomic<uint32_t> next_thread_id{0};
+		thread_local const uint32_t thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+		return thread_id;
+	}
+
+	/**
+	 * @brief	Function write_sleep_trace_header writes the header of a trace file.
+	 * @param	output	std::ostream opened in binary mode to write to.
+	 */
+	inline void write_sleep_trace_header(std::ostream &output) {
+		sleep_trace_header header{};
+		std::memcpy(header.magic, sleep_trace_magic, sizeof(header.magic));
+		header.version = sleep_trace_version;
+		header.record_size = sizeof(sleep_trace_record);
+		output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	}
+
+	/**
+	 * @brief	Function write_sleep_trace writes a trace file.
+	 * @param	records		std::vector of sleep_trace_record to write.
+	 * @param	file_name	std::string path of the file to write.
+	 * @throws	std::runtime_error if the file cannot be written.
+	 */
+	inline void write_sleep_trace(const std::vector<sleep_trace_record> &records, const std::string &file_name) {
+		std::ofstream output(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+		write_sleep_trace_header(output);
+		output.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(sleep_trace_record));
+		if (!output) throw std::runtime_error("write_sleep_trace: could not write " + file_name);
+	}
+
+	/**
+	 * @brief	Function read_sleep_trace reads a trace file.
+	 * @param	file_name	std::string path of the file to read.
+	 * @return	std::vector of sleep_trace_record in the file.
+	 * @throws	std::runtime_error if the file cannot be read or is not a trace file.
+	 */
+	inline std::vector<sleep_trace_record> read_sleep_trace(const std::string &file_name) {
+		std::ifstream input(file_name, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!input) throw std::runtime_error("read_sleep_trace: could not open " + file_name);
+		const std::streamoff file_size = input.tellg();
+		input.seekg(0);
+
+		sleep_trace_header header{};
+		input.read(reinterpret_cast<char *>(&header), sizeof(header));
+		if (!input || std::memcmp(header.magic, sleep_trace_magic, sizeof(header.magic)) != 0 ||
+			header.version != sleep_trace_version || header.record_size != sizeof(sleep_trace_record)) {
+			throw std::runtime_error("read_sleep_trace: " + file_name + " is not a version " + std::to_string(sleep_trace_version) + " sleep trace");
+		}
+
+		// A partially written final record, e.g. from a process that was killed while draining, is ignored.
+		std::vector<sleep_trace_record> records(static_cast<size_t>(file_size - sizeof(header)) / sizeof(sleep_trace_record));
+		input.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(sleep_trace_record));
+		if (!input) throw std::runtime_error("read_sleep_trace: could not read " + file_name);
+		return records;
+	}
+
+	/**
+	 * @brief	Class SleepTraceRecorder records sleeps from any number of threads into a preallocated ring.
+	 * @details	The ring is a bounded multi-producer single-consumer queue: each slot carries a sequence
+	 * 			number that tells writers when it is free and the drainer when it is full, so neither side
+	 * 			ever takes a lock. When the ring is full new records are dropped and counted rather than
+	 * 			blocking the sleeping thread.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::SleepTraceRecorder recorder;
+	 * 			recorder.start_drain("control_loop.trace");
+	 * 			while (running) {
+	 * 				uint64_t start_ns = high_resolution_sleep::now_ns();
+	 * 				high_resolution_sleep::sleep_us(250);
+	 * 				recorder.record(start_ns, high_resolution_sleep::now_ns(), 250'000, high_resolution_sleep::SleepStrategy::SleepUs);
+	 * 			}
+	 * 			recorder.stop_drain();
+	 * @endcode
+	 */
+	class SleepTraceRecorder {
+	public:
+		/**
+		 * @brief	Constructor for SleepTraceRecorder that preallocates the ring.
+		 * @param	capacity	size_t number of records the ring can hold, rounded up to a power of two.
+		 */
+		explicit SleepTraceRecorder(const size_t capacity = sleep_trace_default_capacity) {
+			size_t rounded_capacity = 1;
+			while (rounded_capacity < capacity) rounded_capacity <<= 1;
+			mask = rounded_capacity - 1;
+			slots.reset(new trace_slot[rounded_capacity]);
+			for (size_t i = 0; i < rounded_capacity; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		SleepTraceRecorder(const SleepTraceRecorder &) = delete;
+		SleepTraceRecorder &operator=(const SleepTraceRecorder &) = delete;
+
+		/**
+		 * @brief	Destructor for SleepTraceRecorder that stops the background drain if it is running.
+		 */
+		~SleepTraceRecorder() {
+			stop_drain();
+		}
+
+		/**
+		 * @brief	Method record adds a sleep to the ring, callable from any thread.
+		 * @param	start_ns		uint64_t time the sleep started.
+		 * @param	end_ns			uint64_t time the sleep ended.
+		 * @param	requested_ns	uint64_t requested duration of the sleep.
+		 * @param	strategy		SleepStrategy used for the sleep.
+		 * @return	bool true if the record was added, false if the ring was full and it was dropped.
+		 */
+		bool record(const uint64_t start_ns, const uint64_t end_ns, const uint64_t requested_ns, const SleepStrategy strategy) {
+			return record(sleep_trace_record{start_ns, end_ns, requested_ns, static_cast<uint32_t>(strategy), sleep_trace_thread_id()});
+		}
+
+		/**
+		 * @brief	Method record adds a record to the ring, callable from any thread.
+		 * @param	trace_record	sleep_trace_record to add.
+		 * @return	bool true if the record was added, false if the ring was full and it was dropped.
+		 */
+		bool record(const sleep_trace_record &trace_record) {
+			uint64_t position = head.load(std::memory_order_relaxed);
+			trace_slot *slot;
+			while (true) {
+				slot = &slots[position & mask];
+				const int64_t difference = static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire) - position);
+				if (difference == 0) {
+					if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+				}
+				else if (difference < 0) {
+					dropped_records.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				else {
+					position = head.load(std::memory_order_relaxed);
+				}
+			}
+			slot->record = trace_record;
+			slot->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief	Method drain moves every complete record out of the ring, in the order they were added.
+		 * @param	records	std::vector to append the records to.
+		 * @return	size_t number of records drained.
+		 */
+		size_t drain(std::vector<sleep_trace_record> &records) {
+			std::lock_guard<std::mutex> lock(drain_mutex);
+			size_t count = 0;
+			while (true) {
+				trace_slot &slot = slots[tail & mask];
+				if (slot.sequence.load(std::memory_order_acquire) != tail + 1) break;
+				records.push_back(slot.record);
+				slot.sequence.store(tail + mask + 1, std::memory_order_release);
+				tail++;
+				count++;
+			}
+			return count;
+		}
+
+		/**
+		 * @brief	Method start_drain starts a background thread that appends the ring to a trace file.
+		 * @param	file_name	std::string path of the trace file to create.
+		 * @param	interval_ns	uint64_t number of nanoseconds between drains.
+		 * @throws	std::runtime_error if the file cannot be created or a drain is already running.
+		 */
+		void start_drain(const std::string &file_name, const uint64_t interval_ns = sleep_trace_drain_interval_ns) {
+			if (drain_thread.joinable()) throw std::runtime_error("SleepTraceRecorder::start_drain: a drain is already running.");
+			drain_file.open(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!drain_file) throw std::runtime_error("SleepTraceRecorder::start_drain: could not create " + file_name);
+			write_sleep_trace_header(drain_file);
+			drain_stop_requested = false;
+			drain_thread = std::thread([this, interval_ns]() {
+				std::vector<sleep_trace_record> records;
+				records.reserve(mask + 1);
+				std::unique_lock<std::mutex> lock(drain_thread_mutex);
+				while (true) {
+					const bool stopping = drain_condition.wait_for(lock, std::chrono::nanoseconds(interval_ns), [this]() { return drain_stop_requested; });
+					drain(records);
+					drain_file.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(sleep_trace_record));
+					records.clear();
+					if (stopping) break;
+				}
+			});
+		}
+
+		/**
+		 * @brief	Method stop_drain drains the remaining records, stops the background thread and closes the file.
+		 */
+		void stop_drain() {
+			if (!drain_thread.joinable()) return;
+			{
+				std::lock_guard<std::mutex> lock(drain_thread_mutex);
+				drain_stop_requested = true;
+			}
+			drain_condition.notify_one();
+			drain_thread.join();
+			drain_file.close();
+		}
+
+		/**
+		 * @brief	Method capacity gets the number of records the ring can hold.
+		 * @return	size_t capacity of the ring.
+		 */
+		size_t capacity() const {
+			return mask + 1;
+		}
+
+		/**
+		 * @brief	Method dropped gets the number of records dropped because the ring was full.
+		 * @return	uint64_t number of dropped records.
+		 */
+		uint64_t dropped() const {
+			return dropped_records.load(std::memory_order_relaxed);
+		}
+
+	private:
+		/**
+		 * @brief	Struct trace_slot is a slot of the ring.
+		 */
+		struct trace_slot {
+			/// Sequence number of the slot, equal to the position of the next write when free.
+			std::atomic<uint64_t> sequence;
+			/// Record held by the slot.
+			sleep_trace_record record;
+		};
+
+		/// Slots of the ring.
+		std::unique_ptr<trace_slot[]> slots;
+		/// Capacity of the ring minus one.
+		size_t mask = 0;
+		/// Position of the next record to be written.
+		std::atomic<uint64_t> head{0};
+		/// Position of the next record to be drained.
+		uint64_t tail = 0;
+		/// Number of records dropped because the ring was full.
+		std::atomic<uint64_t> dropped_records{0};
+		/// Mutex allowing drain to be called from several threads.
+		std::mutex drain_mutex;
+
+		/// Background thread draining the ring to a file.
+		std::thread drain_thread;
+		/// File the background thread drains to.
+		std::ofstream drain_file;
+		/// Flag for the background thread to stop.
+		bool drain_stop_requested = false;
+		/// Mutex protecting the stop flag.
+		std::mutex drain_thread_mutex;
+		/// Condition variable waking the background thread to stop.
+		std::condition_variable drain_condition;
+	};
+
+	/**
+	 * @brief	Function replay_sleep re-issues one recorded sleep with the function it was recorded for.
+	 * @param	trace_record	sleep_trace_record of the sleep to re-issue.
+	 */
+	inline void replay_sleep(const sleep_trace_record &trace_record) {
+		switch (static_cast<SleepStrategy>(trace_record.strategy)) {
+			case SleepStrategy::SleepMs:
+			case SleepStrategy::SleepMsCorrected:
+				sleep_ms(static_cast<uint32_t>(trace_record.requested_ns / 1'000'000));
+				break;
+			case SleepStrategy::SleepUs:
+				sleep_us(static_cast<uint32_t>(trace_record.requested_ns / 1'000));
+				break;
+			case SleepStrategy::SleepUsHybrid:
+				#ifndef _WIN32
+				sleep_us_hybrid(static_cast<uint32_t>(trace_record.requested_ns / 1'000));
+				#else
+				sleep_us(static_cast<uint32_t>(trace_record.requested_ns / 1'000));
+				#endif /* _WIN32 */
+				break;
+			default:
+				sleep_until_ns(now_ns() + trace_record.requested_ns);
+				break;
+		}
+	}
+
+	/**
+	 * @brief	Function replay_sleep_trace re-issues the sleeps of a trace on the calling thread.
+	 * @param	trace			std::vector of sleep_trace_record to replay.
+	 * @param	preserve_gaps	bool true to start each sleep at the same offset from the first as in the
+	 * 							trace, false to issue the sleeps back to back.
+	 * @param	sleeper			std::function that re-issues one sleep, replay_sleep by default.
+	 * @return	std::vector of sleep_trace_record measured during the replay, in the order of the trace.
+	 * @details	The sleeps of every thread in the trace are replayed in order of their start times. When
+	 * 			a sleep overruns into the start of the next one, the next one is issued immediately.
+	 */
+	inline std::vector<sleep_trace_record> replay_sleep_trace(std::vector<sleep_trace_record> trace, const bool preserve_gaps = true, const std::function<void(const sleep_trace_record &)> &sleeper = replay_sleep) {
+		std::stable_sort(trace.begin(), trace.end(), [](const sleep_trace_record &a, const sleep_trace_record &b) { return a.start_ns < b.start_ns; });
+		std::vector<sleep_trace_record> replayed;
+		replayed.reserve(trace.size());
+		const uint64_t replay_start_ns = now_ns();
+		for (const sleep_trace_record &trace_record : trace) {
+			if (preserve_gaps) {
+				const uint64_t issue_ns = replay_start_ns + (trace_record.start_ns - trace.front().start_ns);
+				#ifndef _WIN32
+				sleep_until_ns_hybrid(issue_ns, hybrid_sleep_config{});
+				#else
+				sleep_until_ns(issue_ns);
+				#endif /* _WIN32 */
+			}
+			const uint64_t start_ns = now_ns();
+			sleeper(trace_record);
+			const uint64_t end_ns = now_ns();
+			replayed.push_back(sleep_trace_record{start_ns, end_ns, trace_record.requested_ns, trace_record.strategy, sleep_trace_thread_id()});
+		}
+		return replayed;
+	}
+}
+
+#endif /* SLEEP_TRACE_HPP */
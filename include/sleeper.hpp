@@ -0,0 +1,221 @@
+/**
+ * @file 	sleeper.hpp
+ * @brief 	sleeper.hpp defines a precise sleep that can be interrupted from another thread.
+ * @details	The Sleeper class sleeps with the same sleep-then-spin strategy as sleep_until_ns_hybrid, but
+ * 			the kernel sleep phase waits on a futex (a condition variable on platforms other than Linux)
+ * 			rather than a timer, and every phase checks for a wake. Another thread calling wake ends the
+ * 			sleep within the futex wakeup latency, so threads blocked in long sleeps can be shut down or
+ * 			reconfigured without waiting for their period to run out. sleep_until_ns_on and sleep_for_on
+ * 			measure the deadline on one of the clock_source clocks instead of now_ns.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef SLEEPER_HPP
+#define SLEEPER_HPP
+
+// C++ Standard Library Headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+// Platform Dependant System Libraries
+#ifdef __linux__
+	#include <climits>
+	#include <linux/futex.h>
+	#include <sys/syscall.h>
+	#include <time.h>
+	#include <unistd.h>
+#else
+	#include <condition_variable>
+	#include <mutex>
+#endif /* __linux__ */
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/**
+	 * @brief	Enum WakeReason is why a Sleeper returned.
+	 */
+	enum class WakeReason {
+		/// The deadline was reached.
+		Deadline,
+		/// Another thread called wake before the deadline.
+		Woken
+	};
+
+	/**
+	 * @brief	Class Sleeper sleeps until a deadline unless it is woken from another thread first.
+	 * @details	A wake is latched until a sleep consumes it, so a wake that races ahead of the sleep it was
+	 * 			meant for makes that sleep return immediately rather than being lost. One thread should
+	 * 			sleep on a Sleeper at a time, while any number of threads may wake it.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::Sleeper sleeper;
+	 * 			std::thread worker([&]() {
+	 * 				while (sleeper.sleep_for(std::chrono::seconds(1)) == high_resolution_sleep::WakeReason::Deadline) {
+	 * 					do_periodic_work();
+	 * 				}
+	 * 			});
+	 * 			...
+	 * 			// Shut down the worker without waiting for the rest of its second.
+	 * 			sleeper.wake();
+	 * 			worker.join();
+	 * @endcode
+	 */
+	class Sleeper {
+	public:
+		/**
+		 * @brief	Constructor for Sleeper.
+		 * @param	config	hybrid_sleep_config thresholds to use for the sleep, yield and spin phases.
+		 */
+		explicit Sleeper(const hybrid_sleep_config &config = hybrid_sleep_config{}) : config(config) {}
+
+		Sleeper(const Sleeper &) = delete;
+		Sleeper &operator=(const Sleeper &) = delete;
+
+		/**
+		 * @brief	Method sleep_until_ns sleeps until the specified absolute time in nanoseconds or until woken.
+		 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns.
+		 * @return	WakeReason Woken if a wake was pending or arrived before the deadline, otherwise Deadline.
+		 */
+		WakeReason sleep_until_ns(const uint64_t deadline_ns) {
+			return sleep_until_ns_on<clock_source::monotonic>(deadline_ns);
+		}
+
+		/**
+		 * @brief	Method sleep_until_ns_on sleeps until the specified absolute time of the chosen clock or until woken.
+		 * @param	deadline_ns	uint64_t time to wake up at, in the same time base as now_ns_on<ClockSource>.
+		 * @return	WakeReason Woken if a wake was pending or arrived before the deadline, otherwise Deadline.
+		 * @details	The futex only takes CLOCK_MONOTONIC timeouts, so for other clocks each blocking phase waits
+		 * 			for the time remaining on ClockSource and the clock is read again when it returns.
+		 */
+		template <typename ClockSource>
+		WakeReason sleep_until_ns_on(const uint64_t deadline_ns) {
+			while (true) {
+				if (consume_wake()) return WakeReason::Woken;
+				const uint64_t current_ns = ClockSource::now_ns();
+				if (current_ns >= deadline_ns) return WakeReason::Deadline;
+				const uint64_t remaining_ns = deadline_ns - current_ns;
+				// If there is more time remaining than the margin, block until the margin or a wake.
+				if (remaining_ns > config.sleep_margin_ns) {
+					if constexpr (std::is_same_v<ClockSource, clock_source::monotonic>) {
+						wait_until_ns(deadline_ns - config.sleep_margin_ns);
+					}
+					else {
+						wait_until_ns(now_ns() + (remaining_ns - config.sleep_margin_ns));
+					}
+				}
+				// Else if there is more time remaining than the spin threshold, give up the processor.
+				else if (remaining_ns > config.spin_threshold_ns) {
+					std::this_thread::yield();
+				}
+				// Otherwise we spin, checking for a wake between reads of the clock.
+				else {
+					cpu_relax();
+				}
+			}
+		}
+
+		/**
+		 * @brief	Method sleep_until sleeps until the specified std::chrono time point or until woken.
+		 * @param	deadline	std::chrono::time_point to wake up at.
+		 * @return	WakeReason why the sleep returned.
+		 */
+		template <typename Clock, typename Duration>
+		WakeReason sleep_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+			return sleep_until_ns(time_point_to_ns(deadline));
+		}
+
+		/**
+		 * @brief	Method sleep_for sleeps for the specified std::chrono duration or until woken.
+		 * @param	duration	std::chrono::duration to sleep for.
+		 * @return	WakeReason why the sleep returned.
+		 */
+		template <typename Rep, typename Period>
+		WakeReason sleep_for(const std::chrono::duration<Rep, Period> &duration) {
+			return sleep_until_ns(now_ns() + duration_to_ns(duration));
+		}
+
+		/**
+		 * @brief	Method sleep_for_on sleeps for the specified std::chrono duration of the chosen clock or until woken.
+		 * @param	duration	std::chrono::duration to sleep for.
+		 * @return	WakeReason why the sleep returned.
+		 */
+		template <typename ClockSource, typename Rep, typename Period>
+		WakeReason sleep_for_on(const std::chrono::duration<Rep, Period> &duration) {
+			return sleep_until_ns_on<ClockSource>(ClockSource::now_ns() + duration_to_ns(duration));
+		}
+
+		/**
+		 * @brief	Method wake ends the current sleep, or the next sleep if none is in progress.
+		 */
+		void wake() {
+			#ifdef __linux__
+			if (pending.exchange(1, std::memory_order_release) == 0) {
+				syscall(SYS_futex, reinterpret_cast<uint32_t *>(&pending), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX, nullptr, nullptr, 0);
+			}
+			#else
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				pending.store(1, std::memory_order_release);
+			}
+			condition.notify_all();
+			#endif /* __linux__ */
+		}
+
+		/**
+		 * @brief	Method is_wake_pending gets whether a wake has not yet been consumed by a sleep.
+		 * @return	bool true if the next sleep will return immediately.
+		 */
+		bool is_wake_pending() const {
+			return pending.load(std::memory_order_acquire) != 0;
+		}
+
+	private:
+		/**
+		 * @brief	Method consume_wake clears a pending wake.
+		 * @return	bool true if a wake was pending.
+		 */
+		bool consume_wake() {
+			return pending.load(std::memory_order_relaxed) != 0 && pending.exchange(0, std::memory_order_acquire) != 0;
+		}
+
+		/**
+		 * @brief	Method wait_until_ns blocks until the specified absolute time in nanoseconds, a wake, or a
+		 * 			spurious wakeup, whichever is first.
+		 * @param	wake_ns	uint64_t time to block until, in the same time base as now_ns.
+		 */
+		void wait_until_ns(const uint64_t wake_ns) {
+			#ifdef __linux__
+			// FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC timeout, the time base of now_ns.
+			struct timespec ts;
+			ts.tv_sec = wake_ns / 1'000'000'000;
+			ts.tv_nsec = wake_ns % 1'000'000'000;
+			syscall(SYS_futex, reinterpret_cast<uint32_t *>(&pending), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, 0, &ts, nullptr, FUTEX_BITSET_MATCH_ANY);
+			#else
+			const uint64_t current_ns = now_ns();
+			const auto timeout = std::chrono::nanoseconds(wake_ns > current_ns ? wake_ns - current_ns : 0);
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait_for(lock, timeout, [this]() { return pending.load(std::memory_order_relaxed) != 0; });
+			#endif /* __linux__ */
+		}
+
+		/// Thresholds used for the sleep, yield and spin phases.
+		hybrid_sleep_config config;
+		/// Word that is 1 while a wake is pending, and the futex the sleep blocks on.
+		std::atomic<uint32_t> pending{0};
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free, "the futex word must be a plain 32 bit integer");
+		#ifndef __linux__
+		/// Mutex protecting the condition variable wait.
+		std::mutex mutex;
+		/// Condition variable the sleep blocks on.
+		std::condition_variable condition;
+		#endif /* __linux__ */
+	};
+}
+
+#endif /* SLEEPER_HPP */
@@ -0,0 +1,267 @@
+/**
+ * @file 	timerfd_engine.hpp
+ * @brief 	timerfd_engine.hpp defines a Linux timer engine that multiplexes many deadlines onto a single
+ * 			pollable timerfd.
+ * @details	The TimerfdEngine class keeps its deadlines ordered by time and arms one CLOCK_MONOTONIC timerfd
+ * 			with the earliest of them as an absolute time. The file descriptor is exposed so it can be
+ * 			added to an existing epoll (or poll/select) set, and when it becomes readable the event loop
+ * 			calls dispatch to run every callback that is due. Deadlines share the time base of now_ns.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef TIMERFD_ENGINE_HPP
+#define TIMERFD_ENGINE_HPP
+
+#ifdef __linux__
+
+// C++ Standard Library Headers
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Platform Dependant System Libraries
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/**
+	 * @brief	Class TimerfdEngine multiplexes one-shot and periodic deadlines onto a single timerfd.
+	 * @details	Callbacks run on the thread that calls dispatch and are given the number of expirations
+	 * 			they cover, which is always 1 for one-shot timers and the number of elapsed periods for
+	 * 			periodic timers, mirroring the expiration count read from a timerfd. Timers may be scheduled
+	 * 			and cancelled from any thread, including from within callbacks.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::TimerfdEngine engine;
+	 * 			epoll_event event{EPOLLIN, {.ptr = &engine}};
+	 * 			epoll_ctl(epoll_fd, EPOLL_CTL_ADD, engine.fd(), &event);
+	 * 			engine.schedule_after_ns(250'000, [](uint64_t expirations) { on_timeout(); });
+	 * 			...
+	 * 			// In the event loop, when the engine's fd is readable:
+	 * 			engine.dispatch();
+	 * @endcode
+	 */
+	class TimerfdEngine {
+	public:
+		/// Callback type for a timer, given the number of expirations it covers.
+		using timer_callback = std::function<void(uint64_t expirations)>;
+
+		/**
+		 * @brief	Struct timer_handle identifies a scheduled timer so it can be cancelled.
+		 */
+		struct timer_handle {
+			/// Unique identifier of the timer.
+			uint64_t id = UINT64_MAX;
+		};
+
+		/**
+		 * @brief	Constructor for TimerfdEngine that creates the non-blocking timerfd.
+		 * @throws	std::system_error if the timerfd cannot be created.
+		 */
+		TimerfdEngine() {
+			timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+			if (timer_fd == -1) {
+				throw std::system_error(errno, std::generic_category(), "TimerfdEngine::TimerfdEngine: timerfd_create failed");
+			}
+		}
+
+		TimerfdEngine(const TimerfdEngine &) = delete;
+		TimerfdEngine &operator=(const TimerfdEngine &) = delete;
+
+		/**
+		 * @brief	Destructor for TimerfdEngine that closes the timerfd.
+		 */
+		~TimerfdEngine() {
+			close(timer_fd);
+		}
+
+		/**
+		 * @brief	Method fd gets the timerfd to register for readability in an event loop.
+		 * @return	int file descriptor of the timerfd.
+		 */
+		int fd() const {
+			return timer_fd;
+		}
+
+		/**
+		 * @brief	Method schedule_at_ns schedules a one-shot timer at an absolute time.
+		 * @param	deadline_ns	uint64_t time in the time base of now_ns at which to fire.
+		 * @param	callback	timer_callback to call when the timer fires.
+		 * @return	timer_handle handle that can be used to cancel the timer.
+		 */
+		timer_handle schedule_at_ns(const uint64_t deadline_ns, timer_callback callback) {
+			return schedule(deadline_ns, 0, std::move(callback));
+		}
+
+		/**
+		 * @brief	Method schedule_after_ns schedules a one-shot timer after a delay from now.
+		 * @param	delay_ns	uint64_t number of nanoseconds from now at which to fire.
+		 * @param	callback	timer_callback to call when the timer fires.
+		 * @return	timer_handle handle that can be used to cancel the timer.
+		 */
+		timer_handle schedule_after_ns(const uint64_t delay_ns, timer_callback callback) {
+			return schedule(now_ns() + delay_ns, 0, std::move(callback));
+		}
+
+		/**
+		 * @brief	Method schedule_every_ns schedules a periodic timer.
+		 * @param	first_deadline_ns	uint64_t time in the time base of now_ns of the first expiration.
+		 * @param	period_ns			uint64_t number of nanoseconds between expirations.
+		 * @param	callback			timer_callback to call each time the timer fires.
+		 * @return	timer_handle handle that can be used to cancel the timer. The handle stays valid as the
+		 * 			timer is re-armed.
+		 * @throws	std::invalid_argument if the period is zero.
+		 */
+		timer_handle schedule_every_ns(const uint64_t first_deadline_ns, const uint64_t period_ns, timer_callback callback) {
+			if (period_ns == 0) {
+				throw std::invalid_argument("TimerfdEngine::schedule_every_ns: period_ns must be greater than zero.");
+			}
+			return schedule(first_deadline_ns, period_ns, std::move(callback));
+		}
+
+		/**
+		 * @brief	Method cancel cancels a scheduled timer.
+		 * @param	handle	timer_handle returned when the timer was scheduled.
+		 * @return	bool true if the timer was cancelled, false if it had already fired or been cancelled.
+		 */
+		bool cancel(const timer_handle handle) {
+			std::lock_guard<std::mutex> lock(mutex);
+			auto id_iterator = deadlines_by_id.find(handle.id);
+			if (id_iterator == deadlines_by_id.end()) return false;
+			const bool was_earliest = timers.begin()->first == std::make_pair(id_iterator->second, handle.id);
+			timers.erase(std::make_pair(id_iterator->second, handle.id));
+			deadlines_by_id.erase(id_iterator);
+			if (was_earliest) arm();
+			return true;
+		}
+
+		/**
+		 * @brief	Method dispatch consumes the timerfd expiration count and runs every callback that is due.
+		 * @details	This method should be called whenever the timerfd is readable, and is harmless to call
+		 * 			when it is not. A single expiration of the timerfd can cover several deadlines, so the due
+		 * 			timers are found by comparing their deadlines against now_ns rather than by the count.
+		 * @return	size_t number of callbacks run.
+		 */
+		size_t dispatch() {
+			uint64_t fd_expirations = 0;
+			while (read(timer_fd, &fd_expirations, sizeof(fd_expirations)) == -1 && errno == EINTR);
+
+			// Collect the due timers under the lock, re-arming periodic ones, then run them without it.
+			std::vector<std::pair<timer_callback, uint64_t>> due;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				timerfd_expirations += fd_expirations;
+				const uint64_t current_ns = now_ns();
+				while (!timers.empty() && timers.begin()->first.first <= current_ns) {
+					auto node = timers.extract(timers.begin());
+					const uint64_t deadline_ns = node.key().first, id = node.key().second;
+					timer_entry &entry = node.mapped();
+					if (entry.period_ns == 0) {
+						deadlines_by_id.erase(id);
+						due.emplace_back(std::move(entry.callback), 1);
+					}
+					else {
+						// Count every period that has elapsed, and keep the schedule aligned to the first deadline.
+						const uint64_t expirations = (current_ns - deadline_ns) / entry.period_ns + 1;
+						due.emplace_back(entry.callback, expirations);
+						node.key().first = deadline_ns + expirations * entry.period_ns;
+						deadlines_by_id[id] = node.key().first;
+						timers.insert(std::move(node));
+					}
+				}
+				arm();
+			}
+
+			for (auto &[callback, expirations] : due) callback(expirations);
+			return due.size();
+		}
+
+		/**
+		 * @brief	Method size gets the number of scheduled timers.
+		 * @return	size_t number of scheduled timers.
+		 */
+		size_t size() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return timers.size();
+		}
+
+		/**
+		 * @brief	Method expirations gets the total expiration count read from the timerfd.
+		 * @return	uint64_t number of timerfd expirations consumed by dispatch.
+		 */
+		uint64_t expirations() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return timerfd_expirations;
+		}
+
+	private:
+		/**
+		 * @brief	Struct timer_entry holds the callback and period of a scheduled timer.
+		 */
+		struct timer_entry {
+			uint64_t period_ns;
+			timer_callback callback;
+		};
+
+		/**
+		 * @brief	Method schedule adds a timer and re-arms the timerfd if it is the new earliest deadline.
+		 * @param	deadline_ns	uint64_t first deadline of the timer.
+		 * @param	period_ns	uint64_t period of the timer, or zero for a one-shot timer.
+		 * @param	callback	timer_callback to call when the timer fires.
+		 * @return	timer_handle handle of the timer.
+		 */
+		timer_handle schedule(const uint64_t deadline_ns, const uint64_t period_ns, timer_callback callback) {
+			std::lock_guard<std::mutex> lock(mutex);
+			const uint64_t id = next_id++;
+			timers.emplace(std::make_pair(deadline_ns, id), timer_entry{period_ns, std::move(callback)});
+			deadlines_by_id.emplace(id, deadline_ns);
+			if (timers.begin()->first.second == id) arm();
+			return timer_handle{id};
+		}
+
+		/**
+		 * @brief	Method arm sets the timerfd to the earliest deadline as an absolute time, or disarms it.
+		 * @throws	std::system_error if the timerfd cannot be set.
+		 */
+		void arm() {
+			struct itimerspec spec{};
+			if (!timers.empty()) {
+				// A zero it_value disarms the timer, so deadlines at time zero are armed one nanosecond later.
+				const uint64_t deadline_ns = timers.begin()->first.first > 0 ? timers.begin()->first.first : 1;
+				spec.it_value.tv_sec = deadline_ns / 1'000'000'000;
+				spec.it_value.tv_nsec = deadline_ns % 1'000'000'000;
+			}
+			if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+				throw std::system_error(errno, std::generic_category(), "TimerfdEngine::arm: timerfd_settime failed");
+			}
+		}
+
+		/// File descriptor of the timerfd.
+		int timer_fd = -1;
+		/// Identifier to give the next scheduled timer.
+		uint64_t next_id = 0;
+		/// Total expiration count read from the timerfd.
+		uint64_t timerfd_expirations = 0;
+		/// Scheduled timers ordered by deadline, then by identifier.
+		std::map<std::pair<uint64_t, uint64_t>, timer_entry> timers;
+		/// Current deadline of each scheduled timer by identifier, so periodic timers can be cancelled.
+		std::unordered_map<uint64_t, uint64_t> deadlines_by_id;
+		/// Mutex protecting the timers.
+		mutable std::mutex mutex;
+	};
+}
+
+#endif /* __linux__ */
+
+#endif /* TIMERFD_ENGINE_HPP */
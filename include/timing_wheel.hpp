@@ -0,0 +1,530 @@
+/**
+ * @file 	timing_wheel.hpp
+ * @brief 	timing_wheel.hpp defines a hierarchical timing wheel for managing large numbers of one-shot
+ * 			timers from a single service thread.
+ * @details	The TimingWheel class stores timers in four levels of 256 slots each, where every level covers
+ * 			256 times the range of the level below it. Inserting and cancelling a timer is O(1), and timers
+ * 			are moved down a level at a time as their expiry approaches. Timer nodes live in a pool that
+ * 			is allocated once at construction and are linked into the slots by index, so scheduling a
+ * 			timer never allocates. Occupancy bitmaps let the wheel skip over empty slots, so the service
+ * 			thread only wakes up when a slot actually has timers in it, and uses the precise sleep
+ * 			functions to reach it.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+// C++ Standard Library Headers
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Platform Dependant System Libraries
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif /* _MSC_VER */
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/// Number of levels in the timing wheel.
+	const static uint32_t timing_wheel_levels = 4;
+	/// Number of bits of the tick count indexed by each level of the timing wheel.
+	const static uint32_t timing_wheel_slot_bits = 8;
+	/// Number of slots in each level of the timing wheel.
+	const static uint32_t timing_wheel_slots = 1 << timing_wheel_slot_bits;
+	/// Number of nanoseconds before a deadline at which the service thread stops waiting on its condition variable.
+	const static uint64_t timing_wheel_wake_margin_ns = 200'000;
+
+	/**
+	 * @brief	Class TimingWheel manages one-shot timers in a hierarchical timing wheel.
+	 * @details	Timers are scheduled with a callback and a context pointer and fire on the thread that
+	 * 			advances the wheel, either the service thread started with start or any thread calling
+	 * 			advance_to_ns. All methods may be called concurrently, and callbacks may schedule or cancel
+	 * 			other timers.
+	 * @code 	{.cpp}
+	 * 			high_resolution_sleep::TimingWheel wheel(100'000);
+	 * 			wheel.start();
+	 * 			auto handle = wheel.schedule_after_ns(250'000, [](void *context) { on_timeout(context); }, request);
+	 * 			...
+	 * 			wheel.cancel(handle);
+	 * @endcode
+	 */
+	class TimingWheel {
+	public:
+		/// Callback type for a timer, given the context pointer it was scheduled with.
+		using timer_callback = void (*)(void *context);
+
+		/**
+		 * @brief	Struct timer_handle identifies a scheduled timer so it can be cancelled.
+		 */
+		struct timer_handle {
+			/// Index of the timer node in the pool.
+			uint32_t index = UINT32_MAX;
+			/// Generation of the timer node when it was scheduled, so stale handles are ignored.
+			uint32_t generation = 0;
+		};
+
+		/**
+		 * @brief	Constructor for TimingWheel that allocates the timer pool.
+		 * @param	capacity	size_t maximum number of timers that can be scheduled at once.
+		 * @param	tick_ns		uint64_t granularity of the wheel in nanoseconds.
+		 * @throws	std::invalid_argument if the capacity or tick is zero.
+		 */
+		explicit TimingWheel(const size_t capacity, const uint64_t tick_ns = 1'000) : tick_ns(tick_ns), nodes(checked_capacity(capacity)) {
+			if (tick_ns == 0) {
+				throw std::invalid_argument("TimingWheel::TimingWheel: tick_ns must be greater than zero.");
+			}
+			for (uint32_t level = 0; level <= timing_wheel_levels; level++) {
+				for (uint32_t slot = 0; slot < timing_wheel_slots; slot++) heads[level][slot] = tails[level][slot] = UINT32_MAX;
+			}
+			// Thread every node onto the free list.
+			for (uint32_t i = 0; i < capacity; i++) nodes[i].next = i + 1 < capacity ? i + 1 : UINT32_MAX;
+			free_head = 0;
+			origin_ns = now_ns();
+		}
+
+		TimingWheel(const TimingWheel &) = delete;
+		TimingWheel &operator=(const TimingWheel &) = delete;
+
+		/**
+		 * @brief	Destructor for TimingWheel that stops the service thread if it is running.
+		 */
+		~TimingWheel() {
+			stop();
+		}
+
+		/**
+		 * @brief	Method schedule_at_ns schedules a timer to fire at an absolute time.
+		 * @param	deadline_ns	uint64_t time in the time base of now_ns at which to fire, rounded up to a tick.
+		 * @param	callback	timer_callback to call when the timer fires.
+		 * @param	context		void* pointer passed to the callback.
+		 * @return	timer_handle handle that can be used to cancel the timer.
+		 * @throws	std::length_error if every timer in the pool is already scheduled.
+		 */
+		timer_handle schedule_at_ns(const uint64_t deadline_ns, timer_callback callback, void *context) {
+			// Round up so that timers never fire early.
+			uint64_t expiry_tick = deadline_ns > origin_ns ? (deadline_ns - origin_ns + tick_ns - 1) / tick_ns : 0;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (free_head == UINT32_MAX) {
+				throw std::length_error("TimingWheel::schedule_at_ns: the timer pool is exhausted.");
+			}
+			uint32_t index = free_head;
+			timer_node &node = nodes[index];
+			free_head = node.next;
+
+			node.expiry_tick = expiry_tick > current_tick ? expiry_tick : current_tick + 1;
+			node.callback = callback;
+			node.context = context;
+			node.state = node_state::scheduled;
+			link(index);
+			scheduled_count++;
+
+			// Wake the service thread if this timer is due before what it is currently waiting for.
+			if (node.expiry_tick < service_tick) {
+				service_tick = node.expiry_tick;
+				wakeup.notify_one();
+			}
+			return timer_handle{index, node.generation};
+		}
+
+		/**
+		 * @brief	Method schedule_after_ns schedules a timer to fire after a delay from now.
+		 * @param	delay_ns	uint64_t number of nanoseconds from now at which to fire.
+		 * @param	callback	timer_callback to call when the timer fires.
+		 * @param	context		void* pointer passed to the callback.
+		 * @return	timer_handle handle that can be used to cancel the timer.
+		 * @throws	std::length_error if every timer in the pool is already scheduled.
+		 */
+		timer_handle schedule_after_ns(const uint64_t delay_ns, timer_callback callback, void *context) {
+			return schedule_at_ns(now_ns() + delay_ns, callback, context);
+		}
+
+		/**
+		 * @brief	Method cancel cancels a scheduled timer.
+		 * @param	handle	timer_handle returned when the timer was scheduled.
+		 * @return	bool true if the timer was cancelled, false if it has already fired or been cancelled.
+		 */
+		bool cancel(const timer_handle handle) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (handle.index >= nodes.size()) return false;
+			timer_node &node = nodes[handle.index];
+			if (node.generation != handle.generation || node.state != node_state::scheduled) return false;
+			unlink(handle.index);
+			release(handle.index);
+			scheduled_count--;
+			return true;
+		}
+
+		/**
+		 * @brief	Method advance_to_ns fires every timer that is due at or before the specified time on the
+		 * 			calling thread.
+		 * @param	time_ns	uint64_t time in the time base of now_ns to advance the wheel to.
+		 * @return	size_t number of timers fired.
+		 */
+		size_t advance_to_ns(const uint64_t time_ns) {
+			const uint64_t target_tick = time_ns > origin_ns ? (time_ns - origin_ns) / tick_ns : 0;
+			uint32_t expired_head = UINT32_MAX, expired_tail = UINT32_MAX;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				// Jump between the ticks that have work to do, cascading and expiring slots along the way.
+				while (current_tick < target_tick) {
+					uint64_t next_tick = next_event_tick();
+					if (next_tick > target_tick) {
+						current_tick = target_tick;
+						break;
+					}
+					current_tick = next_tick;
+					process_tick(expired_head, expired_tail);
+				}
+			}
+
+			// Fire the expired timers in the order they expired, and in the order they were scheduled within
+			// a tick, without holding the lock, then return their nodes to the pool.
+			size_t fired = 0;
+			for (uint32_t index = expired_head; index != UINT32_MAX; index = nodes[index].next) {
+				nodes[index].callback(nodes[index].context);
+				fired++;
+			}
+			if (fired > 0) {
+				std::lock_guard<std::mutex> lock(mutex);
+				uint32_t index = expired_head;
+				while (index != UINT32_MAX) {
+					uint32_t next = nodes[index].next;
+					release(index);
+					index = next;
+				}
+			}
+			return fired;
+		}
+
+		/**
+		 * @brief	Method start starts the service thread that fires timers as they become due.
+		 */
+		void start() {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (service_thread.joinable()) return;
+			stopping = false;
+			service_thread = std::thread([this]() { service(); });
+		}
+
+		/**
+		 * @brief	Method stop stops the service thread and waits for it to exit. Scheduled timers are kept.
+		 */
+		void stop() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!service_thread.joinable()) return;
+				stopping = true;
+				wakeup.notify_one();
+			}
+			service_thread.join();
+		}
+
+		/**
+		 * @brief	Method size gets the number of timers that are scheduled and have not fired.
+		 * @return	size_t number of scheduled timers.
+		 */
+		size_t size() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return scheduled_count;
+		}
+
+		/**
+		 * @brief	Method capacity gets the maximum number of timers that can be scheduled at once.
+		 * @return	size_t size of the timer pool.
+		 */
+		size_t capacity() const {
+			return nodes.size();
+		}
+
+		/**
+		 * @brief	Method next_deadline_ns gets the time at which the wheel next needs to be advanced.
+		 * @return	uint64_t time in the time base of now_ns, or UINT64_MAX if no timers are scheduled.
+		 */
+		uint64_t next_deadline_ns() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			uint64_t next_tick = next_event_tick();
+			return next_tick == UINT64_MAX ? UINT64_MAX : origin_ns + next_tick * tick_ns;
+		}
+
+	private:
+		/**
+		 * @brief	Enum node_state tracks where a timer node is in its lifecycle.
+		 */
+		enum class node_state : uint8_t {
+			free,
+			scheduled,
+			firing
+		};
+
+		/**
+		 * @brief	Struct timer_node is an intrusive, doubly linked timer stored in the pool.
+		 */
+		struct timer_node {
+			uint64_t expiry_tick = 0;
+			timer_callback callback = nullptr;
+			void *context = nullptr;
+			uint32_t next = UINT32_MAX;
+			uint32_t prev = UINT32_MAX;
+			uint32_t generation = 0;
+			uint8_t level = 0;
+			uint8_t slot = 0;
+			node_state state = node_state::free;
+		};
+
+		/**
+		 * @brief	Function lowest_set_bit gets the index of the lowest set bit of a non-zero word.
+		 * @param	word	uint64_t non-zero word.
+		 * @return	uint32_t index of the lowest set bit.
+		 */
+		static uint32_t lowest_set_bit(const uint64_t word) {
+			#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward64(&index, word);
+			return index;
+			#else
+			return __builtin_ctzll(word);
+			#endif /* _MSC_VER */
+		}
+
+		/**
+		 * @brief	Method checked_capacity validates the capacity of the timer pool before it is allocated.
+		 * @param	capacity	size_t maximum number of timers that can be scheduled at once.
+		 * @return	size_t the capacity.
+		 * @throws	std::invalid_argument if the capacity is zero or too large to be indexed.
+		 */
+		static size_t checked_capacity(const size_t capacity) {
+			if (capacity == 0 || capacity >= UINT32_MAX) {
+				throw std::invalid_argument("TimingWheel::TimingWheel: capacity must be between 1 and UINT32_MAX.");
+			}
+			return capacity;
+		}
+
+		/**
+		 * @brief	Method digit gets the slot index of a tick at a level of the wheel.
+		 * @param	tick	uint64_t tick count.
+		 * @param	level	uint32_t level of the wheel.
+		 * @return	uint32_t slot index.
+		 */
+		static uint32_t digit(const uint64_t tick, const uint32_t level) {
+			return (tick >> (level * timing_wheel_slot_bits)) & (timing_wheel_slots - 1);
+		}
+
+		/**
+		 * @brief	Method link inserts a node into the slot for its expiry relative to the current tick.
+		 * @param	index	uint32_t index of the node.
+		 */
+		void link(const uint32_t index) {
+			timer_node &node = nodes[index];
+			// The node goes in the highest level at which its expiry differs from the current tick, and
+			// timers beyond the range of the top level go in the overflow list.
+			uint32_t level = 0, slot = 0;
+			const uint64_t differing = node.expiry_tick ^ current_tick;
+			for (level = timing_wheel_levels; level > 0; level--) {
+				if (differing >> ((level - 1) * timing_wheel_slot_bits + timing_wheel_slot_bits)) break;
+			}
+			if (level < timing_wheel_levels) slot = digit(node.expiry_tick, level);
+
+			node.level = static_cast<uint8_t>(level);
+			node.slot = static_cast<uint8_t>(slot);
+			// Append to the slot so that timers of the same tick keep the order they were scheduled in.
+			node.next = UINT32_MAX;
+			node.prev = tails[level][slot];
+			if (node.prev != UINT32_MAX) nodes[node.prev].next = index;
+			else heads[level][slot] = index;
+			tails[level][slot] = index;
+			if (level < timing_wheel_levels) occupied[level][slot / 64] |= uint64_t(1) << (slot % 64);
+		}
+
+		/**
+		 * @brief	Method unlink removes a node from its slot.
+		 * @param	index	uint32_t index of the node.
+		 */
+		void unlink(const uint32_t index) {
+			timer_node &node = nodes[index];
+			if (node.prev != UINT32_MAX) nodes[node.prev].next = node.next;
+			else heads[node.level][node.slot] = node.next;
+			if (node.next != UINT32_MAX) nodes[node.next].prev = node.prev;
+			else tails[node.level][node.slot] = node.prev;
+			if (node.level < timing_wheel_levels && heads[node.level][node.slot] == UINT32_MAX) {
+				occupied[node.level][node.slot / 64] &= ~(uint64_t(1) << (node.slot % 64));
+			}
+		}
+
+		/**
+		 * @brief	Method release returns a node to the free list, invalidating its handles.
+		 * @param	index	uint32_t index of the node.
+		 */
+		void release(const uint32_t index) {
+			timer_node &node = nodes[index];
+			node.state = node_state::free;
+			node.generation++;
+			node.next = free_head;
+			free_head = index;
+		}
+
+		/**
+		 * @brief	Method next_occupied_slot finds the first occupied slot after a slot in a level.
+		 * @param	level	uint32_t level of the wheel.
+		 * @param	slot	uint32_t slot to search after.
+		 * @return	uint32_t index of the next occupied slot, or timing_wheel_slots if there is none.
+		 */
+		uint32_t next_occupied_slot(const uint32_t level, const uint32_t slot) const {
+			uint32_t start = slot + 1;
+			for (uint32_t word = start / 64; word < timing_wheel_slots / 64; word++) {
+				uint64_t bits = occupied[level][word];
+				if (word == start / 64) bits &= start % 64 == 0 ? ~uint64_t(0) : ~((uint64_t(1) << (start % 64)) - 1);
+				if (bits) return word * 64 + lowest_set_bit(bits);
+			}
+			return timing_wheel_slots;
+		}
+
+		/**
+		 * @brief	Method next_event_tick finds the next tick after the current one at which a slot needs to
+		 * 			be expired or cascaded.
+		 * @return	uint64_t next tick with work to do, or UINT64_MAX if no timers are scheduled.
+		 */
+		uint64_t next_event_tick() const {
+			for (uint32_t level = 0; level < timing_wheel_levels; level++) {
+				uint32_t slot = next_occupied_slot(level, digit(current_tick, level));
+				if (slot < timing_wheel_slots) {
+					const uint32_t shift = level * timing_wheel_slot_bits;
+					return ((current_tick >> (shift + timing_wheel_slot_bits)) << (shift + timing_wheel_slot_bits)) + (uint64_t(slot) << shift);
+				}
+			}
+			// The overflow list is redistributed when the top level wraps around.
+			if (heads[timing_wheel_levels][0] != UINT32_MAX) {
+				const uint32_t shift = timing_wheel_levels * timing_wheel_slot_bits;
+				return ((current_tick >> shift) + 1) << shift;
+			}
+			return UINT64_MAX;
+		}
+
+		/**
+		 * @brief	Method process_tick cascades the slots that start at the current tick down a level and
+		 * 			moves the timers that expire at it onto the expired list.
+		 * @param	expired_head	uint32_t& head of the list of expired nodes.
+		 * @param	expired_tail	uint32_t& tail of the list of expired nodes.
+		 */
+		void process_tick(uint32_t &expired_head, uint32_t &expired_tail) {
+			// Cascade from the highest level down, so timers can fall through several levels in one tick.
+			for (uint32_t level = timing_wheel_levels; level > 0; level--) {
+				const uint32_t shift = (level - 1) * timing_wheel_slot_bits + timing_wheel_slot_bits;
+				if ((current_tick & ((uint64_t(1) << shift) - 1)) != 0) continue;
+				const uint32_t slot = level < timing_wheel_levels ? digit(current_tick, level) : 0;
+				uint32_t index = heads[level][slot];
+				heads[level][slot] = tails[level][slot] = UINT32_MAX;
+				if (level < timing_wheel_levels) occupied[level][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+				while (index != UINT32_MAX) {
+					uint32_t next = nodes[index].next;
+					if (nodes[index].expiry_tick <= current_tick) expire(index, expired_head, expired_tail);
+					else link(index);
+					index = next;
+				}
+			}
+
+			// Expire every timer in the level 0 slot of the current tick.
+			const uint32_t slot = digit(current_tick, 0);
+			uint32_t index = heads[0][slot];
+			heads[0][slot] = tails[0][slot] = UINT32_MAX;
+			occupied[0][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+			while (index != UINT32_MAX) {
+				uint32_t next = nodes[index].next;
+				expire(index, expired_head, expired_tail);
+				index = next;
+			}
+		}
+
+		/**
+		 * @brief	Method expire appends a node that has been removed from its slot to the expired list.
+		 * @param	index			uint32_t index of the node.
+		 * @param	expired_head	uint32_t& head of the list of expired nodes.
+		 * @param	expired_tail	uint32_t& tail of the list of expired nodes.
+		 */
+		void expire(const uint32_t index, uint32_t &expired_head, uint32_t &expired_tail) {
+			nodes[index].state = node_state::firing;
+			nodes[index].next = UINT32_MAX;
+			if (expired_tail != UINT32_MAX) nodes[expired_tail].next = index;
+			else expired_head = index;
+			expired_tail = index;
+			scheduled_count--;
+		}
+
+		/**
+		 * @brief	Method service runs the service thread, sleeping until the next tick with work to do.
+		 */
+		void service() {
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!stopping) {
+				uint64_t next_tick = next_event_tick();
+				service_tick = next_tick;
+				if (next_tick == UINT64_MAX) {
+					wakeup.wait(lock);
+					continue;
+				}
+
+				// Wait on the condition variable for most of the interval, so that earlier timers and stop
+				// requests can wake the thread, then sleep precisely for the rest.
+				const uint64_t deadline_ns = origin_ns + next_tick * tick_ns;
+				const uint64_t current_ns = now_ns();
+				if (deadline_ns > current_ns + timing_wheel_wake_margin_ns) {
+					wakeup.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::nanoseconds(deadline_ns - current_ns - timing_wheel_wake_margin_ns));
+					continue;
+				}
+
+				lock.unlock();
+				#ifndef _WIN32
+				sleep_until_ns_hybrid(deadline_ns, hybrid_sleep_config{});
+				#else
+				sleep_until_ns(deadline_ns);
+				#endif /* _WIN32 */
+				advance_to_ns(now_ns());
+				lock.lock();
+			}
+			service_tick = UINT64_MAX;
+		}
+
+		/// Number of nanoseconds per tick.
+		const uint64_t tick_ns;
+		/// Time in the time base of now_ns of tick zero.
+		uint64_t origin_ns;
+		/// Tick up to which the wheel has been processed.
+		uint64_t current_tick = 0;
+		/// Pool of timer nodes.
+		std::vector<timer_node> nodes;
+		/// Index of the first free node in the pool.
+		uint32_t free_head = UINT32_MAX;
+		/// Number of timers that are scheduled and have not fired.
+		size_t scheduled_count = 0;
+		/// Heads of the slot lists for each level, with the last level holding the overflow list.
+		uint32_t heads[timing_wheel_levels + 1][timing_wheel_slots];
+		/// Tails of the slot lists for each level, so that timers are appended in the order they are scheduled.
+		uint32_t tails[timing_wheel_levels + 1][timing_wheel_slots];
+		/// Occupancy bitmaps of the slots in each level.
+		uint64_t occupied[timing_wheel_levels][timing_wheel_slots / 64] = {};
+		/// Mutex protecting the wheel.
+		mutable std::mutex mutex;
+		/// Condition variable used to wake the service thread early.
+		std::condition_variable wakeup;
+		/// Tick the service thread is currently waiting for.
+		uint64_t service_tick = UINT64_MAX;
+		/// Flag for if the service thread has been asked to stop.
+		bool stopping = false;
+		/// Service thread that advances the wheel.
+		std::thread service_thread;
+	};
+}
+
+#endif /* TIMING_WHEEL_HPP */
@@ -0,0 +1,345 @@
+/**
+ * @file 	tsc_clock.hpp
+ * @brief 	tsc_clock.hpp defines an opt-in clock that reads the processor time stamp counter and converts
+ * 			it to nanoseconds in the time base of now_ns.
+ * @details	On x86-64 processors with an invariant time stamp counter, now_ns_fast reads the counter with
+ * 			rdtscp and converts it to nanoseconds with a fixed-point multiply and shift instead of calling
+ * 			into the operating system. The conversion is calibrated against now_ns when the clock is first
+ * 			used, and is re-anchored against now_ns at a fixed interval so that it does not drift away from
+ * 			it. Re-anchoring slews the rate rather than stepping the time, so the clock stays monotonic.
+ * 			When the counter is not available or not invariant, now_ns_fast falls back to now_ns. The
+ * 			calibration is compiled into the sleep library when HIGH_RESOLUTION_SLEEP_COMPILED is defined.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+#ifndef TSC_CLOCK_HPP
+#define TSC_CLOCK_HPP
+
+// C++ Standard Library Headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Platform Dependant System Libraries
+#if defined(__x86_64__) || defined(_M_X64)
+	#define HIGH_RESOLUTION_SLEEP_HAS_TSC
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+		#include <x86intrin.h>
+	#endif /* _MSC_VER */
+#endif /* __x86_64__ || _M_X64 */
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+
+namespace high_resolution_sleep {
+	/**************************************************************************************************/
+	/* TSC Constants and Helpers 																	  */
+	/**************************************************************************************************/
+	/// Number of nanoseconds over which the TSC frequency is measured on the first calibration.
+	const static uint64_t tsc_calibration_time_ns = 10'000'000;
+	/// Number of nanoseconds between re-anchoring the TSC conversion against now_ns.
+	const static uint64_t tsc_recalibration_interval_ns = 100'000'000;
+	/// Number of fractional bits in the fixed-point nanoseconds per tick multiplier.
+	const static uint32_t tsc_multiplier_shift = 32;
+
+	/**
+	 * @brief	Function tsc_is_invariant checks whether the processor has an invariant time stamp counter.
+	 * @return	bool true if the counter ticks at a constant rate across frequency and power state changes.
+	 */
+	inline bool tsc_is_invariant() {
+		#ifdef HIGH_RESOLUTION_SLEEP_HAS_TSC
+		// The invariant TSC flag is bit 8 of EDX in the advanced power management leaf.
+		#ifdef _MSC_VER
+		int registers[4];
+		__cpuid(registers, 0x80000000);
+		if (static_cast<unsigned int>(registers[0]) < 0x80000007) return false;
+		__cpuid(registers, 0x80000007);
+		return (registers[3] & (1 << 8)) != 0;
+		#else
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) return false;
+		__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+		return (edx & (1 << 8)) != 0;
+		#endif /* _MSC_VER */
+		#else
+		return false;
+		#endif /* HIGH_RESOLUTION_SLEEP_HAS_TSC */
+	}
+
+	/**
+	 * @brief	Function read_tsc reads the time stamp counter after all preceding instructions have executed.
+	 * @return	uint64_t current value of the time stamp counter, or zero if there is no counter.
+	 */
+	inline uint64_t read_tsc() {
+		#ifdef HIGH_RESOLUTION_SLEEP_HAS_TSC
+		unsigned int aux;
+		return __rdtscp(&aux);
+		#else
+		return 0;
+		#endif /* HIGH_RESOLUTION_SLEEP_HAS_TSC */
+	}
+
+	/**
+	 * @brief	Function tsc_scale multiplies a tick count by a fixed-point multiplier and removes the fraction.
+	 * @param	ticks		uint64_t number of time stamp counter ticks.
+	 * @param	multiplier	uint64_t nanoseconds per tick with tsc_multiplier_shift fractional bits.
+	 * @return	uint64_t number of nanoseconds.
+	 */
+	inline uint64_t tsc_scale(const uint64_t ticks, const uint64_t multiplier) {
+		#if defined(_MSC_VER) && defined(HIGH_RESOLUTION_SLEEP_HAS_TSC)
+		uint64_t high;
+		uint64_t low = _umul128(ticks, multiplier, &high);
+		return __shiftright128(low, high, tsc_multiplier_shift);
+		#elif defined(__SIZEOF_INT128__)
+		// __extension__ keeps the 128 bit integer from warning under -Wpedantic.
+		__extension__ typedef unsigned __int128 uint128;
+		return static_cast<uint64_t>((static_cast<uint128>(ticks) * multiplier) >> tsc_multiplier_shift);
+		#else
+		// Multiply the 32 bit halves, keeping the bits of the product above the shift.
+		const uint64_t ticks_low = ticks & 0xFFFFFFFF, ticks_high = ticks >> 32;
+		const uint64_t multiplier_low = multiplier & 0xFFFFFFFF, multiplier_high = multiplier >> 32;
+		const uint64_t low_low = ticks_low * multiplier_low;
+		const uint64_t middle = (low_low >> 32) + (ticks_high * multiplier_low & 0xFFFFFFFF) + (ticks_low * multiplier_high & 0xFFFFFFFF);
+		const uint64_t high = ticks_high * multiplier_high + (ticks_high * multiplier_low >> 32) + (ticks_low * multiplier_high >> 32) + (middle >> 32);
+		const uint64_t low = (middle << 32) | (low_low & 0xFFFFFFFF);
+		return (high << (64 - tsc_multiplier_shift)) | (low >> tsc_multiplier_shift);
+		#endif /* _MSC_VER */
+	}
+
+	/**************************************************************************************************/
+	/* TSC Clock State 																				  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Class tsc_clock_state holds the calibration of the time stamp counter against now_ns.
+	 * @details	Readers use a sequence lock to get a consistent anchor and multiplier without blocking. The
+	 * 			first reader to notice that the anchor is older than tsc_recalibration_interval_ns
+	 * 			re-anchors it while the others keep using the previous values. The multiplier is slewed to
+	 * 			remove the error against now_ns over one interval, so ticks past the end of that interval,
+	 * 			such as the first read after the clock has been idle, are converted at the measured rate.
+	 */
+	class tsc_clock_state {
+	public:
+		/**
+		 * @brief	Method instance gets the process wide TSC clock state, calibrating it on first use.
+		 * @return	tsc_clock_state& calibrated state.
+		 */
+		static tsc_clock_state &instance() {
+			static tsc_clock_state state;
+			return state;
+		}
+
+		/**
+		 * @brief	Method available gets whether the TSC is being used, or now_ns_fast falls back to now_ns.
+		 * @return	bool true if the TSC is invariant and has been calibrated.
+		 */
+		bool available() const {
+			return tsc_available;
+		}
+
+		/**
+		 * @brief	Method frequency_hz gets the measured frequency of the time stamp counter.
+		 * @return	double number of ticks per second.
+		 */
+		double frequency_hz() const {
+			return ticks_per_ns.load(std::memory_order_relaxed) * 1e9;
+		}
+
+		/**
+		 * @brief	Method now_ns converts the current time stamp counter value to nanoseconds.
+		 * @return	uint64_t current time in the time base of now_ns.
+		 */
+		uint64_t now_ns() {
+			for (bool recalibrated = false; ; recalibrated = true) {
+				uint64_t sequence, anchor_tsc, anchor_ns, multiplier, base_multiplier, interval_ticks, tsc;
+				do {
+					sequence = this->sequence.load(std::memory_order_acquire);
+					anchor_tsc = this->anchor_tsc.load(std::memory_order_relaxed);
+					anchor_ns = this->anchor_ns.load(std::memory_order_relaxed);
+					multiplier = this->multiplier.load(std::memory_order_relaxed);
+					base_multiplier = this->base_multiplier.load(std::memory_order_relaxed);
+					interval_ticks = recalibration_ticks.load(std::memory_order_relaxed);
+					// Read the counter inside the sequence so it is never newer than a concurrent re-anchor.
+					tsc = read_tsc();
+					std::atomic_thread_fence(std::memory_order_acquire);
+				} while ((sequence & 1) || sequence != this->sequence.load(std::memory_order_relaxed));
+
+				// A counter read on another core can be marginally behind the anchor, treat it as the anchor.
+				uint64_t ticks = tsc > anchor_tsc ? tsc - anchor_tsc : 0;
+				if (recalibrated || ticks <= interval_ticks) return anchor_ns + convert(ticks, multiplier, base_multiplier, interval_ticks);
+				// Read again once re-anchored, so the time returned is converted from the new anchor.
+				recalibrate(anchor_tsc);
+			}
+		}
+
+	private:
+		/**
+		 * @brief	Constructor for tsc_clock_state that checks for an invariant TSC and measures its frequency.
+		 */
+		tsc_clock_state();
+
+		/**
+		 * @brief	Method convert converts a number of ticks after the anchor to nanoseconds, using the slewed
+		 * 			multiplier for the interval it was chosen for and the measured rate after it.
+		 * @param	ticks			uint64_t number of counter ticks after the anchor.
+		 * @param	multiplier		uint64_t slewed multiplier of the anchor.
+		 * @param	base_multiplier	uint64_t multiplier of the measured frequency.
+		 * @param	interval_ticks	uint64_t number of ticks the slewed multiplier applies to.
+		 * @return	uint64_t number of nanoseconds after the anchor.
+		 */
+		static uint64_t convert(const uint64_t ticks, const uint64_t multiplier, const uint64_t base_multiplier, const uint64_t interval_ticks) {
+			if (ticks <= interval_ticks) return tsc_scale(ticks, multiplier);
+			return tsc_scale(interval_ticks, multiplier) + tsc_scale(ticks - interval_ticks, base_multiplier);
+		}
+
+		/**
+		 * @brief	Method recalibrate re-anchors the conversion at the current counter value, refining the
+		 * 			frequency and slewing out any error relative to now_ns over the next interval.
+		 * @param	anchor_tsc	uint64_t counter value of the anchor the reader used, so that an anchor
+		 * 						already replaced by another reader is not replaced again.
+		 */
+		void recalibrate(const uint64_t anchor_tsc);
+
+		/// Flag for if the TSC is invariant and calibrated.
+		bool tsc_available = false;
+		/// Counter value at the start of the first calibration.
+		uint64_t start_tsc = 0;
+		/// Time at the start of the first calibration.
+		uint64_t start_ns = 0;
+		/// Measured number of counter ticks per nanosecond.
+		std::atomic<double> ticks_per_ns{0.0};
+		/// Number of counter ticks after the anchor at which the conversion is re-anchored.
+		std::atomic<uint64_t> recalibration_ticks{UINT64_MAX};
+		/// Sequence number of the anchor, odd while the anchor is being updated.
+		std::atomic<uint64_t> sequence{0};
+		/// Counter value at the anchor.
+		std::atomic<uint64_t> anchor_tsc{0};
+		/// Time at the anchor.
+		std::atomic<uint64_t> anchor_ns{0};
+		/// Nanoseconds per tick with tsc_multiplier_shift fractional bits, slewed over the interval after the anchor.
+		std::atomic<uint64_t> multiplier{0};
+		/// Nanoseconds per tick of the measured frequency with tsc_multiplier_shift fractional bits.
+		std::atomic<uint64_t> base_multiplier{0};
+		/// Flag held by the thread that is re-anchoring the conversion.
+		std::atomic_flag recalibrating = ATOMIC_FLAG_INIT;
+	};
+
+	/**************************************************************************************************/
+	/* TSC Clock State Calibration 																	  */
+	/**************************************************************************************************/
+	#ifdef HIGH_RESOLUTION_SLEEP_DEFINE_COLD
+	HIGH_RESOLUTION_SLEEP_COLD tsc_clock_state::tsc_clock_state() {
+		tsc_available = tsc_is_invariant();
+		if (!tsc_available) return;
+
+		// Measure the frequency of the counter over the calibration time against now_ns.
+		start_tsc = read_tsc();
+		start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_until_ns(start_ns + tsc_calibration_time_ns);
+		uint64_t end_tsc = read_tsc();
+		uint64_t end_ns = high_resolution_sleep::now_ns();
+		if (end_tsc <= start_tsc || end_ns <= start_ns) {
+			tsc_available = false;
+			return;
+		}
+
+		double ticks_per_ns = static_cast<double>(end_tsc - start_tsc) / static_cast<double>(end_ns - start_ns);
+		this->ticks_per_ns.store(ticks_per_ns, std::memory_order_relaxed);
+		recalibration_ticks.store(static_cast<uint64_t>(tsc_recalibration_interval_ns * ticks_per_ns), std::memory_order_relaxed);
+		anchor_tsc.store(end_tsc, std::memory_order_relaxed);
+		anchor_ns.store(end_ns, std::memory_order_relaxed);
+		multiplier.store(static_cast<uint64_t>(static_cast<double>(uint64_t(1) << tsc_multiplier_shift) / ticks_per_ns), std::memory_order_relaxed);
+		base_multiplier.store(multiplier.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		sequence.store(0, std::memory_order_release);
+	}
+
+	HIGH_RESOLUTION_SLEEP_COLD void tsc_clock_state::recalibrate(const uint64_t anchor_tsc) {
+		// Only one thread recalibrates, the others continue with the current anchor.
+		if (recalibrating.test_and_set(std::memory_order_acquire)) return;
+		if (this->anchor_tsc.load(std::memory_order_relaxed) != anchor_tsc) {
+			recalibrating.clear(std::memory_order_release);
+			return;
+		}
+
+		// Readers wait while the sequence is odd, so no reader can see a counter value newer than the new anchor.
+		sequence.fetch_add(1, std::memory_order_acq_rel);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		uint64_t current_tsc = read_tsc();
+		uint64_t current_ns = high_resolution_sleep::now_ns();
+		// Continue from where the current conversion is so that the clock never steps backwards.
+		uint64_t estimated_ns = anchor_ns.load(std::memory_order_relaxed) + convert(current_tsc - anchor_tsc, multiplier.load(std::memory_order_relaxed),
+			base_multiplier.load(std::memory_order_relaxed), recalibration_ticks.load(std::memory_order_relaxed));
+
+		// Refine the frequency using the longest baseline available.
+		double ticks_per_ns = static_cast<double>(current_tsc - start_tsc) / static_cast<double>(current_ns - start_ns);
+		uint64_t interval_ticks = static_cast<uint64_t>(tsc_recalibration_interval_ns * ticks_per_ns);
+
+		// Choose the rate that brings the estimate back onto now_ns by the end of the next interval,
+		// limiting the correction to half the interval so the rate always stays positive.
+		int64_t offset_ns = static_cast<int64_t>(current_ns - estimated_ns);
+		const int64_t max_offset_ns = static_cast<int64_t>(tsc_recalibration_interval_ns / 2);
+		if (offset_ns > max_offset_ns) offset_ns = max_offset_ns;
+		if (offset_ns < -max_offset_ns) offset_ns = -max_offset_ns;
+		double target_ns = static_cast<double>(static_cast<int64_t>(tsc_recalibration_interval_ns) + offset_ns);
+
+		this->ticks_per_ns.store(ticks_per_ns, std::memory_order_relaxed);
+		recalibration_ticks.store(interval_ticks, std::memory_order_relaxed);
+		this->anchor_tsc.store(current_tsc, std::memory_order_relaxed);
+		this->anchor_ns.store(estimated_ns, std::memory_order_relaxed);
+		this->multiplier.store(static_cast<uint64_t>(target_ns * static_cast<double>(uint64_t(1) << tsc_multiplier_shift) / static_cast<double>(interval_ticks)), std::memory_order_relaxed);
+		base_multiplier.store(static_cast<uint64_t>(static_cast<double>(uint64_t(1) << tsc_multiplier_shift) / ticks_per_ns), std::memory_order_relaxed);
+		sequence.fetch_add(1, std::memory_order_release);
+
+		recalibrating.clear(std::memory_order_release);
+	}
+	#endif /* HIGH_RESOLUTION_SLEEP_DEFINE_COLD */
+
+	/**************************************************************************************************/
+	/* TSC Clock Functions 																			  */
+	/**************************************************************************************************/
+	/**
+	 * @brief	Function calibrate_tsc_clock calibrates the TSC clock, so that the calibration time is not
+	 * 			spent in the first call to now_ns_fast.
+	 * @return	bool true if the TSC is used, false if now_ns_fast falls back to now_ns.
+	 */
+	inline bool calibrate_tsc_clock() {
+		return tsc_clock_state::instance().available();
+	}
+
+	/**
+	 * @brief	Function now_ns_fast gets the current system time in nanoseconds from the time stamp counter.
+	 * @return	uint64_t current system time in nanoseconds, in the same time base as now_ns.
+	 */
+	inline uint64_t now_ns_fast() {
+		tsc_clock_state &state = tsc_clock_state::instance();
+		if (!state.available()) return now_ns();
+		return state.now_ns();
+	}
+
+	/**
+	 * @brief	Struct tsc_clock is a std::chrono clock backed by now_ns_fast.
+	 * @details	Time points share the time base of now_ns, so they can be passed to sleep_until_ns.
+	 */
+	struct tsc_clock {
+		using rep = int64_t;
+		using period = std::nano;
+		using duration = std::chrono::nanoseconds;
+		using time_point = std::chrono::time_point<tsc_clock>;
+		static constexpr bool is_steady = true;
+
+		/**
+		 * @brief	Method now gets the current time of the clock.
+		 * @return	time_point current time.
+		 */
+		static time_point now() noexcept {
+			return time_point(duration(static_cast<rep>(now_ns_fast())));
+		}
+	};
+}
+
+#endif /* TSC_CLOCK_HPP */
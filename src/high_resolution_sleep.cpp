@@ -0,0 +1,17 @@
+/**
+ * @file 	high_resolution_sleep.cpp
+ * @brief 	high_resolution_sleep.cpp compiles the calibration and initialisation functions of the sleep
+ * 			headers into the precompiled sleep library.
+ * @details	The file is only built when SLEEP_PRECOMPILED is enabled, in which case the sleep::sleep target
+ * 			defines HIGH_RESOLUTION_SLEEP_COMPILED for its users so that the headers only declare these
+ * 			functions, while the hot functions such as now_ns remain inline in every translation unit.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// Provide the definitions of the functions that are only declared when HIGH_RESOLUTION_SLEEP_COMPILED is defined.
+#define HIGH_RESOLUTION_SLEEP_IMPLEMENTATION
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "tsc_clock.hpp"
@@ -0,0 +1 @@
+#define PROJECT_DIRECTORY "/root/repo"
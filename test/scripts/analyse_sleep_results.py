@@ -1,4 +1,5 @@
 import argparse
+import numpy as np
 import pandas as pd
 import os
 import re
@@ -17,6 +18,19 @@ UNIT_TO_S : dict[str, float] = {
 	'ms'	: 1000.0,
 	's'		: 1.0,
 }
+TRACE_HEADER_BYTES : int = 16
+TRACE_RECORD : np.dtype = np.dtype([
+	('Start', '<u8'),
+	('End', '<u8'),
+	('Requested', '<u8'),
+	('Strategy', '<u4'),
+	('Thread', '<u4'),
+])
+
+def read_results(path : str) -> pd.DataFrame:
+	if path.endswith('.trace'):
+		return pd.DataFrame(np.fromfile(path, dtype = TRACE_RECORD, offset = TRACE_HEADER_BYTES))
+	return pd.read_csv(path)
 
 if __name__ == '__main__':
 	parser = argparse.ArgumentParser(
@@ -27,7 +41,7 @@ if __name__ == '__main__':
 
 	results : list[dict] = []
 	for name in os.listdir(RESULTS_DIR):
-		if os.path.isfile(RESULTS_DIR + name) and name.split('.')[-1] == 'csv':
+		if os.path.isfile(RESULTS_DIR + name) and name.split('.')[-1] in ('csv', 'trace'):
 			matches = DURATION_REGEX.search(name)
 			if matches and len(matches.groups()) == 2:
 				results.append({
@@ -44,7 +58,7 @@ if __name__ == '__main__':
 	
 	for i, r in enumerate(results):
 		print(r['name'])
-		df = pd.read_csv(r['path'])
+		df = read_results(r['path'])
 		df['Difference ns'] = df['End'] - df['Start']
 		all_summary.loc[i] = [
 			r['name'], 
@@ -0,0 +1,182 @@
+// System Libraries
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "adaptive_sleep.hpp"
+#include "high_resolution_sleep.hpp"
+
+using high_resolution_sleep::OvershootModel;
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_us_adaptive(uint32_t duration_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	high_resolution_sleep::thread_overshoot_model().reset();
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_us_adaptive(duration_us);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	return start_end_times;
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_ms_adaptive(uint32_t duration_ms, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	high_resolution_sleep::thread_overshoot_model().reset();
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_ms_adaptive(duration_ms);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_ms * 1'000'000)));
+	}
+	return start_end_times;
+}
+
+/**
+ * Gets the mean error of the samples in the range [first, last).
+ */
+double mean_error_ns(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, size_t first, size_t last) {
+	double sum = 0;
+	for (size_t i = first; i < last; i++) sum += static_cast<double>(std::get<2>(start_end_times[i]));
+	return sum / static_cast<double>(last - first);
+}
+
+/**
+ * Gets the median error of the samples in the range [first, last), which unlike the mean is not
+ * thrown off by the odd preemption.
+ */
+int64_t median_error_ns(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, size_t first, size_t last) {
+	std::vector<int64_t> errors;
+	for (size_t i = first; i < last; i++) errors.push_back(std::get<2>(start_end_times[i]));
+	std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
+	return errors[errors.size() / 2];
+}
+
+/**
+ * Checks the adaptive sleeps have converged closer to their deadlines than plain kernel sleeps of the
+ * same duration, printing the mean errors of both, and saves the results.
+ */
+void check_convergence(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, uint64_t duration_ns, std::string file_name) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> kernel_start_end_times{};
+	for (size_t i = 0; i < start_end_times.size() / 4 + 1; i++) {
+		uint64_t start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_until_ns(start_ns + duration_ns);
+		uint64_t end_ns = high_resolution_sleep::now_ns();
+		kernel_start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - duration_ns));
+	}
+	size_t half = start_end_times.size() / 2;
+	std::cout << file_name << ": kernel sleep mean error " << mean_error_ns(kernel_start_end_times, 0, kernel_start_end_times.size())
+		<< " ns, adaptive mean error " << mean_error_ns(start_end_times, 0, half) << " ns in the first half and "
+		<< mean_error_ns(start_end_times, half, start_end_times.size()) << " ns in the second half" << std::endl;
+	REQUIRE(std::abs(median_error_ns(start_end_times, half, start_end_times.size())) < median_error_ns(kernel_start_end_times, 0, kernel_start_end_times.size()));
+	REQUIRE_NOTHROW(save_results(start_end_times, PROJECT_DIRECTORY + RESULTS_DIR + file_name));
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* OvershootModel Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking OvershootModel converges onto a constant overshoot.", "[adaptive_sleep][test][short]") {
+	OvershootModel model;
+	REQUIRE(model.predict_ns(1'000'000) == 0);
+	for (int i = 0; i < 100; i++) model.update(1'000'000, 55'000);
+	REQUIRE(model.predict_ns(1'000'000) == 55'000);
+	REQUIRE(model.estimate(1'000'000).stddev_ns() < 1.0);
+	// Other buckets of durations are unaffected.
+	REQUIRE(model.predict_ns(50'000) == 0);
+	// The prediction never exceeds the duration.
+	REQUIRE(model.predict_ns(600'000) == 55'000);
+	for (int i = 0; i < 100; i++) model.update(40'000, 55'000);
+	REQUIRE(model.predict_ns(40'000) == 40'000);
+}
+
+TEST_CASE("Checking OvershootModel tracks a change in the overshoot.", "[adaptive_sleep][test][short]") {
+	OvershootModel model;
+	for (int i = 0; i < 1'000; i++) model.update(100'000, 60'000);
+	for (int i = 0; i < 200; i++) model.update(100'000, 10'000);
+	REQUIRE(model.predict_ns(100'000) >= 10'000);
+	REQUIRE(model.predict_ns(100'000) < 10'100);
+}
+
+TEST_CASE("Checking OvershootModel wakes later with a margin of standard deviations.", "[adaptive_sleep][test][short]") {
+	OvershootModel model(high_resolution_sleep::overshoot_model_config{1.0 / 16.0, 2.0});
+	for (int i = 0; i < 1'000; i++) model.update(1'000'000, i % 2 == 0 ? 40'000 : 60'000);
+	REQUIRE(model.estimate(1'000'000).mean_ns > 45'000);
+	REQUIRE(model.estimate(1'000'000).stddev_ns() > 5'000);
+	REQUIRE(model.predict_ns(1'000'000) < 40'000);
+}
+
+
+/*************************************************************************************************/
+/* sleep_us_adaptive Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking sleep_us_adaptive with sleep duration of 1 millisecond.", "[adaptive_sleep][test][short]") {
+	uint32_t us = 1'000;
+	check_convergence(test_sleep_us_adaptive(us, 1 * (1'000'000 / us)), us * 1'000, "sleep_us_adaptive-" + std::to_string(us) + "us.csv");
+}
+
+TEST_CASE("Checking sleep_us_adaptive with sleep duration of 500 microseconds.", "[adaptive_sleep][test][short]") {
+	uint32_t us = 500;
+	check_convergence(test_sleep_us_adaptive(us, 0.5 * (1'000'000 / us)), us * 1'000, "sleep_us_adaptive-" + std::to_string(us) + "us.csv");
+}
+
+TEST_CASE("Checking sleep_us_adaptive with sleep duration of 250 microseconds.", "[adaptive_sleep][test][short]") {
+	uint32_t us = 250;
+	check_convergence(test_sleep_us_adaptive(us, 0.5 * (1'000'000 / us)), us * 1'000, "sleep_us_adaptive-" + std::to_string(us) + "us.csv");
+}
+
+TEST_CASE("Checking sleep_us_adaptive with sleep duration of 100 microseconds.", "[adaptive_sleep][test][short]") {
+	uint32_t us = 100;
+	check_convergence(test_sleep_us_adaptive(us, 0.25 * (1'000'000 / us)), us * 1'000, "sleep_us_adaptive-" + std::to_string(us) + "us.csv");
+}
+
+
+/*************************************************************************************************/
+/* sleep_ms_adaptive Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking sleep_ms_adaptive with sleep duration of 10 milliseconds.", "[adaptive_sleep][test][short]") {
+	uint32_t ms = 10;
+	check_convergence(test_sleep_ms_adaptive(ms, 1 * (1000 / ms)), ms * 1'000'000, "sleep_ms_adaptive-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking sleep_ms_adaptive with sleep duration of 1 millisecond.", "[adaptive_sleep][test][short]") {
+	uint32_t ms = 1;
+	check_convergence(test_sleep_ms_adaptive(ms, 1 * (1000 / ms)), ms * 1'000'000, "sleep_ms_adaptive-" + std::to_string(ms) + "ms.csv");
+}
+
+
+/*************************************************************************************************/
+/* Adaptive Sleep Benchmarks																	 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking sleep_us_adaptive.", "[adaptive_sleep][benchmark]") {
+	uint32_t us = 1'000;
+	BENCHMARK("1 millisecond"){ return high_resolution_sleep::sleep_us_adaptive(us); };
+	us = 250;
+	BENCHMARK("250 microseconds"){ return high_resolution_sleep::sleep_us_adaptive(us); };
+	us = 50;
+	BENCHMARK("50 microseconds"){ return high_resolution_sleep::sleep_us_adaptive(us); };
+}
@@ -0,0 +1,546 @@
+/**
+ * @file 	analyse_sleep_results.cpp
+ * @brief 	analyse_sleep_results.cpp summarises the result files of the sleep tests in a single streaming
+ * 			pass, as a faster replacement for analyse_sleep_results.py that also reports percentiles and
+ * 			histograms.
+ * @details	Every CSV and trace file in the results directory whose name carries the requested duration,
+ * 			such as sleep_us-250us.csv, is split into chunks at line or record boundaries, and a pool of
+ * 			threads streams the chunks through fixed size buffers, so no file is ever held in memory.
+ * 			Each chunk is reduced to a run_summary of the slept durations (End - Start): the count, mean
+ * 			and variance kept in Welford's form, the extremes, and a log-linear histogram with 1024
+ * 			linear buckets in every power of two, which gives percentiles to within 0.1%. Summaries
+ * 			merge exactly, so the chunks of a file merge into the summary of the file, and the files of
+ * 			a run can be merged with --group. The summaries are written to all-summary.csv in the
+ * 			columns of the Python script followed by the count and percentiles, and the non-empty
+ * 			buckets of every histogram to all-histogram.csv. Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Directory Config Headers
+#include "DirectoryConfig.hpp"
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "sleep_trace.hpp"
+
+/// Number of bits of each duration kept by the linear buckets within a power of two.
+const static size_t HISTOGRAM_SUB_BUCKET_BITS = 10;
+/// Number of linear buckets within each power of two.
+const static size_t HISTOGRAM_SUB_BUCKETS = static_cast<size_t>(1) << HISTOGRAM_SUB_BUCKET_BITS;
+/// Total number of buckets needed to cover every uint64_t duration.
+const static size_t HISTOGRAM_BUCKETS = (64 - HISTOGRAM_SUB_BUCKET_BITS) * HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS;
+/// Number of bytes read from a file at a time.
+const static size_t READ_BLOCK_BYTES = 1 << 20;
+/// Percentiles written to the summary.
+const static std::vector<std::pair<std::string, double>> PERCENTILES = {
+	{"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}, {"p99.9", 0.999}, {"p99.99", 0.9999}
+};
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct analyse_options {
+	std::string results_directory = std::string(PROJECT_DIRECTORY) + "/test/results/";
+	uint32_t jobs = std::max(1u, std::thread::hardware_concurrency());
+	uint64_t chunk_mb = 16;
+	std::string group = "";
+};
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --results-dir DIR    directory of the result files, where the summaries are written (default test/results)\n"
+		<< "  --jobs N             number of threads summarising chunks (default the number of cores)\n"
+		<< "  --chunk-mb N         size of the chunks files are split into in megabytes (default 16)\n"
+		<< "  --group REGEX        merge files whose names give the same first capture group into one run named\n"
+		<< "                       by it, e.g. '(.*)-part[0-9]+' to merge the parts of a soak test (default none)\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+analyse_options parse_options(int argc, char *argv[]) {
+	analyse_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--results-dir") options.results_directory = value();
+		else if (argument == "--jobs") options.jobs = static_cast<uint32_t>(std::stoul(value()));
+		else if (argument == "--chunk-mb") options.chunk_mb = std::stoull(value());
+		else if (argument == "--group") options.group = value();
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.jobs == 0 || options.chunk_mb == 0) throw std::invalid_argument("--jobs and --chunk-mb must be greater than zero");
+	return options;
+}
+
+/**
+ * Gets the histogram bucket a duration is counted in.
+ */
+size_t histogram_index(const uint64_t value) {
+	if (value < 2 * HISTOGRAM_SUB_BUCKETS) return static_cast<size_t>(value);
+	size_t most_significant_bit = 63;
+	while ((value >> most_significant_bit) == 0) most_significant_bit--;
+	const size_t shift = most_significant_bit - HISTOGRAM_SUB_BUCKET_BITS;
+	return shift * HISTOGRAM_SUB_BUCKETS + static_cast<size_t>(value >> shift);
+}
+
+/**
+ * Gets the smallest duration counted in a histogram bucket.
+ */
+uint64_t histogram_lowest_value(const size_t index) {
+	if (index < 2 * HISTOGRAM_SUB_BUCKETS) return index;
+	const size_t shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+	return static_cast<uint64_t>(index % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS) << shift;
+}
+
+/**
+ * Gets the largest duration counted in a histogram bucket.
+ */
+uint64_t histogram_highest_value(const size_t index) {
+	return index + 1 < HISTOGRAM_BUCKETS ? histogram_lowest_value(index + 1) - 1 : UINT64_MAX;
+}
+
+/**
+ * Mergeable summary of the slept durations of a chunk, file or run.
+ */
+class run_summary {
+public:
+	/**
+	 * Counts a slept duration in nanoseconds.
+	 */
+	void record(const int64_t duration_ns) {
+		if (counts.empty()) counts.resize(HISTOGRAM_BUCKETS);
+		total++;
+		const double delta = static_cast<double>(duration_ns) - mean_ns;
+		mean_ns += delta / static_cast<double>(total);
+		squared_deviations += delta * (static_cast<double>(duration_ns) - mean_ns);
+		minimum = std::min(minimum, duration_ns);
+		maximum = std::max(maximum, duration_ns);
+		// Durations that went backwards, which only a corrupted file holds, are counted as zero.
+		counts[histogram_index(duration_ns > 0 ? static_cast<uint64_t>(duration_ns) : 0)]++;
+	}
+
+	/**
+	 * Adds another summary to this one, as if its durations had been counted here.
+	 */
+	void merge(const run_summary &other) {
+		if (other.total == 0) return;
+		if (counts.empty()) counts.resize(HISTOGRAM_BUCKETS);
+		const uint64_t merged_total = total + other.total;
+		const double delta = other.mean_ns - mean_ns;
+		mean_ns += delta * static_cast<double>(other.total) / static_cast<double>(merged_total);
+		squared_deviations += other.squared_deviations + delta * delta * static_cast<double>(total) * static_cast<double>(other.total) / static_cast<double>(merged_total);
+		total = merged_total;
+		minimum = std::min(minimum, other.minimum);
+		maximum = std::max(maximum, other.maximum);
+		for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) counts[i] += other.counts[i];
+	}
+
+	uint64_t count() const {
+		return total;
+	}
+
+	double mean() const {
+		return mean_ns;
+	}
+
+	/**
+	 * Gets the sample standard deviation, as pandas does, or NaN for fewer than two durations.
+	 */
+	double standard_deviation() const {
+		return total > 1 ? std::sqrt(squared_deviations / static_cast<double>(total - 1)) : NAN;
+	}
+
+	int64_t min() const {
+		return minimum;
+	}
+
+	int64_t max() const {
+		return maximum;
+	}
+
+	/**
+	 * Gets the duration below which a fraction of the durations fall, to within the width of a bucket.
+	 */
+	uint64_t percentile(const double fraction) const {
+		if (total == 0) return 0;
+		uint64_t target = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+		if (target == 0) target = 1;
+		uint64_t seen = 0;
+		for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+			seen += counts[i];
+			if (seen >= target) return std::min(histogram_highest_value(i), static_cast<uint64_t>(std::max<int64_t>(maximum, 0)));
+		}
+		return static_cast<uint64_t>(std::max<int64_t>(maximum, 0));
+	}
+
+	/**
+	 * Gets the number of durations counted in a histogram bucket.
+	 */
+	uint64_t bucket_count(const size_t index) const {
+		return counts.empty() ? 0 : counts[index];
+	}
+
+private:
+	uint64_t total = 0;
+	double mean_ns = 0;
+	double squared_deviations = 0;
+	int64_t minimum = INT64_MAX;
+	int64_t maximum = INT64_MIN;
+	std::vector<uint64_t> counts{};
+};
+
+/**
+ * A result file and the requested duration given by its name.
+ */
+struct result_file {
+	std::string name;
+	std::string path;
+	double requested_ns;
+	bool trace;
+	uint64_t size;
+	// Position of the first line or record after the header, and the columns of the CSV.
+	uint64_t data_offset = 0;
+	size_t start_column = 0;
+	size_t end_column = 0;
+};
+
+/**
+ * A byte range of a result file summarised by one thread.
+ */
+struct file_chunk {
+	size_t file;
+	uint64_t begin;
+	uint64_t end;
+};
+
+/**
+ * Gets the result files of the directory whose names carry the requested duration, as the Python script does.
+ */
+std::vector<result_file> find_result_files(const std::string &directory) {
+	static const std::regex duration_regex("-([0-9]+)([a-zA-Z]*[sS])\\.");
+	static const std::map<std::string, double> unit_to_ns = {{"s", 1'000'000'000.0}, {"ms", 1'000'000.0}, {"us", 1'000.0}, {"ns", 1.0}};
+	std::vector<result_file> files;
+	for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory)) {
+		if (!entry.is_regular_file()) continue;
+		const std::string name = entry.path().filename().string();
+		const std::string extension = entry.path().extension().string();
+		if (extension != ".csv" && extension != ".trace") continue;
+		std::smatch matches;
+		if (!std::regex_search(name, matches, duration_regex)) continue;
+		const auto unit = unit_to_ns.find(matches[2].str());
+		if (unit == unit_to_ns.end()) {
+			std::cerr << "Warning: skipping " << name << ", " << matches[2].str() << " is not a known unit.\n";
+			continue;
+		}
+		files.push_back(result_file{name, entry.path().string(), std::stod(matches[1].str()) * unit->second, extension == ".trace", static_cast<uint64_t>(entry.file_size())});
+	}
+	return files;
+}
+
+/**
+ * Reads the header of a result file, finding where its data starts and for CSVs the Start and End columns.
+ * Throws std::runtime_error if the file is not a valid result file.
+ */
+void read_header(result_file &file) {
+	std::ifstream input(file.path, std::ios::in | std::ios::binary);
+	if (!input) throw std::runtime_error("could not open " + file.path);
+	if (file.trace) {
+		high_resolution_sleep::sleep_trace_header header{};
+		input.read(reinterpret_cast<char *>(&header), sizeof(header));
+		if (!input || std::memcmp(header.magic, high_resolution_sleep::sleep_trace_magic, sizeof(header.magic)) != 0 ||
+			header.version != high_resolution_sleep::sleep_trace_version || header.record_size != sizeof(high_resolution_sleep::sleep_trace_record)) {
+			throw std::runtime_error(file.name + " is not a version " + std::to_string(high_resolution_sleep::sleep_trace_version) + " sleep trace");
+		}
+		file.data_offset = sizeof(header);
+		return;
+	}
+	std::string header;
+	std::getline(input, header);
+	if (!input) throw std::runtime_error(file.name + " has no header");
+	file.data_offset = header.size() + 1;
+	if (!header.empty() && header.back() == '\r') header.pop_back();
+	bool found_start = false, found_end = false;
+	size_t column = 0, field_begin = 0;
+	while (field_begin <= header.size()) {
+		size_t field_end = header.find(',', field_begin);
+		if (field_end == std::string::npos) field_end = header.size();
+		const std::string field = header.substr(field_begin, field_end - field_begin);
+		if (field == "Start") { file.start_column = column; found_start = true; }
+		if (field == "End") { file.end_column = column; found_end = true; }
+		field_begin = field_end + 1;
+		column++;
+	}
+	if (!found_start || !found_end) throw std::runtime_error(file.name + " has no Start and End columns");
+}
+
+/**
+ * Calls the callback with each line that starts within [begin, end) of a file, reading through a fixed
+ * size buffer. A line that starts before begin belongs to the previous chunk and is skipped.
+ */
+template <typename Callback>
+void for_each_line(const std::string &path, const uint64_t begin, const uint64_t end, Callback callback) {
+	std::ifstream input(path, std::ios::in | std::ios::binary);
+	if (!input) throw std::runtime_error("could not open " + path);
+	// Start one byte early so that a line starting exactly at begin is recognised by the newline before it.
+	uint64_t buffer_offset = begin > 0 ? begin - 1 : 0;
+	bool skipping = begin > 0;
+	input.seekg(static_cast<std::streamoff>(buffer_offset));
+	std::vector<char> buffer(READ_BLOCK_BYTES);
+	size_t size = 0;
+	while (true) {
+		input.read(buffer.data() + size, static_cast<std::streamsize>(buffer.size() - size));
+		const size_t read = static_cast<size_t>(input.gcount());
+		size += read;
+		size_t line_begin = 0;
+		while (true) {
+			const char *newline = static_cast<const char *>(std::memchr(buffer.data() + line_begin, '\n', size - line_begin));
+			if (newline == nullptr) break;
+			const size_t line_end = static_cast<size_t>(newline - buffer.data());
+			if (skipping) skipping = false;
+			else if (buffer_offset + line_begin >= end) return;
+			else callback(buffer.data() + line_begin, buffer.data() + line_end);
+			line_begin = line_end + 1;
+		}
+		if (read == 0) {
+			// The final line of a file may have no newline.
+			if (!skipping && line_begin < size && buffer_offset + line_begin < end) callback(buffer.data() + line_begin, buffer.data() + size);
+			return;
+		}
+		// Move the partial line to the front of the buffer, growing the buffer if one line fills it.
+		std::memmove(buffer.data(), buffer.data() + line_begin, size - line_begin);
+		buffer_offset += line_begin;
+		size -= line_begin;
+		if (!skipping && buffer_offset >= end) return;
+		if (size == buffer.size()) buffer.resize(buffer.size() * 2);
+	}
+}
+
+/**
+ * Parses the Start and End columns of a CSV line, returning false for lines that do not hold them.
+ */
+bool parse_line(const char *line, const char *line_end, const result_file &file, uint64_t &start_ns, uint64_t &end_ns) {
+	const size_t last_column = std::max(file.start_column, file.end_column);
+	size_t column = 0;
+	bool found_start = false, found_end = false;
+	const char *field = line;
+	while (column <= last_column && field <= line_end) {
+		const char *field_end = static_cast<const char *>(std::memchr(field, ',', static_cast<size_t>(line_end - field)));
+		if (field_end == nullptr) field_end = line_end;
+		if (column == file.start_column) found_start = std::from_chars(field, field_end, start_ns).ec == std::errc();
+		if (column == file.end_column) found_end = std::from_chars(field, field_end, end_ns).ec == std::errc();
+		field = field_end + 1;
+		column++;
+	}
+	return found_start && found_end;
+}
+
+/**
+ * Summarises the slept durations of a chunk of a result file.
+ */
+run_summary summarise_chunk(const result_file &file, const file_chunk &chunk, uint64_t &malformed_lines) {
+	run_summary summary;
+	if (file.trace) {
+		std::ifstream input(file.path, std::ios::in | std::ios::binary);
+		if (!input) throw std::runtime_error("could not open " + file.path);
+		input.seekg(static_cast<std::streamoff>(chunk.begin));
+		std::vector<high_resolution_sleep::sleep_trace_record> records(READ_BLOCK_BYTES / sizeof(high_resolution_sleep::sleep_trace_record));
+		uint64_t remaining = (chunk.end - chunk.begin) / sizeof(high_resolution_sleep::sleep_trace_record);
+		while (remaining > 0) {
+			const size_t count = static_cast<size_t>(std::min<uint64_t>(remaining, records.size()));
+			input.read(reinterpret_cast<char *>(records.data()), static_cast<std::streamsize>(count * sizeof(high_resolution_sleep::sleep_trace_record)));
+			if (!input) throw std::runtime_error("could not read " + file.path);
+			for (size_t i = 0; i < count; i++) summary.record(static_cast<int64_t>(records[i].end_ns - records[i].start_ns));
+			remaining -= count;
+		}
+		return summary;
+	}
+	for_each_line(file.path, chunk.begin, chunk.end, [&](const char *line, const char *line_end) {
+		if (line_end > line && line_end[-1] == '\r') line_end--;
+		if (line_end == line) return;
+		uint64_t start_ns, end_ns;
+		if (parse_line(line, line_end, file, start_ns, end_ns)) summary.record(static_cast<int64_t>(end_ns - start_ns));
+		else malformed_lines++;
+	});
+	return summary;
+}
+
+/**
+ * Splits the result files into chunks, aligning the chunks of traces to whole records.
+ */
+std::vector<file_chunk> make_chunks(const std::vector<result_file> &files, const uint64_t chunk_bytes) {
+	std::vector<file_chunk> chunks;
+	for (size_t i = 0; i < files.size(); i++) {
+		const result_file &file = files[i];
+		uint64_t data_end = file.size;
+		uint64_t step = chunk_bytes;
+		if (file.trace) {
+			// A partially written final record, e.g. from a process that was killed while draining, is ignored.
+			const uint64_t record_size = sizeof(high_resolution_sleep::sleep_trace_record);
+			data_end = file.data_offset + (file.size - file.data_offset) / record_size * record_size;
+			step = std::max(record_size, chunk_bytes / record_size * record_size);
+		}
+		for (uint64_t begin = file.data_offset; begin < data_end; begin += step) chunks.push_back(file_chunk{i, begin, std::min(begin + step, data_end)});
+	}
+	return chunks;
+}
+
+/**
+ * A run written to the outputs: the merged summary of one or more files with the same requested duration.
+ */
+struct run_result {
+	std::string name;
+	double requested_ns;
+	run_summary summary;
+};
+
+/**
+ * Writes the summary of every run in the columns of the Python script followed by the count and percentiles.
+ */
+void write_summary(const std::vector<run_result> &runs, const std::string &file_name) {
+	std::ofstream output(file_name, std::ios::out | std::ios::trunc);
+	output << "Name,Requested ns,Mean ns,Standard Deviation ns,Minimum ns,Maximum ns,Mean Error ns,Count";
+	for (const auto &[label, fraction] : PERCENTILES) output << "," << label << " ns";
+	output << "\n" << std::fixed << std::setprecision(3);
+	for (const run_result &run : runs) {
+		const double standard_deviation = run.summary.standard_deviation();
+		output << run.name << "," << run.requested_ns << "," << run.summary.mean() << ",";
+		if (!std::isnan(standard_deviation)) output << standard_deviation;
+		output << "," << run.summary.min() << "," << run.summary.max() << "," << run.summary.mean() - run.requested_ns << "," << run.summary.count();
+		for (const auto &[label, fraction] : PERCENTILES) output << "," << run.summary.percentile(fraction);
+		output << "\n";
+	}
+	if (!output) throw std::runtime_error("could not write " + file_name);
+}
+
+/**
+ * Writes the non-empty histogram buckets of every run.
+ */
+void write_histograms(const std::vector<run_result> &runs, const std::string &file_name) {
+	std::ofstream output(file_name, std::ios::out | std::ios::trunc);
+	output << "Name,Lower ns,Upper ns,Count\n";
+	for (const run_result &run : runs) {
+		for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+			const uint64_t count = run.summary.bucket_count(i);
+			if (count != 0) output << run.name << "," << histogram_lowest_value(i) << "," << histogram_highest_value(i) << "," << count << "\n";
+		}
+	}
+	if (!output) throw std::runtime_error("could not write " + file_name);
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	analyse_options options;
+	std::regex group_regex;
+	try {
+		options = parse_options(argc, argv);
+		if (!options.group.empty()) group_regex = std::regex(options.group);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	try {
+		const uint64_t start_ns = high_resolution_sleep::now_ns();
+		std::vector<result_file> files = find_result_files(options.results_directory);
+		std::sort(files.begin(), files.end(), [](const result_file &a, const result_file &b) { return a.name < b.name; });
+		for (result_file &file : files) read_header(file);
+
+		// Summarise the chunks on a pool of threads, merging each into the summary of its file.
+		const std::vector<file_chunk> chunks = make_chunks(files, options.chunk_mb << 20);
+		std::vector<run_summary> file_summaries(files.size());
+		std::vector<std::mutex> file_mutexes(files.size());
+		std::atomic<size_t> next_chunk{0};
+		std::atomic<uint64_t> malformed_lines{0};
+		std::mutex error_mutex;
+		std::string error;
+		std::vector<std::thread> workers;
+		for (uint32_t t = 0; t < std::min<size_t>(options.jobs, std::max<size_t>(chunks.size(), 1)); t++) {
+			workers.emplace_back([&]() {
+				try {
+					for (size_t i = next_chunk++; i < chunks.size(); i = next_chunk++) {
+						uint64_t chunk_malformed_lines = 0;
+						const run_summary summary = summarise_chunk(files[chunks[i].file], chunks[i], chunk_malformed_lines);
+						malformed_lines += chunk_malformed_lines;
+						std::lock_guard<std::mutex> lock(file_mutexes[chunks[i].file]);
+						file_summaries[chunks[i].file].merge(summary);
+					}
+				}
+				catch (const std::exception &e) {
+					std::lock_guard<std::mutex> lock(error_mutex);
+					error = e.what();
+					next_chunk = chunks.size();
+				}
+			});
+		}
+		for (std::thread &worker : workers) worker.join();
+		if (!error.empty()) throw std::runtime_error(error);
+
+		// Merge the files of each run, a run being a single file unless --group names it.
+		std::map<std::string, run_result> runs_by_name;
+		for (size_t i = 0; i < files.size(); i++) {
+			std::string name = files[i].name;
+			std::smatch matches;
+			if (!options.group.empty() && std::regex_search(files[i].name, matches, group_regex) && matches.size() > 1) name = matches[1].str();
+			auto [run, inserted] = runs_by_name.try_emplace(name, run_result{name, files[i].requested_ns, {}});
+			if (!inserted && run->second.requested_ns != files[i].requested_ns) {
+				throw std::runtime_error("the files of run " + name + " request different durations");
+			}
+			run->second.summary.merge(file_summaries[i]);
+		}
+		std::vector<run_result> runs;
+		for (auto &[name, run] : runs_by_name) runs.push_back(std::move(run));
+		std::stable_sort(runs.begin(), runs.end(), [](const run_result &a, const run_result &b) { return a.requested_ns < b.requested_ns; });
+
+		write_summary(runs, options.results_directory + "/all-summary.csv");
+		write_histograms(runs, options.results_directory + "/all-histogram.csv");
+		uint64_t samples = 0, bytes = 0;
+		for (const run_result &run : runs) samples += run.summary.count();
+		for (const result_file &file : files) bytes += file.size;
+		const double seconds = static_cast<double>(high_resolution_sleep::now_ns() - start_ns) / 1e9;
+		std::cout << std::fixed << std::setprecision(2) << "Analysed " << samples << " samples of " << runs.size() << " runs from " << files.size() << " files ("
+			<< static_cast<double>(bytes) / 1e6 << " MB) in " << seconds << " s with " << workers.size() << " threads\n";
+		if (malformed_lines > 0) std::cerr << "Warning: skipped " << malformed_lines << " lines without Start and End values.\n";
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		return 1;
+	}
+	return 0;
+}
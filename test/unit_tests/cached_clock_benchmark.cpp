@@ -0,0 +1,182 @@
+/**
+ * @file 	cached_clock_benchmark.cpp
+ * @brief 	cached_clock_benchmark.cpp compares the cost and staleness of reading a CachedClock against
+ * 			reading now_ns.
+ * @details	For each update period a CachedClock is started, read in a tight loop to time the cost of a
+ * 			read, then sampled against now_ns at irregular intervals to measure how far behind it the
+ * 			cached time is. For each period the tool reports the cost per read, the staleness percentiles
+ * 			against the staleness bound reported by the clock and the CPU time the process used while
+ * 			sampling, which is mostly the updater. Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+	#include <sys/resource.h>
+#endif /* _WIN32 */
+
+// Sleep Headers
+#include "cached_clock.hpp"
+#include "high_resolution_sleep.hpp"
+
+using high_resolution_sleep::CachedClock;
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct cached_clock_options {
+	std::vector<uint64_t> periods_us = {10, 100, 1'000};
+	uint64_t reads = 10'000'000;
+	uint64_t samples = 10'000;
+};
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --periods-us LIST    comma separated update periods of the cached clock in microseconds (default 10,100,1000)\n"
+		<< "  --reads N            number of reads timed for the cost of each clock (default 10000000)\n"
+		<< "  --samples N          number of staleness samples taken for each period (default 10000)\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+cached_clock_options parse_options(int argc, char *argv[]) {
+	cached_clock_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--periods-us") {
+			options.periods_us.clear();
+			std::stringstream list(value());
+			std::string period;
+			while (std::getline(list, period, ',')) options.periods_us.push_back(std::stoull(period));
+		}
+		else if (argument == "--reads") options.reads = std::stoull(value());
+		else if (argument == "--samples") options.samples = std::stoull(value());
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.reads == 0 || options.samples == 0) throw std::invalid_argument("--reads and --samples must be greater than zero");
+	if (options.periods_us.empty() || std::find(options.periods_us.begin(), options.periods_us.end(), 0) != options.periods_us.end()) {
+		throw std::invalid_argument("--periods-us needs at least one period, all greater than zero");
+	}
+	return options;
+}
+
+/**
+ * Gets the CPU time consumed by the process in nanoseconds, or zero where unavailable.
+ */
+uint64_t process_cpu_time_ns() {
+	#ifndef _WIN32
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+		return (static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1'000'000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1'000;
+	}
+	#endif /* _WIN32 */
+	return 0;
+}
+
+/// Sink for the clock reads, so that the timed loops are not optimised away.
+volatile uint64_t clock_sink = 0;
+
+/**
+ * Times the average cost in nanoseconds of reading a clock through the given function.
+ */
+template <typename Read>
+double read_cost_ns(const cached_clock_options &options, Read read) {
+	uint64_t sum = 0;
+	const uint64_t start_ns = high_resolution_sleep::now_ns();
+	for (uint64_t i = 0; i < options.reads; i++) sum += read();
+	const uint64_t elapsed_ns = high_resolution_sleep::now_ns() - start_ns;
+	clock_sink = sum;
+	return static_cast<double>(elapsed_ns) / static_cast<double>(options.reads);
+}
+
+/**
+ * Result of running a cached clock at one period.
+ */
+struct cached_clock_result {
+	double read_ns = 0;
+	std::vector<uint64_t> staleness_ns{};
+	uint64_t staleness_bound_ns = 0;
+	double cpu_percent = 0;
+};
+
+/**
+ * Runs a cached clock at the given period, timing its reads and sampling its staleness.
+ */
+cached_clock_result run(const cached_clock_options &options, const uint64_t period_us) {
+	cached_clock_result result;
+	CachedClock clock(period_us * 1'000);
+	clock.start();
+	result.read_ns = read_cost_ns(options, [&clock]() { return clock.now_ns(); });
+
+	result.staleness_ns.reserve(options.samples);
+	const uint64_t start_ns = high_resolution_sleep::now_ns();
+	const uint64_t start_cpu_ns = process_cpu_time_ns();
+	for (uint64_t i = 0; i < options.samples; i++) {
+		const uint64_t cached_ns = clock.now_ns();
+		result.staleness_ns.push_back(high_resolution_sleep::now_ns() - cached_ns);
+		// Sample at an interval unrelated to the period, so that reads land throughout the period, sleeping
+		// in the kernel so that the CPU time measured is the updater's.
+		high_resolution_sleep::sleep_until_ns(high_resolution_sleep::now_ns() + (37 + (i * 7) % 29) * 1'000);
+	}
+	result.cpu_percent = 100.0 * static_cast<double>(process_cpu_time_ns() - start_cpu_ns) / static_cast<double>(high_resolution_sleep::now_ns() - start_ns);
+	clock.stop();
+	result.staleness_bound_ns = clock.staleness_bound_ns();
+	std::sort(result.staleness_ns.begin(), result.staleness_ns.end());
+	return result;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	cached_clock_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	const double now_ns_cost = read_cost_ns(options, []() { return high_resolution_sleep::now_ns(); });
+	std::cout << std::fixed << std::setprecision(1) << "now_ns costs " << now_ns_cost << " ns per read and is never stale\n"
+		<< "Cached clock reads and staleness against now_ns, in nanoseconds\n"
+		<< std::right << std::setw(10) << "Period" << std::setw(12) << "Read" << std::setw(12) << "p50"
+		<< std::setw(12) << "p99" << std::setw(12) << "Max" << std::setw(12) << "Bound" << std::setw(10) << "CPU" << std::endl;
+	for (const uint64_t period_us : options.periods_us) {
+		const cached_clock_result result = run(options, period_us);
+		auto percentile = [&result](double fraction) { return result.staleness_ns[static_cast<size_t>(fraction * (result.staleness_ns.size() - 1))]; };
+		std::cout << std::setw(8) << period_us << "us" << std::setw(12) << result.read_ns << std::setw(12) << percentile(0.5)
+			<< std::setw(12) << percentile(0.99) << std::setw(12) << result.staleness_ns.back() << std::setw(12) << result.staleness_bound_ns
+			<< std::setw(9) << result.cpu_percent << "%" << std::endl;
+	}
+	#ifdef _WIN32
+	std::cerr << "Warning: CPU time is not available on this platform, it is reported as zero.\n";
+	#endif /* _WIN32 */
+	return 0;
+}
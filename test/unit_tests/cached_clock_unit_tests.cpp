@@ -0,0 +1,117 @@
+// System Libraries
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "cached_clock.hpp"
+#include "high_resolution_sleep.hpp"
+
+using high_resolution_sleep::CachedClock;
+
+/**
+ * Samples the staleness of a running CachedClock against now_ns, checking the cached time is never
+ * ahead of now_ns and never staler than the staleness bound reported once the clock is stopped.
+ * Each cached read is bracketed by reads of now_ns, and samples whose bracket is longer than
+ * max_bracket_ns are discarded, since the thread was preempted and the staleness is not known.
+ */
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_cached_clock(uint32_t period_us, uint32_t sample_count, uint64_t max_bracket_ns = 2'000) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> cached_now_times{};
+	cached_now_times.reserve(sample_count);
+	CachedClock clock(period_us * 1'000);
+	clock.start();
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t before_ns, cached_ns, after_ns;
+		before_ns = high_resolution_sleep::now_ns();
+		cached_ns = clock.now_ns();
+		after_ns = high_resolution_sleep::now_ns();
+		REQUIRE(cached_ns <= after_ns);
+		if (after_ns - before_ns <= max_bracket_ns) {
+			cached_now_times.push_back(std::make_tuple(cached_ns, before_ns, before_ns - cached_ns));
+		}
+		// Sample at an interval unrelated to the period, so that reads land throughout the period.
+		high_resolution_sleep::sleep_us(37);
+	}
+	clock.stop();
+	// The staleness is measured from the read of now_ns before the cached read, so it is never overstated,
+	// and is negative when the time was published between the two reads.
+	for (const auto &sample : cached_now_times) {
+		REQUIRE(std::get<2>(sample) <= static_cast<int64_t>(clock.staleness_bound_ns()));
+	}
+	REQUIRE(cached_now_times.size() > sample_count / 2);
+	REQUIRE(clock.updates() > 0);
+	return cached_now_times;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* CachedClock Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking CachedClock staleness with an update period of 1 millisecond.", "[cached_clock][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_cached_clock(us, 10'000), PROJECT_DIRECTORY + RESULTS_DIR + "cached_clock-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking CachedClock staleness with an update period of 100 microseconds.", "[cached_clock][test][short]") {
+	uint32_t us = 100;
+	REQUIRE_NOTHROW(save_results(test_cached_clock(us, 10'000), PROJECT_DIRECTORY + RESULTS_DIR + "cached_clock-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking CachedClock staleness with an update period of 10 microseconds.", "[cached_clock][test][short]") {
+	uint32_t us = 10;
+	REQUIRE_NOTHROW(save_results(test_cached_clock(us, 10'000), PROJECT_DIRECTORY + RESULTS_DIR + "cached_clock-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking CachedClock publishes the time when started and stops cleanly.", "[cached_clock][test][short]") {
+	REQUIRE_THROWS_AS(CachedClock(0), std::invalid_argument);
+	CachedClock clock(1'000'000'000);
+	REQUIRE_FALSE(clock.is_running());
+	REQUIRE(clock.now_ns() == 0);
+	uint64_t before_ns = high_resolution_sleep::now_ns();
+	clock.start();
+	REQUIRE(clock.is_running());
+	REQUIRE(clock.now_ns() >= before_ns);
+	REQUIRE_THROWS_AS(clock.start(), std::logic_error);
+	// Stopping does not wait out the second long period, and publishes the time a last time.
+	uint64_t stop_ns = high_resolution_sleep::now_ns();
+	clock.stop();
+	REQUIRE(high_resolution_sleep::now_ns() - stop_ns < 500'000'000);
+	REQUIRE_FALSE(clock.is_running());
+	REQUIRE(clock.now_ns() >= stop_ns);
+	REQUIRE(clock.updates() == 1);
+	REQUIRE_NOTHROW(clock.stop());
+	// The clock can be restarted after it has been stopped.
+	clock.start();
+	REQUIRE(clock.is_running());
+	clock.stop();
+	REQUIRE(clock.updates() == 2);
+}
+
+
+/*************************************************************************************************/
+/* CachedClock Benchmarks																		 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking CachedClock.", "[cached_clock][benchmark]") {
+	CachedClock clock;
+	clock.start();
+	BENCHMARK("CachedClock::now_ns"){ return clock.now_ns(); };
+	BENCHMARK("now_ns"){ return high_resolution_sleep::now_ns(); };
+	clock.stop();
+}
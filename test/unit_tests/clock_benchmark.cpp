@@ -0,0 +1,152 @@
+/**
+ * @file 	clock_benchmark.cpp
+ * @brief 	clock_benchmark.cpp measures the cost of reading and the resolution of each clock source of
+ * 			high_resolution_sleep.hpp on the running host.
+ * @details	Each clock is read in a tight loop to time the average cost of a call, then read until its
+ * 			value has changed many times to observe the steps it advances by. For each clock the tool
+ * 			reports the cost per call, the resolution reported by the platform and the smallest and
+ * 			median steps observed. Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+
+namespace clock_source = high_resolution_sleep::clock_source;
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct clock_options {
+	uint64_t calls = 1'000'000;
+	uint64_t steps = 1'000;
+	uint64_t observe_ms = 200;
+};
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --calls N            number of reads timed for the cost of each clock (default 1000000)\n"
+		<< "  --steps N            number of changes of each clock observed for its resolution (default 1000)\n"
+		<< "  --observe-ms N       longest time spent observing the changes of each clock in milliseconds (default 200)\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+clock_options parse_options(int argc, char *argv[]) {
+	clock_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--calls") options.calls = std::stoull(value());
+		else if (argument == "--steps") options.steps = std::stoull(value());
+		else if (argument == "--observe-ms") options.observe_ms = std::stoull(value());
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.calls == 0 || options.steps == 0 || options.observe_ms == 0) throw std::invalid_argument("--calls, --steps and --observe-ms must be greater than zero");
+	return options;
+}
+
+/**
+ * Result of measuring one clock.
+ */
+struct clock_result {
+	double cost_ns = 0;
+	uint64_t reported_resolution_ns = 0;
+	uint64_t min_step_ns = 0;
+	uint64_t median_step_ns = 0;
+};
+
+/// Sink for the clock reads, so that the timed loop is not optimised away.
+volatile uint64_t clock_sink = 0;
+
+/**
+ * Measures the cost per call and the steps of a clock, read through the given function in nanoseconds.
+ */
+template <typename Read>
+clock_result measure(const clock_options &options, Read read, const uint64_t reported_resolution_ns) {
+	clock_result result;
+	result.reported_resolution_ns = reported_resolution_ns;
+
+	uint64_t sum = 0;
+	const uint64_t start_ns = high_resolution_sleep::now_ns();
+	for (uint64_t i = 0; i < options.calls; i++) sum += read();
+	result.cost_ns = static_cast<double>(high_resolution_sleep::now_ns() - start_ns) / static_cast<double>(options.calls);
+	clock_sink = sum;
+
+	// Read the clock until it has changed enough times or the observation time is up.
+	std::vector<uint64_t> steps_ns;
+	steps_ns.reserve(options.steps);
+	const uint64_t observe_end_ns = high_resolution_sleep::now_ns() + options.observe_ms * 1'000'000;
+	uint64_t previous = read();
+	while (steps_ns.size() < options.steps && high_resolution_sleep::now_ns() < observe_end_ns) {
+		const uint64_t current = read();
+		if (current != previous) {
+			steps_ns.push_back(current - previous);
+			previous = current;
+		}
+	}
+	if (!steps_ns.empty()) {
+		std::sort(steps_ns.begin(), steps_ns.end());
+		result.min_step_ns = steps_ns.front();
+		result.median_step_ns = steps_ns[steps_ns.size() / 2];
+	}
+	return result;
+}
+
+/**
+ * Prints the cost and resolution of one clock.
+ */
+void print_result(const std::string &name, const clock_result &result) {
+	std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(20) << name << std::right
+		<< std::setw(12) << result.cost_ns << std::setw(16) << result.reported_resolution_ns
+		<< std::setw(16) << result.min_step_ns << std::setw(16) << result.median_step_ns << std::endl;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	clock_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::cout << "Cost of " << options.calls << " reads of each clock and the steps of up to " << options.steps << " changes, all in nanoseconds\n"
+		<< std::left << std::setw(20) << "Clock" << std::right << std::setw(12) << "Cost/call" << std::setw(16) << "Reported res"
+		<< std::setw(16) << "Min step" << std::setw(16) << "Median step" << std::endl;
+	print_result("monotonic", measure(options, high_resolution_sleep::now_ns_on<clock_source::monotonic>, clock_source::monotonic::resolution_ns()));
+	print_result("monotonic_coarse", measure(options, high_resolution_sleep::now_ns_on<clock_source::monotonic_coarse>, clock_source::monotonic_coarse::resolution_ns()));
+	print_result("monotonic_raw", measure(options, high_resolution_sleep::now_ns_on<clock_source::monotonic_raw>, clock_source::monotonic_raw::resolution_ns()));
+	print_result("boottime", measure(options, high_resolution_sleep::now_ns_on<clock_source::boottime>, clock_source::boottime::resolution_ns()));
+	// now_ms_coarse is scaled to nanoseconds so that its steps are comparable with the other clocks.
+	print_result("now_ms_coarse", measure(options, []() { return high_resolution_sleep::now_ms_coarse() * 1'000'000; }, 1'000'000));
+	return 0;
+}
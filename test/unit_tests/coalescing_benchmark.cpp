@@ -0,0 +1,198 @@
+/**
+ * @file 	coalescing_benchmark.cpp
+ * @brief 	coalescing_benchmark.cpp measures the wakeups and context switches saved by the tolerant sleeps
+ * 			of coalescing_sleep.hpp against the accuracy they give up.
+ * @details	Many threads pace periodic loops at nearby periods, first with precise sleeps and then with
+ * 			tolerant sleeps at each tolerance. For every run the tool reports the timer wakeups per
+ * 			second the host serviced, the context switches per second of the process, and the lateness of
+ * 			the wakeups relative to the deadlines. Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+	#include <sys/resource.h>
+#endif /* _WIN32 */
+
+// Sleep Headers
+#include "coalescing_sleep.hpp"
+#include "high_resolution_sleep.hpp"
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct coalescing_options {
+	uint32_t threads = 1'000;
+	uint64_t period_us = 1'000;
+	uint64_t spread_us = 50;
+	std::vector<uint64_t> tolerances_us = {0, 100, 500, 1'000};
+	uint64_t duration_ms = 1'000;
+};
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --threads N          number of pacing threads (default 1000)\n"
+		<< "  --period-us N        shortest period of the threads in microseconds (default 1000)\n"
+		<< "  --spread-us N        the periods are spread evenly up to this much longer (default 50)\n"
+		<< "  --tolerances-us LIST comma separated tolerances to run, 0 being precise sleeps (default 0,100,500,1000)\n"
+		<< "  --duration-ms N      duration of each run in milliseconds (default 1000)\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+coalescing_options parse_options(int argc, char *argv[]) {
+	coalescing_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--threads") options.threads = static_cast<uint32_t>(std::stoul(value()));
+		else if (argument == "--period-us") options.period_us = std::stoull(value());
+		else if (argument == "--spread-us") options.spread_us = std::stoull(value());
+		else if (argument == "--tolerances-us") {
+			options.tolerances_us.clear();
+			std::stringstream list(value());
+			std::string tolerance;
+			while (std::getline(list, tolerance, ',')) options.tolerances_us.push_back(std::stoull(tolerance));
+		}
+		else if (argument == "--duration-ms") options.duration_ms = std::stoull(value());
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.threads == 0 || options.period_us == 0 || options.duration_ms == 0) throw std::invalid_argument("--threads, --period-us and --duration-ms must be greater than zero");
+	if (options.tolerances_us.empty()) throw std::invalid_argument("--tolerances-us needs at least one tolerance");
+	return options;
+}
+
+/**
+ * Gets the number of voluntary and involuntary context switches of the process, or zero where unavailable.
+ */
+uint64_t process_context_switches() {
+	#ifndef _WIN32
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) return static_cast<uint64_t>(usage.ru_nvcsw + usage.ru_nivcsw);
+	#endif /* _WIN32 */
+	return 0;
+}
+
+/**
+ * Result of one run.
+ */
+struct coalescing_result {
+	std::vector<int64_t> lateness_ns{};
+	double wakeups_per_second = 0;
+	double switches_per_second = 0;
+};
+
+/**
+ * Paces the threads for the duration with the given tolerance, zero being precise sleeps.
+ */
+coalescing_result run(const coalescing_options &options, const uint64_t tolerance_us) {
+	std::vector<std::vector<int64_t>> lateness(options.threads);
+	std::atomic<uint32_t> ready{0};
+	std::atomic<uint64_t> sleeps{0};
+	// Start the loops in the future so that every thread has been created before the first deadline.
+	const uint64_t start_ns = high_resolution_sleep::now_ns() + options.threads * 100'000ull + 10'000'000;
+	const uint64_t end_ns = start_ns + options.duration_ms * 1'000'000;
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < options.threads; t++) {
+		threads.emplace_back([&, t]() {
+			const uint64_t period_ns = (options.period_us + (options.spread_us * t) / options.threads) * 1'000;
+			std::vector<int64_t> &thread_lateness = lateness[t];
+			thread_lateness.reserve(options.duration_ms * 1'000 / options.period_us + 1);
+			ready++;
+			uint64_t count = 0;
+			for (uint64_t deadline_ns = start_ns + period_ns; deadline_ns < end_ns; deadline_ns += period_ns) {
+				high_resolution_sleep::sleep_until_ns_tolerant(deadline_ns, tolerance_us * 1'000);
+				thread_lateness.push_back(static_cast<int64_t>(high_resolution_sleep::now_ns() - deadline_ns));
+				count++;
+			}
+			sleeps += count;
+		});
+	}
+	while (ready.load() < options.threads) std::this_thread::yield();
+	high_resolution_sleep::sleep_until_ns(start_ns);
+	const high_resolution_sleep::wakeup_coalescer_stats start_stats = high_resolution_sleep::shared_wakeup_coalescer().stats();
+	const uint64_t start_switches = process_context_switches();
+	for (std::thread &thread : threads) thread.join();
+	const uint64_t switches = process_context_switches() - start_switches;
+	const high_resolution_sleep::wakeup_coalescer_stats end_stats = high_resolution_sleep::shared_wakeup_coalescer().stats();
+	const double seconds = static_cast<double>(high_resolution_sleep::now_ns() - start_ns) / 1e9;
+
+	coalescing_result result;
+	for (const std::vector<int64_t> &thread_lateness : lateness) result.lateness_ns.insert(result.lateness_ns.end(), thread_lateness.begin(), thread_lateness.end());
+	std::sort(result.lateness_ns.begin(), result.lateness_ns.end());
+	// Precise sleeps each need a timer, tolerant sleeps only need one for each leader or collision.
+	const uint64_t wakeups = tolerance_us == 0 ? sleeps.load() : (end_stats.leaders - start_stats.leaders) + (end_stats.collisions - start_stats.collisions);
+	result.wakeups_per_second = static_cast<double>(wakeups) / seconds;
+	result.switches_per_second = static_cast<double>(switches) / seconds;
+	return result;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	coalescing_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::cout << options.threads << " threads pacing at periods of " << options.period_us << " to " << options.period_us + options.spread_us
+		<< " us for " << options.duration_ms << " ms, lateness in microseconds, savings relative to the first tolerance\n"
+		<< std::right << std::setw(10) << "Tolerance" << std::setw(14) << "Wakeups/s" << std::setw(10) << "Saved" << std::setw(14) << "Switches/s"
+		<< std::setw(10) << "Saved" << std::setw(10) << "Mean" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "Max" << std::endl;
+	double baseline_wakeups = 0, baseline_switches = 0;
+	for (size_t i = 0; i < options.tolerances_us.size(); i++) {
+		coalescing_result result = run(options, options.tolerances_us[i]);
+		if (result.lateness_ns.empty()) {
+			std::cerr << "Error: the duration is shorter than the period, nothing was measured.\n";
+			return 1;
+		}
+		if (i == 0) {
+			baseline_wakeups = result.wakeups_per_second;
+			baseline_switches = result.switches_per_second;
+		}
+		double sum_ns = 0;
+		for (int64_t lateness_ns : result.lateness_ns) sum_ns += static_cast<double>(lateness_ns);
+		auto percentile = [&result](double fraction) { return static_cast<double>(result.lateness_ns[static_cast<size_t>(fraction * (result.lateness_ns.size() - 1))]) / 1'000.0; };
+		auto saved = [](double value, double baseline) { return baseline > 0 ? 100.0 * (1.0 - value / baseline) : 0.0; };
+		std::cout << std::fixed << std::setprecision(1) << std::setw(10) << options.tolerances_us[i]
+			<< std::setw(14) << result.wakeups_per_second << std::setw(9) << saved(result.wakeups_per_second, baseline_wakeups) << "%"
+			<< std::setw(14) << result.switches_per_second << std::setw(9) << saved(result.switches_per_second, baseline_switches) << "%"
+			<< std::setw(10) << sum_ns / static_cast<double>(result.lateness_ns.size()) / 1'000.0 << std::setw(10) << percentile(0.5)
+			<< std::setw(10) << percentile(0.99) << std::setw(10) << static_cast<double>(result.lateness_ns.back()) / 1'000.0 << std::endl;
+	}
+	#ifdef _WIN32
+	std::cerr << "Warning: context switch counts are not available on this platform, they are reported as zero.\n";
+	#endif /* _WIN32 */
+	return 0;
+}
@@ -0,0 +1,120 @@
+// System Libraries
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "coalescing_sleep.hpp"
+#include "high_resolution_sleep.hpp"
+
+using high_resolution_sleep::coalesced_wakeup_ns;
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_us_tolerant(uint32_t duration_us, uint32_t tolerance_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_us_tolerant(duration_us, tolerance_us);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	return start_end_times;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* coalesced_wakeup_ns Tests																	 */
+/*************************************************************************************************/
+TEST_CASE("Checking coalesced_wakeup_ns stays within the tolerance.", "[coalescing_sleep][test][short]") {
+	REQUIRE(coalesced_wakeup_ns(1'234'567, 0) == 1'234'567);
+	for (uint64_t tolerance_ns : {1ull, 3ull, 1'000ull, 65'536ull, 100'000ull, 1'000'000ull}) {
+		for (uint64_t deadline_ns = 1'000'000'000; deadline_ns < 1'000'000'000 + 3'000'000; deadline_ns += 7'919) {
+			uint64_t wakeup_ns = coalesced_wakeup_ns(deadline_ns, tolerance_ns);
+			REQUIRE(wakeup_ns >= deadline_ns);
+			REQUIRE(wakeup_ns - deadline_ns < tolerance_ns);
+		}
+	}
+	REQUIRE(coalesced_wakeup_ns(UINT64_MAX - 10, 1'000) == UINT64_MAX);
+}
+
+TEST_CASE("Checking coalesced_wakeup_ns puts nearby deadlines on a common instant.", "[coalescing_sleep][test][short]") {
+	// A tolerance of a millisecond rounds onto a grid of 2^19 ns, so deadlines within one step share an instant.
+	uint64_t base_ns = 1'000ull << 20;
+	REQUIRE(coalesced_wakeup_ns(base_ns + 10, 1'000'000) == base_ns + (1ull << 19));
+	REQUIRE(coalesced_wakeup_ns(base_ns + 500'000, 1'000'000) == base_ns + (1ull << 19));
+	REQUIRE(coalesced_wakeup_ns(base_ns + 10, 5'000'000) == base_ns + (1ull << 22));
+	// An instant on a coarse grid is on every finer grid, so a looser tolerance can land on the tighter one's instant.
+	REQUIRE(coalesced_wakeup_ns(coalesced_wakeup_ns(base_ns + 10, 4'194'304), 100'000) == coalesced_wakeup_ns(base_ns + 10, 4'194'304));
+}
+
+
+/*************************************************************************************************/
+/* sleep_us_tolerant Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking sleep_us_tolerant with sleep duration of 1 millisecond and tolerance of 100 microseconds.", "[coalescing_sleep][test][short]") {
+	uint32_t us = 1'000;
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times = test_sleep_us_tolerant(us, 100, 1 * (1'000'000 / us));
+	for (const auto &sample : start_end_times) REQUIRE(std::get<2>(sample) >= 0);
+	REQUIRE_NOTHROW(save_results(start_end_times, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_tolerant-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_tolerant with sleep duration of 250 microseconds and tolerance of 50 microseconds.", "[coalescing_sleep][test][short]") {
+	uint32_t us = 250;
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times = test_sleep_us_tolerant(us, 50, 0.5 * (1'000'000 / us));
+	for (const auto &sample : start_end_times) REQUIRE(std::get<2>(sample) >= 0);
+	REQUIRE_NOTHROW(save_results(start_end_times, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_tolerant-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_until_ns_tolerant coalesces the wakeups of many threads.", "[coalescing_sleep][test][short]") {
+	const uint32_t thread_count = 32;
+	high_resolution_sleep::wakeup_coalescer_stats start_stats = high_resolution_sleep::shared_wakeup_coalescer().stats();
+	// Every thread sleeps until a different deadline within the same millisecond.
+	uint64_t base_ns = (high_resolution_sleep::now_ns() + 100'000'000) & ~((1ull << 20) - 1);
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times(thread_count);
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < thread_count; t++) {
+		threads.emplace_back([&, t]() {
+			uint64_t deadline_ns = base_ns + 1 + t * 10'000;
+			high_resolution_sleep::sleep_until_ns_tolerant(deadline_ns, 1'048'576);
+			uint64_t end_ns = high_resolution_sleep::now_ns();
+			start_end_times[t] = std::make_tuple(deadline_ns, end_ns, end_ns - deadline_ns);
+		});
+	}
+	for (std::thread &thread : threads) thread.join();
+	high_resolution_sleep::wakeup_coalescer_stats end_stats = high_resolution_sleep::shared_wakeup_coalescer().stats();
+	for (const auto &sample : start_end_times) REQUIRE(std::get<2>(sample) >= 0);
+	REQUIRE(end_stats.leaders - start_stats.leaders == 1);
+	REQUIRE(end_stats.followers - start_stats.followers == thread_count - 1);
+	REQUIRE(end_stats.collisions == start_stats.collisions);
+	REQUIRE_NOTHROW(save_results(start_end_times, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns_tolerant-threads.csv"));
+}
+
+
+/*************************************************************************************************/
+/* Tolerant Sleep Benchmarks																	 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking sleep_us_tolerant.", "[coalescing_sleep][benchmark]") {
+	uint32_t us = 1'000;
+	BENCHMARK("1 millisecond with 100 microseconds tolerance"){ return high_resolution_sleep::sleep_us_tolerant(us, 100); };
+	us = 250;
+	BENCHMARK("250 microseconds with 50 microseconds tolerance"){ return high_resolution_sleep::sleep_us_tolerant(us, 50); };
+}
@@ -0,0 +1,307 @@
+// System Libraries
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "corrected_sleep.hpp"
+#include "high_resolution_sleep.hpp"
+
+using high_resolution_sleep::corrected_sleep_config;
+using high_resolution_sleep::CorrectedSleep;
+using high_resolution_sleep::ScheduleController;
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_corrected_sleep(uint64_t period_ns, uint32_t sample_count, uint64_t task_duration_us = 0) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	CorrectedSleep pacer(period_ns);
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		int64_t error_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		if (task_duration_us > 0) high_resolution_sleep::sleep_us(task_duration_us);
+		error_ns = pacer.sleep();
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, error_ns));
+	}
+	return start_end_times;
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_ms_corrected(uint32_t duration_ms, uint32_t sample_count, uint64_t task_duration_us = 0) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	int64_t error_us = 0;
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		uint64_t start_us;
+		start_ns = high_resolution_sleep::now_ns();
+		start_us = high_resolution_sleep::now_us();
+		high_resolution_sleep::sleep_us(task_duration_us);
+		high_resolution_sleep::sleep_ms_corrected(duration_ms, error_us);
+		error_us += ((int64_t)high_resolution_sleep::now_us() - (int64_t)start_us) - (duration_ms * 1'000);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, error_us * 1'000));
+	}
+	return start_end_times;
+}
+
+/**
+ * Gets the mean schedule error of the samples in the range [first, last).
+ */
+double mean_error_ns(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, size_t first, size_t last) {
+	double sum = 0;
+	for (size_t i = first; i < last; i++) sum += static_cast<double>(std::get<2>(start_end_times[i]));
+	return sum / static_cast<double>(last - first);
+}
+
+/**
+ * Gets the median magnitude of the schedule error of the samples in the range [first, last).
+ */
+int64_t median_absolute_error_ns(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, size_t first, size_t last) {
+	std::vector<int64_t> errors;
+	for (size_t i = first; i < last; i++) errors.push_back(std::abs(std::get<2>(start_end_times[i])));
+	std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
+	return errors[errors.size() / 2];
+}
+
+/**
+ * Gets the median schedule error of the samples in the range [first, last), which unlike the mean is
+ * not thrown off by catching up after the odd preemption.
+ */
+int64_t median_error_ns(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, size_t first, size_t last) {
+	std::vector<int64_t> errors;
+	for (size_t i = first; i < last; i++) errors.push_back(std::get<2>(start_end_times[i]));
+	std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
+	return errors[errors.size() / 2];
+}
+
+/**
+ * Checks the schedule error of a CorrectedSleep has settled to within a quarter of the period in the
+ * second half of the samples, printing the mean and median errors of both halves, and saves the results.
+ */
+void check_bounded(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, uint64_t period_ns, std::string file_name) {
+	size_t half = start_end_times.size() / 2;
+	std::cout << file_name << ": corrected sleep mean schedule error " << mean_error_ns(start_end_times, 0, half)
+		<< " ns in the first half and " << mean_error_ns(start_end_times, half, start_end_times.size())
+		<< " ns in the second half, median " << median_error_ns(start_end_times, 0, half) << " ns and "
+		<< median_error_ns(start_end_times, half, start_end_times.size()) << " ns" << std::endl;
+	REQUIRE(std::abs(median_error_ns(start_end_times, half, start_end_times.size())) < static_cast<int64_t>(period_ns / 4));
+	REQUIRE_NOTHROW(save_results(start_end_times, PROJECT_DIRECTORY + RESULTS_DIR + file_name));
+}
+
+/**
+ * Prints the median absolute schedule error of a CorrectedSleep and of sleep_ms_corrected in the same
+ * scenario in the second half of the samples, and saves the results. Used on its own for long periods,
+ * where too few periods fit in a run to compare the two reliably.
+ */
+void report_convergence(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &corrected_ms_start_end_times, std::string file_name) {
+	std::cout << file_name << ": sleep_ms_corrected median absolute schedule error "
+		<< median_absolute_error_ns(corrected_ms_start_end_times, corrected_ms_start_end_times.size() / 2, corrected_ms_start_end_times.size())
+		<< " ns, corrected sleep " << median_absolute_error_ns(start_end_times, start_end_times.size() / 2, start_end_times.size())
+		<< " ns in the second half" << std::endl;
+	REQUIRE_NOTHROW(save_results(start_end_times, PROJECT_DIRECTORY + RESULTS_DIR + file_name));
+}
+
+/**
+ * Checks a CorrectedSleep has held the schedule closer than sleep_ms_corrected did in the same scenario,
+ * comparing the median absolute schedule error of at least 50 samples in the second half of each.
+ */
+void check_convergence(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &corrected_ms_start_end_times, std::string file_name) {
+	REQUIRE(start_end_times.size() - start_end_times.size() / 2 >= 50);
+	REQUIRE(corrected_ms_start_end_times.size() - corrected_ms_start_end_times.size() / 2 >= 50);
+	report_convergence(start_end_times, corrected_ms_start_end_times, file_name);
+	REQUIRE(median_absolute_error_ns(start_end_times, start_end_times.size() / 2, start_end_times.size())
+		< median_absolute_error_ns(corrected_ms_start_end_times, corrected_ms_start_end_times.size() / 2, corrected_ms_start_end_times.size()));
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* ScheduleController Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking ScheduleController rejects invalid parameters.", "[corrected_sleep][test][short]") {
+	REQUIRE_THROWS_AS(ScheduleController(0), std::invalid_argument);
+	REQUIRE_THROWS_AS(ScheduleController(1'000'000, corrected_sleep_config{-0.5, 0.2, 0.25}), std::invalid_argument);
+	REQUIRE_THROWS_AS(ScheduleController(1'000'000, corrected_sleep_config{0.5, -0.2, 0.25}), std::invalid_argument);
+	REQUIRE_THROWS_AS(ScheduleController(1'000'000, corrected_sleep_config{0.5, 1.5, 0.25}), std::invalid_argument);
+	REQUIRE_THROWS_AS(ScheduleController(1'000'000, corrected_sleep_config{0.5, 0.2, 1.5}), std::invalid_argument);
+	REQUIRE_THROWS_AS(CorrectedSleep(0), std::invalid_argument);
+}
+
+TEST_CASE("Checking ScheduleController converges onto a constant slip.", "[corrected_sleep][test][short]") {
+	// Every wakeup lands 60 microseconds after the time asked for, like a kernel sleep, and each period
+	// is timed from the last wakeup, so the error carries over less the correction.
+	ScheduleController controller(100'000);
+	int64_t error_ns = 60'000;
+	for (int i = 0; i < 200; i++) {
+		controller.learn_slip(60'000);
+		error_ns += 60'000 - controller.update(error_ns);
+	}
+	REQUIRE(std::abs(error_ns) < 100);
+	REQUIRE(std::abs(controller.correction_ns() - 60'000) < 100);
+	REQUIRE(std::abs(controller.integral_ns() - 60'000) < 100);
+	controller.reset();
+	REQUIRE(controller.correction_ns() == 0);
+	REQUIRE(controller.integral_ns() == 0.0);
+}
+
+TEST_CASE("Checking ScheduleController limits the catch up rate without winding up.", "[corrected_sleep][test][short]") {
+	// A stall of ten periods only shortens the next period by a quarter of a period, without learning from it.
+	ScheduleController controller(1'000'000);
+	REQUIRE(controller.update(10'000'000) == 250'000);
+	REQUIRE(controller.integral_ns() == 0.0);
+	// A steady slip is learnt, but never past one period.
+	for (int i = 0; i < 1'000; i++) controller.learn_slip(2'000'000);
+	REQUIRE(controller.integral_ns() == 1'000'000.0);
+	REQUIRE(controller.update(100'000) == 1'050'000);
+}
+
+
+/*************************************************************************************************/
+/* CorrectedSleep Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking CorrectedSleep with a period of 1 millisecond.", "[corrected_sleep][test][short]") {
+	uint32_t us = 1'000;
+	check_bounded(test_corrected_sleep(us * 1'000, 1 * (1'000'000 / us)), us * 1'000, "corrected_sleep-" + std::to_string(us) + "us.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 500 microseconds.", "[corrected_sleep][test][short]") {
+	uint32_t us = 500;
+	check_bounded(test_corrected_sleep(us * 1'000, 1 * (1'000'000 / us)), us * 1'000, "corrected_sleep-" + std::to_string(us) + "us.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 250 microseconds.", "[corrected_sleep][test][short]") {
+	uint32_t us = 250;
+	check_bounded(test_corrected_sleep(us * 1'000, 1 * (1'000'000 / us)), us * 1'000, "corrected_sleep-" + std::to_string(us) + "us.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 100 microseconds.", "[corrected_sleep][test][short]") {
+	uint32_t us = 100;
+	check_bounded(test_corrected_sleep(us * 1'000, 1 * (1'000'000 / us)), us * 1'000, "corrected_sleep-" + std::to_string(us) + "us.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep catches up after a stall without back to back wakeups.", "[corrected_sleep][test][short]") {
+	// Without an integral term the wakeups may only be brought forward by the catch up limit.
+	corrected_sleep_config config{0.5, 0.0, 0.25};
+	CorrectedSleep pacer(1'000'000, config);
+	for (int i = 0; i < 5; i++) pacer.sleep();
+	// A stall of ten periods in the body of the loop.
+	high_resolution_sleep::sleep_ms(10);
+	pacer.sleep();
+	REQUIRE(pacer.error_ns() > 5'000'000);
+	std::vector<uint64_t> gaps_ns;
+	uint64_t last_wake_ns = pacer.deadline_ns() + pacer.error_ns();
+	while (pacer.error_ns() > 500'000 && gaps_ns.size() < 1'000) {
+		pacer.sleep();
+		uint64_t wake_ns = pacer.deadline_ns() + pacer.error_ns();
+		gaps_ns.push_back(wake_ns - last_wake_ns);
+		last_wake_ns = wake_ns;
+	}
+	REQUIRE(pacer.error_ns() <= 500'000);
+	// Catching up at most a quarter of a period per wakeup takes more than one wakeup per period stalled.
+	REQUIRE(gaps_ns.size() > 10);
+	for (const uint64_t gap_ns : gaps_ns) {
+		REQUIRE(gap_ns >= static_cast<uint64_t>((1.0 - config.max_catch_up) * 1'000'000));
+	}
+}
+
+TEST_CASE("Checking CorrectedSleep restarts its schedule when reset.", "[corrected_sleep][test][short]") {
+	CorrectedSleep pacer(1'000'000);
+	pacer.sleep();
+	uint64_t first_deadline_ns = pacer.deadline_ns();
+	// A stall of five periods is dropped by the reset rather than caught up.
+	high_resolution_sleep::sleep_ms(5);
+	pacer.reset();
+	uint64_t reset_ns = high_resolution_sleep::now_ns();
+	pacer.sleep();
+	REQUIRE(pacer.deadline_ns() >= reset_ns + 1'000'000);
+	REQUIRE(pacer.deadline_ns() >= first_deadline_ns + 5'000'000);
+	REQUIRE(pacer.error_ns() < 1'000'000);
+}
+
+
+/*************************************************************************************************/
+/* CorrectedSleep with 1 millisecond Task Duration Tests										 */
+/*************************************************************************************************/
+TEST_CASE("Checking CorrectedSleep with a period of 1 second and task duration of 1 millisecond.", "[corrected_sleep-task][test][long]") {
+	uint32_t ms = 1'000;
+	report_convergence(test_corrected_sleep(ms * 1'000'000, 10 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 10 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 500 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][long]") {
+	uint32_t ms = 500;
+	report_convergence(test_corrected_sleep(ms * 1'000'000, 10 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 10 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 250 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][long]") {
+	uint32_t ms = 250;
+	report_convergence(test_corrected_sleep(ms * 1'000'000, 10 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 10 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 50 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][short]") {
+	uint32_t ms = 50;
+	check_convergence(test_corrected_sleep(ms * 1'000'000, 5 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 5 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 10 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][short]") {
+	uint32_t ms = 10;
+	check_convergence(test_corrected_sleep(ms * 1'000'000, 1 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 1 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 5 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][short]") {
+	uint32_t ms = 5;
+	check_convergence(test_corrected_sleep(ms * 1'000'000, 1 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 1 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 4 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][short]") {
+	uint32_t ms = 4;
+	check_convergence(test_corrected_sleep(ms * 1'000'000, 1 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 1 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 3 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][short]") {
+	uint32_t ms = 3;
+	check_convergence(test_corrected_sleep(ms * 1'000'000, 1 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 1 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 2 milliseconds and task duration of 1 millisecond.", "[corrected_sleep-task][test][short]") {
+	uint32_t ms = 2;
+	check_convergence(test_corrected_sleep(ms * 1'000'000, 1 * (1000 / ms), 1'000), test_sleep_ms_corrected(ms, 1 * (1000 / ms), 1'000), "corrected_sleep-task-" + std::to_string(ms) + "ms.csv");
+}
+
+TEST_CASE("Checking CorrectedSleep with a period of 1 millisecond and task duration of 1 millisecond.", "[corrected_sleep-task][test][short]") {
+	// The task fills the whole period, so neither sleep can hold the schedule and only the results are saved.
+	uint32_t ms = 1;
+	REQUIRE_NOTHROW(save_results(test_corrected_sleep(ms * 1'000'000, 1 * (1000 / ms), 1'000), PROJECT_DIRECTORY + RESULTS_DIR + "corrected_sleep-task-" + std::to_string(ms) + "ms.csv"));
+}
+
+
+/*************************************************************************************************/
+/* CorrectedSleep Benchmarks																	 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking CorrectedSleep.", "[corrected_sleep][benchmark]") {
+	CorrectedSleep pacer_1ms(1'000'000);
+	BENCHMARK("1 millisecond"){ return pacer_1ms.sleep(); };
+	CorrectedSleep pacer_250us(250'000);
+	BENCHMARK("250 microseconds"){ return pacer_250us.sleep(); };
+	CorrectedSleep pacer_100us(100'000);
+	BENCHMARK("100 microseconds"){ return pacer_100us.sleep(); };
+}
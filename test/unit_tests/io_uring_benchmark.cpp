@@ -0,0 +1,194 @@
+/**
+ * @file 	io_uring_benchmark.cpp
+ * @brief 	io_uring_benchmark.cpp measures the throughput and accuracy of the IoUringEngine against the
+ * 			blocking sleep functions when one thread manages many deadlines.
+ * @details	The deadlines are spread evenly over a window and handled by one thread, first with the
+ * 			io_uring backend of the IoUringEngine, then with its Blocking fallback, then by calling
+ * 			sleep_until_ns for each deadline in turn. For each the tool reports the deadlines handled per
+ * 			second, the system calls made per deadline, the CPU time used and the lateness of the
+ * 			completions. Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Platform Dependant System Libraries
+#include <time.h>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "io_uring_engine.hpp"
+
+using high_resolution_sleep::IoUringEngine;
+using high_resolution_sleep::TimeoutBackend;
+using high_resolution_sleep::timeout_completion;
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct io_uring_options {
+	uint64_t timeouts = 50'000;
+	uint64_t window_ms = 1'000;
+	uint32_t entries = 4'096;
+	uint64_t lookahead_ms = 10;
+};
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --timeouts N         number of deadlines to handle (default 50000)\n"
+		<< "  --window-ms N        window the deadlines are spread evenly over in milliseconds (default 1000)\n"
+		<< "  --entries N          submission queue entries of the ring (default 4096)\n"
+		<< "  --lookahead-ms N     how far ahead of now the engine is given deadlines in milliseconds (default 10)\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+io_uring_options parse_options(int argc, char *argv[]) {
+	io_uring_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--timeouts") options.timeouts = std::stoull(value());
+		else if (argument == "--window-ms") options.window_ms = std::stoull(value());
+		else if (argument == "--entries") options.entries = static_cast<uint32_t>(std::stoul(value()));
+		else if (argument == "--lookahead-ms") options.lookahead_ms = std::stoull(value());
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.timeouts == 0 || options.window_ms == 0 || options.entries == 0) throw std::invalid_argument("--timeouts, --window-ms and --entries must be greater than zero");
+	return options;
+}
+
+/**
+ * Gets the CPU time consumed by the calling thread in nanoseconds.
+ */
+uint64_t thread_cpu_time_ns() {
+	struct timespec now;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+}
+
+/**
+ * Result of handling the deadlines one way.
+ */
+struct io_uring_result {
+	std::vector<int64_t> lateness_ns{};
+	uint64_t wall_ns = 0;
+	uint64_t cpu_ns = 0;
+	uint64_t system_calls = 0;
+};
+
+/**
+ * Gets the deadlines of a run, spread evenly over the window starting a little after now.
+ */
+std::vector<uint64_t> make_deadlines(const io_uring_options &options) {
+	std::vector<uint64_t> deadlines(options.timeouts);
+	const uint64_t start_ns = high_resolution_sleep::now_ns() + 10'000'000;
+	const uint64_t window_ns = options.window_ms * 1'000'000;
+	for (uint64_t i = 0; i < options.timeouts; i++) deadlines[i] = start_ns + (i + 1) * window_ns / options.timeouts;
+	return deadlines;
+}
+
+/**
+ * Handles the deadlines with an IoUringEngine of the given backend, scheduling each deadline once it
+ * is within the lookahead of now as a server handling a stream of requests would.
+ */
+io_uring_result run_engine(const io_uring_options &options, const TimeoutBackend backend) {
+	io_uring_result result;
+	result.lateness_ns.reserve(options.timeouts);
+	IoUringEngine engine(options.entries, backend);
+	const uint64_t start_cpu_ns = thread_cpu_time_ns();
+	const uint64_t start_ns = high_resolution_sleep::now_ns();
+	const std::vector<uint64_t> deadlines = make_deadlines(options);
+	const uint64_t lookahead_ns = options.lookahead_ms * 1'000'000;
+	size_t next = 0;
+	while (next < deadlines.size() || engine.size() > 0) {
+		const uint64_t horizon_ns = high_resolution_sleep::now_ns() + lookahead_ns;
+		for (; next < deadlines.size() && deadlines[next] <= horizon_ns; next++) {
+			const uint64_t deadline_ns = deadlines[next];
+			engine.schedule_at_ns(deadline_ns, [&result, deadline_ns](timeout_completion) {
+				result.lateness_ns.push_back(static_cast<int64_t>(high_resolution_sleep::now_ns() - deadline_ns));
+			});
+		}
+		engine.dispatch(1);
+	}
+	result.wall_ns = high_resolution_sleep::now_ns() - start_ns;
+	result.cpu_ns = thread_cpu_time_ns() - start_cpu_ns;
+	result.system_calls = engine.system_calls();
+	return result;
+}
+
+/**
+ * Handles the deadlines by calling sleep_until_ns for each in turn.
+ */
+io_uring_result run_sleep_until_ns(const io_uring_options &options) {
+	io_uring_result result;
+	result.lateness_ns.reserve(options.timeouts);
+	const uint64_t start_cpu_ns = thread_cpu_time_ns();
+	const uint64_t start_ns = high_resolution_sleep::now_ns();
+	for (const uint64_t deadline_ns : make_deadlines(options)) {
+		high_resolution_sleep::sleep_until_ns(deadline_ns);
+		result.lateness_ns.push_back(static_cast<int64_t>(high_resolution_sleep::now_ns() - deadline_ns));
+	}
+	result.wall_ns = high_resolution_sleep::now_ns() - start_ns;
+	result.cpu_ns = thread_cpu_time_ns() - start_cpu_ns;
+	result.system_calls = options.timeouts;
+	return result;
+}
+
+/**
+ * Prints the throughput and accuracy of one way of handling the deadlines.
+ */
+void print_result(const std::string &name, io_uring_result result) {
+	std::sort(result.lateness_ns.begin(), result.lateness_ns.end());
+	auto percentile = [&result](double fraction) { return static_cast<double>(result.lateness_ns[static_cast<size_t>(fraction * (result.lateness_ns.size() - 1))]) / 1'000.0; };
+	std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(16) << name << std::right
+		<< std::setw(14) << static_cast<double>(result.lateness_ns.size()) * 1e9 / static_cast<double>(result.wall_ns)
+		<< std::setw(14) << std::setprecision(4) << static_cast<double>(result.system_calls) / static_cast<double>(result.lateness_ns.size())
+		<< std::setw(10) << std::setprecision(1) << 100.0 * static_cast<double>(result.cpu_ns) / static_cast<double>(result.wall_ns) << "%"
+		<< std::setw(10) << percentile(0.5) << std::setw(10) << percentile(0.99) << std::setw(12) << static_cast<double>(result.lateness_ns.back()) / 1'000.0 << std::endl;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	io_uring_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::cout << options.timeouts << " deadlines over " << options.window_ms << " ms on one thread, lateness in microseconds\n"
+		<< std::left << std::setw(16) << "Method" << std::right << std::setw(14) << "Deadlines/s" << std::setw(14) << "Syscalls/each"
+		<< std::setw(11) << "CPU" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(12) << "Max" << std::endl;
+	if (high_resolution_sleep::io_uring_is_supported()) print_result("io_uring", run_engine(options, TimeoutBackend::IoUring));
+	else std::cerr << "Warning: io_uring timeouts are not supported, only the blocking methods are measured.\n";
+	print_result("blocking engine", run_engine(options, TimeoutBackend::Blocking));
+	print_result("sleep_until_ns", run_sleep_until_ns(options));
+	return 0;
+}
@@ -0,0 +1,244 @@
+// System Libraries
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Platform Dependant System Libraries
+#include <unistd.h>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "io_uring_engine.hpp"
+
+using high_resolution_sleep::IoUringEngine;
+using high_resolution_sleep::TimeoutBackend;
+using high_resolution_sleep::TimeoutStatus;
+using high_resolution_sleep::timeout_completion;
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_io_uring_engine(uint32_t duration_us, uint32_t sample_count, TimeoutBackend backend = TimeoutBackend::Automatic) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	IoUringEngine engine(64, backend);
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns = 0;
+		start_ns = high_resolution_sleep::now_ns();
+		engine.schedule_at_ns(start_ns + duration_us * 1'000, [&end_ns](timeout_completion completion) { end_ns = high_resolution_sleep::now_ns(); });
+		while (end_ns == 0) engine.dispatch(1);
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	return start_end_times;
+}
+
+/**
+ * Checks a batch of timeouts scheduled out of order all expire, none of them early.
+ */
+void check_batch(TimeoutBackend backend) {
+	IoUringEngine engine(64, backend);
+	std::vector<int64_t> lateness_ns;
+	uint64_t start_ns = high_resolution_sleep::now_ns() + 1'000'000;
+	// More timeouts than submission queue entries, scheduled in reverse.
+	for (uint64_t i = 500; i > 0; i--) {
+		uint64_t deadline_ns = start_ns + i * 10'000;
+		engine.schedule_at_ns(deadline_ns, [&lateness_ns, deadline_ns](timeout_completion completion) {
+			REQUIRE(completion.status == TimeoutStatus::Expired);
+			lateness_ns.push_back(static_cast<int64_t>(high_resolution_sleep::now_ns() - deadline_ns));
+		});
+	}
+	while (engine.size() > 0) engine.dispatch(1);
+	REQUIRE(lateness_ns.size() == 500);
+	for (int64_t lateness : lateness_ns) REQUIRE(lateness >= 0);
+	// The batch took far fewer system calls than timeouts.
+	REQUIRE(engine.system_calls() < 500);
+}
+
+/**
+ * Checks a cancelled timeout completes as cancelled without waiting for its deadline.
+ */
+void check_cancel(TimeoutBackend backend) {
+	IoUringEngine engine(64, backend);
+	timeout_completion cancelled{}, expired{};
+	auto handle = engine.schedule_after_ns(10'000'000'000, [&cancelled](timeout_completion completion) { cancelled = completion; });
+	engine.schedule_after_ns(1'000'000, [&expired](timeout_completion completion) { expired = completion; });
+	engine.submit();
+	REQUIRE(engine.cancel(handle));
+	REQUIRE_FALSE(engine.cancel(handle));
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	while (engine.size() > 0) engine.dispatch(1);
+	REQUIRE(high_resolution_sleep::now_ns() - start_ns < 1'000'000'000);
+	REQUIRE(cancelled.status == TimeoutStatus::Cancelled);
+	REQUIRE(expired.status == TimeoutStatus::Expired);
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* IoUringEngine Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking IoUringEngine with sleep duration of 10 milliseconds.", "[io_uring_engine][test][short]") {
+	uint32_t us = 10'000;
+	REQUIRE_NOTHROW(save_results(test_io_uring_engine(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "io_uring_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking IoUringEngine with sleep duration of 1 millisecond.", "[io_uring_engine][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_io_uring_engine(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "io_uring_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking IoUringEngine with sleep duration of 250 microseconds.", "[io_uring_engine][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_io_uring_engine(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "io_uring_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking IoUringEngine with sleep duration of 50 microseconds.", "[io_uring_engine][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_io_uring_engine(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "io_uring_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking IoUringEngine falls back to blocking with sleep duration of 1 millisecond.", "[io_uring_engine][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_io_uring_engine(us, 1 * (1'000'000 / us), TimeoutBackend::Blocking), PROJECT_DIRECTORY + RESULTS_DIR + "io_uring_engine_blocking-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking IoUringEngine picks the io_uring backend only where it is supported.", "[io_uring_engine][test][short]") {
+	IoUringEngine engine;
+	if (high_resolution_sleep::io_uring_is_supported()) {
+		REQUIRE(engine.backend() == TimeoutBackend::IoUring);
+		REQUIRE(engine.fd() >= 0);
+	}
+	else {
+		REQUIRE(engine.backend() == TimeoutBackend::Blocking);
+		REQUIRE(engine.fd() == -1);
+		REQUIRE_THROWS_AS(IoUringEngine(64, TimeoutBackend::IoUring), std::system_error);
+	}
+	REQUIRE(IoUringEngine(64, TimeoutBackend::Blocking).backend() == TimeoutBackend::Blocking);
+}
+
+TEST_CASE("Checking IoUringEngine expires a batch of timeouts.", "[io_uring_engine][test][short]") {
+	if (high_resolution_sleep::io_uring_is_supported()) check_batch(TimeoutBackend::IoUring);
+	check_batch(TimeoutBackend::Blocking);
+}
+
+TEST_CASE("Checking IoUringEngine cancels timeouts.", "[io_uring_engine][test][short]") {
+	if (high_resolution_sleep::io_uring_is_supported()) check_cancel(TimeoutBackend::IoUring);
+	check_cancel(TimeoutBackend::Blocking);
+}
+
+TEST_CASE("Checking IoUringEngine keeps timeouts scheduled while another thread dispatches.", "[io_uring_engine][test][short]") {
+	// A small ring fills up while the dispatching thread is submitting outside the lock.
+	IoUringEngine engine(8);
+	const int count = 5'000;
+	std::atomic<int> completed{0};
+	uint64_t end_ns = high_resolution_sleep::now_ns() + 10'000'000'000;
+	std::thread dispatcher([&]() {
+		while (completed < count && high_resolution_sleep::now_ns() < end_ns) {
+			// A near timeout ends each wait, so a lost timeout fails the test rather than hanging it.
+			engine.schedule_after_ns(1'000'000, [](timeout_completion) {});
+			engine.dispatch(1);
+		}
+	});
+	for (int i = 0; i < count; i++) {
+		engine.schedule_after_ns(10'000 + (i % 64) * 1'000, [&completed](timeout_completion) { completed++; });
+	}
+	engine.submit();
+	dispatcher.join();
+	REQUIRE(completed == count);
+}
+
+TEST_CASE("Checking IoUringEngine completes futures.", "[io_uring_engine][test][short]") {
+	IoUringEngine engine;
+	uint64_t deadline_ns = high_resolution_sleep::now_ns() + 1'000'000;
+	std::future<timeout_completion> future = engine.sleep_until_ns(deadline_ns);
+	while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) engine.dispatch(1);
+	timeout_completion completion = future.get();
+	REQUIRE(completion.status == TimeoutStatus::Expired);
+	REQUIRE(completion.completed_ns >= deadline_ns);
+}
+
+TEST_CASE("Checking IoUringEngine bounds an operation with a linked timeout.", "[io_uring_engine][test][short]") {
+	if (!high_resolution_sleep::io_uring_is_supported()) {
+		REQUIRE_THROWS_AS(IoUringEngine(64, TimeoutBackend::Blocking).schedule_with_timeout_ns([](io_uring_sqe &sqe) {}, 0, [](timeout_completion completion) {}), std::logic_error);
+		return;
+	}
+	IoUringEngine engine;
+	int pipe_fds[2];
+	REQUIRE(pipe(pipe_fds) == 0);
+	char buffer[8];
+	auto prepare_read = [&](io_uring_sqe &sqe) {
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = pipe_fds[0];
+		sqe.addr = reinterpret_cast<uint64_t>(buffer);
+		sqe.len = sizeof(buffer);
+	};
+	// A read of an empty pipe is cancelled at the deadline.
+	timeout_completion timed_out{TimeoutStatus::Completed};
+	uint64_t deadline_ns = high_resolution_sleep::now_ns() + 2'000'000;
+	engine.schedule_with_timeout_ns(prepare_read, deadline_ns, [&timed_out](timeout_completion completion) { timed_out = completion; });
+	while (engine.size() > 0) engine.dispatch(1);
+	REQUIRE(timed_out.status == TimeoutStatus::Expired);
+	REQUIRE(timed_out.completed_ns >= deadline_ns);
+	// A read of a pipe with data completes before the deadline.
+	REQUIRE(write(pipe_fds[1], "sleep", 5) == 5);
+	timeout_completion completed{TimeoutStatus::Expired};
+	engine.schedule_with_timeout_ns(prepare_read, high_resolution_sleep::now_ns() + 1'000'000'000, [&completed](timeout_completion completion) { completed = completion; });
+	while (engine.size() > 0) engine.dispatch(1);
+	REQUIRE(completed.status == TimeoutStatus::Completed);
+	REQUIRE(completed.result == 5);
+	// A cancelled read completes as cancelled.
+	timeout_completion cancelled{TimeoutStatus::Expired};
+	auto handle = engine.schedule_with_timeout_ns(prepare_read, high_resolution_sleep::now_ns() + 10'000'000'000, [&cancelled](timeout_completion completion) { cancelled = completion; });
+	engine.submit();
+	REQUIRE(engine.cancel(handle));
+	while (engine.size() > 0) engine.dispatch(1);
+	REQUIRE(cancelled.status == TimeoutStatus::Cancelled);
+	// A read that completed before its cancellation reached the kernel completes with its result.
+	REQUIRE(write(pipe_fds[1], "sleep", 5) == 5);
+	timeout_completion raced{TimeoutStatus::Expired};
+	handle = engine.schedule_with_timeout_ns(prepare_read, high_resolution_sleep::now_ns() + 1'000'000'000, [&raced](timeout_completion completion) { raced = completion; });
+	engine.submit();
+	REQUIRE(engine.cancel(handle));
+	while (engine.size() > 0) engine.dispatch(1);
+	REQUIRE(raced.status == TimeoutStatus::Completed);
+	REQUIRE(raced.result == 5);
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+}
+
+
+/*************************************************************************************************/
+/* IoUringEngine Benchmarks																		 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking IoUringEngine.", "[io_uring_engine][benchmark]") {
+	IoUringEngine engine;
+	uint64_t us = 1'000;
+	BENCHMARK("1 millisecond") {
+		engine.schedule_after_ns(us * 1'000, [](timeout_completion completion) {});
+		return engine.dispatch(1);
+	};
+	us = 250;
+	BENCHMARK("250 microseconds") {
+		engine.schedule_after_ns(us * 1'000, [](timeout_completion completion) {});
+		return engine.dispatch(1);
+	};
+	us = 50;
+	BENCHMARK("50 microseconds") {
+		engine.schedule_after_ns(us * 1'000, [](timeout_completion completion) {});
+		return engine.dispatch(1);
+	};
+}
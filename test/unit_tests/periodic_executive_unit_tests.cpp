@@ -0,0 +1,153 @@
+// System Libraries
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "periodic_executive.hpp"
+
+using high_resolution_sleep::OverrunPolicy;
+using high_resolution_sleep::PeriodicExecutive;
+
+/**
+ * Runs an executive with one task per period for the given duration, recording the scheduled release
+ * time, the time the callback started, and the difference between the two for every call.
+ */
+std::vector<std::vector<std::tuple<uint64_t, uint64_t, int64_t>>> test_periodic_executive(std::vector<uint64_t> periods_us, uint64_t run_duration_ms) {
+	std::vector<std::vector<std::tuple<uint64_t, uint64_t, int64_t>>> release_times(periods_us.size());
+	PeriodicExecutive executive;
+	for (size_t i = 0; i < periods_us.size(); i++) {
+		release_times[i].reserve(run_duration_ms * 1'000 / periods_us[i] + 1);
+		executive.add_task(periods_us[i] * 1'000, [&release_times, i](uint64_t release_ns, uint64_t releases) {
+			uint64_t start_ns = high_resolution_sleep::now_ns();
+			release_times[i].push_back(std::make_tuple(release_ns, start_ns, start_ns - release_ns));
+		});
+	}
+	executive.run_until_ns(high_resolution_sleep::now_ns() + run_duration_ms * 1'000'000);
+	return release_times;
+}
+
+/**
+ * Runs a 1 millisecond task that takes 3.5 milliseconds on every 100th call for the given duration
+ * and returns the number of calls and the number of releases that the calls covered.
+ */
+std::tuple<uint64_t, uint64_t> test_overrun_policy(OverrunPolicy policy, uint64_t run_duration_ms) {
+	uint64_t calls = 0, releases_covered = 0;
+	PeriodicExecutive executive;
+	executive.add_task(1'000'000, [&](uint64_t release_ns, uint64_t releases) {
+		calls++;
+		releases_covered += releases;
+		if (calls % 100 == 0) high_resolution_sleep::sleep_us(3'500);
+	}, 0, policy);
+	executive.run_until_ns(high_resolution_sleep::now_ns() + run_duration_ms * 1'000'000);
+	return std::make_tuple(calls, releases_covered);
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* PeriodicExecutive Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking PeriodicExecutive with tasks at 1 kHz, 250 Hz and 10 Hz.", "[periodic_executive][test][short]") {
+	std::vector<uint64_t> periods_us = {1'000, 4'000, 100'000};
+	auto release_times = test_periodic_executive(periods_us, 1'000);
+	for (size_t i = 0; i < periods_us.size(); i++) {
+		REQUIRE(release_times[i].size() > 0);
+		REQUIRE(release_times[i].size() <= 1'000'000 / periods_us[i]);
+		REQUIRE_NOTHROW(save_results(release_times[i], PROJECT_DIRECTORY + RESULTS_DIR + "periodic_executive-" + std::to_string(periods_us[i]) + "us.csv"));
+	}
+}
+
+TEST_CASE("Checking PeriodicExecutive releases tasks at their phase offset.", "[periodic_executive][test][short]") {
+	uint64_t first_release_ns = 0, start_ns = high_resolution_sleep::now_ns();
+	PeriodicExecutive executive;
+	executive.add_task(10'000'000, [&](uint64_t release_ns, uint64_t releases) {
+		if (first_release_ns == 0) first_release_ns = release_ns;
+	}, 2'000'000);
+	executive.run_until_ns(start_ns + 15'000'000);
+	REQUIRE(first_release_ns >= start_ns + 2'000'000);
+	REQUIRE(first_release_ns < start_ns + 3'000'000);
+}
+
+TEST_CASE("Checking PeriodicExecutive stops when requested from a task.", "[periodic_executive][test][short]") {
+	uint64_t calls = 0;
+	PeriodicExecutive executive;
+	executive.add_task(1'000'000, [&](uint64_t release_ns, uint64_t releases) {
+		if (++calls == 10) executive.stop();
+	});
+	executive.run();
+	REQUIRE(calls == 10);
+	REQUIRE_FALSE(executive.is_running());
+}
+
+TEST_CASE("Checking PeriodicExecutive stops from another thread without waiting for the next release.", "[periodic_executive][test][short]") {
+	std::atomic<uint64_t> calls{0};
+	PeriodicExecutive executive;
+	// The first release is immediate and the second is a second later.
+	executive.add_task(1'000'000'000, [&](uint64_t release_ns, uint64_t releases) { calls++; });
+	std::thread stopper([&]() {
+		while (calls == 0) std::this_thread::yield();
+		high_resolution_sleep::sleep_ms(10);
+		executive.stop();
+	});
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	executive.run();
+	stopper.join();
+	REQUIRE(high_resolution_sleep::now_ns() - start_ns < 500'000'000);
+	REQUIRE(calls == 1);
+	REQUIRE_FALSE(executive.is_running());
+}
+
+TEST_CASE("Checking PeriodicExecutive rejects a zero period.", "[periodic_executive][test][short]") {
+	PeriodicExecutive executive;
+	REQUIRE_THROWS_AS(executive.add_task(0, [](uint64_t release_ns, uint64_t releases) {}), std::invalid_argument);
+}
+
+TEST_CASE("Checking PeriodicExecutive overrun policies with a task that overruns every 100 releases.", "[periodic_executive][test][short]") {
+	// Over 1 second there are 1000 releases, each overrun misses at least two of them.
+	auto [skip_calls, skip_releases] = test_overrun_policy(OverrunPolicy::Skip, 1'000);
+	auto [catch_up_calls, catch_up_releases] = test_overrun_policy(OverrunPolicy::CatchUp, 1'000);
+	auto [coalesce_calls, coalesce_releases] = test_overrun_policy(OverrunPolicy::Coalesce, 1'000);
+
+	// Skipping drops the missed releases entirely.
+	REQUIRE(skip_calls == skip_releases);
+	REQUIRE(skip_releases < 990);
+	// Catching up runs every release with its own call.
+	REQUIRE(catch_up_calls == catch_up_releases);
+	REQUIRE(catch_up_releases >= 990);
+	// Coalescing covers every release but with fewer calls.
+	REQUIRE(coalesce_calls < coalesce_releases);
+	REQUIRE(coalesce_releases >= 990);
+}
+
+
+/*************************************************************************************************/
+/* PeriodicExecutive Benchmarks																	 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking PeriodicExecutive.", "[periodic_executive][benchmark]") {
+	BENCHMARK("100 releases of a 100 microsecond task") {
+		uint64_t calls = 0;
+		PeriodicExecutive executive;
+		executive.add_task(100'000, [&](uint64_t release_ns, uint64_t releases) {
+			if (++calls == 100) executive.stop();
+		});
+		executive.run();
+		return calls;
+	};
+}
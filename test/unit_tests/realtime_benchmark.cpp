@@ -0,0 +1,204 @@
+/**
+ * @file 	realtime_benchmark.cpp
+ * @brief 	realtime_benchmark.cpp compares the accuracy of the sleep functions under the default scheduling
+ * 			and a real-time profile.
+ * @details	For every function and duration the tool runs the same sleeps on a realtime_thread with the
+ * 			default profile and then with a SCHED_FIFO profile pinned to one core with locked memory and a
+ * 			pre-faulted stack, and reports the scheduling each run obtained and its overshoot percentiles.
+ * 			Real-time scheduling needs elevated privileges (e.g. CAP_SYS_NICE and CAP_IPC_LOCK on Linux),
+ * 			without which both runs use the default scheduling. Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "realtime_thread.hpp"
+
+using high_resolution_sleep::realtime_profile;
+using high_resolution_sleep::realtime_status;
+using high_resolution_sleep::realtime_thread;
+using high_resolution_sleep::SchedulingPolicy;
+
+/// Functions that can be measured, in the order they are run by --function all.
+const static std::vector<std::string> FUNCTIONS = {"sleep_ms", "sleep_us"};
+
+/// Durations of the former unit test comparisons in microseconds, measured by default.
+const static std::vector<uint64_t> DEFAULT_DURATIONS_US = {1'000, 250, 50, 10};
+
+/// Total time each run sleeps for when the number of samples is not given.
+const static uint64_t DEFAULT_SCENARIO_TIME_US = 500'000;
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct realtime_options {
+	std::vector<std::string> functions = FUNCTIONS;
+	std::vector<uint64_t> durations_us = DEFAULT_DURATIONS_US;
+	uint64_t samples = 0;
+	int priority = 80;
+	int cpu = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1;
+	std::string csv_file{};
+};
+
+/**
+ * Parses a comma separated list of numbers.
+ */
+std::vector<uint64_t> parse_list(const std::string &text) {
+	std::vector<uint64_t> values;
+	std::stringstream list(text);
+	std::string value;
+	while (std::getline(list, value, ',')) values.push_back(std::stoull(value));
+	return values;
+}
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --function NAME      sleep function: sleep_ms, sleep_us or all (default), sleep_ms only runs whole milliseconds\n"
+		<< "  --durations-us LIST  comma separated sleep durations in microseconds (default 1000, 250, 50, 10)\n"
+		<< "  --samples N          sleeps per run (default enough for " << DEFAULT_SCENARIO_TIME_US / 1'000 << " ms, between 100 and 25000)\n"
+		<< "  --priority N         SCHED_FIFO priority of the real-time run (default 80)\n"
+		<< "  --cpu N              core the real-time run is pinned to (default the last core)\n"
+		<< "  --csv FILE           also write the summary of every run to a CSV file\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+realtime_options parse_options(int argc, char *argv[]) {
+	realtime_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--function") {
+			std::string function = value();
+			if (function == "all") options.functions = FUNCTIONS;
+			else if (std::find(FUNCTIONS.begin(), FUNCTIONS.end(), function) != FUNCTIONS.end()) options.functions = {function};
+			else throw std::invalid_argument("unknown function " + function);
+		}
+		else if (argument == "--durations-us") options.durations_us = parse_list(value());
+		else if (argument == "--samples") options.samples = std::stoull(value());
+		else if (argument == "--priority") options.priority = std::stoi(value());
+		else if (argument == "--cpu") options.cpu = std::stoi(value());
+		else if (argument == "--csv") options.csv_file = value();
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	for (uint64_t duration_us : options.durations_us) {
+		if (duration_us == 0 || duration_us > UINT32_MAX) throw std::invalid_argument("--durations-us must be between 1 and " + std::to_string(UINT32_MAX));
+	}
+	if (options.cpu < 0) throw std::invalid_argument("--cpu must not be negative");
+	return options;
+}
+
+/**
+ * Sleeps for the duration with the named function.
+ */
+void sleep_with(const std::string &function, const uint64_t duration_us) {
+	if (function == "sleep_ms") high_resolution_sleep::sleep_ms(static_cast<uint32_t>(duration_us / 1'000));
+	else high_resolution_sleep::sleep_us(static_cast<uint32_t>(duration_us));
+}
+
+/**
+ * Gets a percentile of sorted values.
+ */
+int64_t percentile(const std::vector<int64_t> &sorted, const double fraction) {
+	return sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+}
+
+/**
+ * Runs the sleeps of one function and duration on a realtime_thread with the given profile, printing
+ * the scheduling it obtained and its summary, appending it to the CSV if one is open.
+ */
+void run_profile(const std::string &function, const uint64_t duration_us, const uint64_t samples, const std::string &profile_name, const realtime_profile &profile, std::ofstream &csv) {
+	std::vector<int64_t> overshoots_ns;
+	overshoots_ns.reserve(samples);
+	realtime_thread thread(profile, [&]() {
+		for (uint64_t i = 0; i < samples; i++) {
+			const uint64_t start_ns = high_resolution_sleep::now_ns();
+			sleep_with(function, duration_us);
+			overshoots_ns.push_back(static_cast<int64_t>(high_resolution_sleep::now_ns() - start_ns) - static_cast<int64_t>(duration_us * 1'000));
+		}
+	});
+	const realtime_status status = thread.status();
+	thread.join();
+	std::sort(overshoots_ns.begin(), overshoots_ns.end());
+	std::string obtained = status.is_realtime() ? "fifo " + std::to_string(status.priority) : "default";
+	if (status.affinity_applied) obtained += ", pinned";
+	if (status.memory_locked) obtained += ", locked";
+	auto us = [](int64_t ns) { return static_cast<double>(ns) / 1'000.0; };
+
+	std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(10) << function << std::right << std::setw(10) << duration_us
+		<< "  " << std::left << std::setw(10) << profile_name << std::setw(26) << obtained << std::right
+		<< std::setw(10) << us(percentile(overshoots_ns, 0.5)) << std::setw(10) << us(percentile(overshoots_ns, 0.99))
+		<< std::setw(10) << us(percentile(overshoots_ns, 0.999)) << std::setw(12) << us(overshoots_ns.back()) << std::endl;
+	if (csv.is_open()) {
+		csv << function << "," << duration_us << "," << profile_name << "," << (status.is_realtime() ? 1 : 0) << "," << status.priority
+			<< "," << (status.affinity_applied ? 1 : 0) << "," << (status.memory_locked ? 1 : 0) << "," << percentile(overshoots_ns, 0.5)
+			<< "," << percentile(overshoots_ns, 0.99) << "," << percentile(overshoots_ns, 0.999) << "," << overshoots_ns.back() << "\n";
+	}
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	realtime_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::ofstream csv;
+	if (!options.csv_file.empty()) {
+		csv.open(options.csv_file);
+		if (!csv) {
+			std::cerr << "Error: could not open " << options.csv_file << "\n";
+			return 1;
+		}
+		csv << "Function,Duration (us),Profile,Real-Time,Priority,Pinned,Memory Locked,p50 (ns),p99 (ns),p99.9 (ns),Max (ns)\n";
+	}
+
+	const realtime_profile default_profile = {SchedulingPolicy::Default, 0, {}, false, false};
+	const realtime_profile fifo_profile = {SchedulingPolicy::Fifo, options.priority, {options.cpu}, true, true};
+	std::cout << "Overshoots in microseconds, obtained is the scheduling the run actually got\n"
+		<< std::left << std::setw(10) << "Function" << std::right << std::setw(10) << "Duration"
+		<< "  " << std::left << std::setw(10) << "Profile" << std::setw(26) << "Obtained" << std::right
+		<< std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "Max" << std::endl;
+	for (const std::string &function : options.functions) {
+		for (uint64_t duration_us : options.durations_us) {
+			if (function == "sleep_ms" && duration_us % 1'000 != 0) continue;
+			const uint64_t samples = options.samples > 0 ? options.samples : std::clamp<uint64_t>(DEFAULT_SCENARIO_TIME_US / duration_us, 100, 25'000);
+			run_profile(function, duration_us, samples, "default", default_profile, csv);
+			run_profile(function, duration_us, samples, "realtime", fifo_profile, csv);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,55 @@
+// System Libraries
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+// Unit Test Headers
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Sleep Headers
+#include "realtime_thread.hpp"
+
+using high_resolution_sleep::realtime_profile;
+using high_resolution_sleep::realtime_status;
+using high_resolution_sleep::realtime_thread;
+using high_resolution_sleep::SchedulingPolicy;
+
+/// Profile that leaves the thread with the default scheduling of the system.
+const static realtime_profile DEFAULT_PROFILE = {SchedulingPolicy::Default, 0, {}, false, false};
+/// Profile that requests SCHED_FIFO on the last CPU with locked memory and a pre-faulted stack.
+const static realtime_profile REALTIME_PROFILE = {SchedulingPolicy::Fifo, 80, {static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1}, true, true};
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* realtime_thread Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking apply_realtime_profile with the default policy.", "[realtime_thread][test][short]") {
+	realtime_status status;
+	realtime_thread thread(DEFAULT_PROFILE, []() {});
+	status = thread.status();
+	thread.join();
+	REQUIRE(status.policy_applied);
+	REQUIRE_FALSE(status.is_realtime());
+	REQUIRE_FALSE(status.memory_locked);
+	REQUIRE_FALSE(status.stack_prefaulted);
+}
+
+TEST_CASE("Checking realtime_thread falls back cleanly and reports the scheduling it obtained.", "[realtime_thread][test][short]") {
+	uint64_t sum = 0;
+	realtime_thread thread(REALTIME_PROFILE, [&sum](uint64_t a, uint64_t b) { sum = a + b; }, 2, 3);
+	realtime_status status = thread.status();
+	thread.join();
+	REQUIRE(sum == 5);
+	REQUIRE(status.stack_prefaulted);
+	// Without privileges the thread keeps the default policy, and with them it gets the requested one.
+	REQUIRE(status.policy_applied == status.is_realtime());
+	if (status.policy_applied) REQUIRE(status.policy == SchedulingPolicy::Fifo);
+}
@@ -0,0 +1,200 @@
+// System Libraries
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// ASIO Header
+#include <asio.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "sleep_awaitable.hpp"
+
+/**
+ * Minimal coroutine type that starts eagerly and destroys itself when it finishes.
+ */
+struct detached_task {
+	struct promise_type {
+		detached_task get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+detached_task pace_with_after(uint32_t duration_us, uint32_t sample_count, std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, std::atomic<uint32_t> &finished) {
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		co_await high_resolution_sleep::after(std::chrono::microseconds(duration_us));
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	finished.fetch_add(1);
+}
+
+detached_task pace_with_until(uint32_t period_us, uint32_t sample_count, std::tuple<uint64_t, uint64_t, int64_t> *wake_times, std::atomic<uint32_t> &finished) {
+	uint64_t deadline_ns = high_resolution_sleep::now_ns();
+	for (int i = 0; i < sample_count; i++) {
+		deadline_ns += period_us * 1'000;
+		co_await high_resolution_sleep::until(deadline_ns);
+		uint64_t end_ns = high_resolution_sleep::now_ns();
+		wake_times[i] = std::make_tuple(deadline_ns - period_us * 1'000, end_ns, end_ns - deadline_ns);
+	}
+	finished.fetch_add(1);
+}
+
+detached_task wait_until_steady_clock(std::chrono::steady_clock::time_point deadline, std::chrono::steady_clock::time_point &resumed, std::atomic<uint32_t> &finished) {
+	co_await high_resolution_sleep::until(deadline);
+	resumed = std::chrono::steady_clock::now();
+	finished.fetch_add(1);
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_after(uint32_t duration_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	std::atomic<uint32_t> finished{0};
+	pace_with_after(duration_us, sample_count, start_end_times, finished);
+	while (finished.load() == 0) std::this_thread::yield();
+	return start_end_times;
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_until_concurrent(uint32_t period_us, uint32_t sample_count, uint32_t coroutine_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> wake_times(sample_count * coroutine_count);
+	std::atomic<uint32_t> finished{0};
+	for (uint32_t i = 0; i < coroutine_count; i++) {
+		pace_with_until(period_us, sample_count, &wake_times[i * sample_count], finished);
+	}
+	while (finished.load() < coroutine_count) high_resolution_sleep::sleep_ms(1);
+	return wake_times;
+}
+
+asio::awaitable<void> asio_pace(uint32_t duration_us, uint32_t sample_count, std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times) {
+	asio::high_resolution_timer timer{co_await asio::this_coro::executor};
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		timer.expires_after(std::chrono::microseconds(duration_us));
+		co_await timer.async_wait(asio::use_awaitable);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_asio_awaitable(uint32_t duration_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	asio::io_context context;
+	asio::co_spawn(context, asio_pace(duration_us, sample_count, start_end_times), asio::detached);
+	context.run();
+	return start_end_times;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* after Tests																					 */
+/*************************************************************************************************/
+TEST_CASE("Checking co_await after with sleep duration of 10 milliseconds.", "[sleep_awaitable][test][short]") {
+	uint32_t us = 10'000;
+	REQUIRE_NOTHROW(save_results(test_after(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking co_await after with sleep duration of 1 millisecond.", "[sleep_awaitable][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_after(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking co_await after with sleep duration of 500 microseconds.", "[sleep_awaitable][test][short]") {
+	uint32_t us = 500;
+	REQUIRE_NOTHROW(save_results(test_after(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking co_await after with sleep duration of 250 microseconds.", "[sleep_awaitable][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_after(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking co_await after with sleep duration of 50 microseconds.", "[sleep_awaitable][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_after(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking co_await after with sleep duration of 10 microseconds.", "[sleep_awaitable][test][short]") {
+	uint32_t us = 10;
+	REQUIRE_NOTHROW(save_results(test_after(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+
+/*************************************************************************************************/
+/* until Tests																					 */
+/*************************************************************************************************/
+TEST_CASE("Checking co_await until with 1000 coroutines pacing at 1 millisecond.", "[sleep_awaitable][test][short]") {
+	uint32_t us = 1'000;
+	auto wake_times = test_until_concurrent(us, 100, 1'000);
+	for (auto [start, end, error] : wake_times) REQUIRE(error >= 0);
+	REQUIRE_NOTHROW(save_results(wake_times, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_awaitable-concurrent-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking co_await until with a std::chrono::steady_clock deadline.", "[sleep_awaitable][test][short]") {
+	std::atomic<uint32_t> finished{0};
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1), resumed;
+	wait_until_steady_clock(deadline, resumed, finished);
+	while (finished.load() == 0) high_resolution_sleep::sleep_ms(1);
+	REQUIRE(resumed >= deadline);
+}
+
+
+/*************************************************************************************************/
+/* ASIO Awaitable Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking ASIO awaitable timers with sleep duration of 1 millisecond.", "[sleep_awaitable][asio][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_asio_awaitable(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "asio_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking ASIO awaitable timers with sleep duration of 250 microseconds.", "[sleep_awaitable][asio][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_asio_awaitable(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "asio_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking ASIO awaitable timers with sleep duration of 50 microseconds.", "[sleep_awaitable][asio][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_asio_awaitable(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "asio_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking ASIO awaitable timers with sleep duration of 10 microseconds.", "[sleep_awaitable][asio][test][short]") {
+	uint32_t us = 10;
+	REQUIRE_NOTHROW(save_results(test_asio_awaitable(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "asio_awaitable-" + std::to_string(us) + "us.csv"));
+}
+
+
+/*************************************************************************************************/
+/* Awaitable Benchmarks																			 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking co_await after against sleep_us and ASIO awaitable timers.", "[sleep_awaitable][benchmark]") {
+	for (uint32_t us : {1'000u, 250u, 50u, 10u}) {
+		BENCHMARK("co_await after " + std::to_string(us) + " microseconds") { return test_after(us, 1); };
+		BENCHMARK("sleep_us " + std::to_string(us) + " microseconds") { return high_resolution_sleep::sleep_us(us); };
+		BENCHMARK("ASIO awaitable " + std::to_string(us) + " microseconds") { return test_asio_awaitable(us, 1); };
+	}
+}
@@ -0,0 +1,280 @@
+/**
+ * @file 	sleep_jitter.cpp
+ * @brief 	sleep_jitter.cpp is a cyclictest style tool that measures the wakeup latency of a periodic
+ * 			loop for one of the sleep strategies, optionally under synthetic background load.
+ * @details	The measuring thread wakes up at absolute deadlines spaced by the period and records how late
+ * 			each wakeup was. Background load threads can hog the CPU, thrash memory bandwidth, or make a
+ * 			storm of system calls, each pinned round robin to a configurable set of cores, so the
+ * 			degradation of the timing on a busy host can be sized before deploying to it. Run with
+ * 			--help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif /* WIN32_LEAN_AND_MEAN */
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif /* NOMINMAX */
+	#include <windows.h>
+#else
+	#include <sched.h>
+	#include <unistd.h>
+#endif /* _WIN32 */
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "realtime_thread.hpp"
+#include "sleep_trace.hpp"
+
+using high_resolution_sleep::realtime_profile;
+using high_resolution_sleep::realtime_thread;
+using high_resolution_sleep::SchedulingPolicy;
+
+/// Number of bytes each memory bandwidth hog copies back and forth, larger than most last level caches.
+const static size_t MEMORY_HOG_BYTES = 64 * 1'024 * 1'024;
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct jitter_options {
+	std::string strategy = "sleep_until_ns";
+	uint64_t period_us = 1'000;
+	uint64_t loops = 10'000;
+	bool realtime = false;
+	int priority = 80;
+	int cpu = -1;
+	uint32_t cpu_hogs = 0;
+	uint32_t memory_hogs = 0;
+	uint32_t syscall_hogs = 0;
+	std::vector<int> load_cpus{};
+	std::string trace_file{};
+};
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --strategy NAME      sleep strategy: sleep_until_ns (default), sleep_us, sleep_ms"
+	#ifndef _WIN32
+		<< ", hybrid"
+	#endif /* _WIN32 */
+		<< "\n"
+		<< "  --period-us N        period of the wakeup loop in microseconds (default 1000)\n"
+		<< "  --loops N            number of wakeups to measure (default 10000)\n"
+		<< "  --realtime           run the measuring thread with SCHED_FIFO and locked memory\n"
+		<< "  --priority N         real-time priority of the measuring thread (default 80)\n"
+		<< "  --cpu N              core to pin the measuring thread to\n"
+		<< "  --cpu-hogs N         number of threads busy looping on the CPU\n"
+		<< "  --memory-hogs N      number of threads copying " << MEMORY_HOG_BYTES / (1'024 * 1'024) << " MB buffers to use memory bandwidth\n"
+		<< "  --syscall-hogs N     number of threads making system calls back to back\n"
+		<< "  --load-cpus LIST     comma separated cores to pin the load threads to round robin\n"
+		<< "  --trace FILE         write every wakeup to a binary sleep trace\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+jitter_options parse_options(int argc, char *argv[]) {
+	jitter_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--strategy") options.strategy = value();
+		else if (argument == "--period-us") options.period_us = std::stoull(value());
+		else if (argument == "--loops") options.loops = std::stoull(value());
+		else if (argument == "--realtime") options.realtime = true;
+		else if (argument == "--priority") options.priority = std::stoi(value());
+		else if (argument == "--cpu") options.cpu = std::stoi(value());
+		else if (argument == "--cpu-hogs") options.cpu_hogs = std::stoul(value());
+		else if (argument == "--memory-hogs") options.memory_hogs = std::stoul(value());
+		else if (argument == "--syscall-hogs") options.syscall_hogs = std::stoul(value());
+		else if (argument == "--load-cpus") {
+			std::stringstream list(value());
+			std::string cpu;
+			while (std::getline(list, cpu, ',')) options.load_cpus.push_back(std::stoi(cpu));
+		}
+		else if (argument == "--trace") options.trace_file = value();
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.strategy != "sleep_until_ns" && options.strategy != "sleep_us" && options.strategy != "sleep_ms"
+	#ifndef _WIN32
+		&& options.strategy != "hybrid"
+	#endif /* _WIN32 */
+	) throw std::invalid_argument("unknown strategy " + options.strategy);
+	if (options.period_us == 0 || options.loops == 0) throw std::invalid_argument("--period-us and --loops must be greater than zero");
+	if (options.strategy == "sleep_ms" && options.period_us % 1'000 != 0) throw std::invalid_argument("sleep_ms needs a period that is a whole number of milliseconds");
+	return options;
+}
+
+/*************************************************************************************************/
+/* Background Load																				 */
+/*************************************************************************************************/
+void cpu_hog(const std::atomic<bool> &stop) {
+	volatile uint64_t value = 1;
+	while (!stop.load(std::memory_order_relaxed)) {
+		for (int i = 0; i < 1'000; i++) value = value * 6'364'136'223'846'793'005ull + 1;
+	}
+}
+
+void memory_hog(const std::atomic<bool> &stop) {
+	std::vector<char> source(MEMORY_HOG_BYTES, 1), destination(MEMORY_HOG_BYTES, 0);
+	while (!stop.load(std::memory_order_relaxed)) {
+		std::memcpy(destination.data(), source.data(), MEMORY_HOG_BYTES);
+		std::swap(source, destination);
+	}
+}
+
+void syscall_hog(const std::atomic<bool> &stop) {
+	while (!stop.load(std::memory_order_relaxed)) {
+		#ifdef _WIN32
+		SwitchToThread();
+		Sleep(0);
+		#else
+		getppid();
+		sched_yield();
+		#endif /* _WIN32 */
+	}
+}
+
+/*************************************************************************************************/
+/* Wakeup Loop																					 */
+/*************************************************************************************************/
+/**
+ * Runs the periodic wakeup loop and returns the latency of every wakeup in nanoseconds, recording
+ * each wakeup into the trace records if a trace is wanted.
+ */
+std::vector<int64_t> measure_wakeups(const jitter_options &options, std::vector<high_resolution_sleep::sleep_trace_record> &trace) {
+	std::vector<int64_t> latencies;
+	latencies.reserve(options.loops);
+	if (!options.trace_file.empty()) trace.reserve(options.loops);
+
+	const uint64_t period_ns = options.period_us * 1'000;
+	high_resolution_sleep::SleepStrategy strategy = high_resolution_sleep::SleepStrategy::SleepUntilNs;
+	if (options.strategy == "sleep_us") strategy = high_resolution_sleep::SleepStrategy::SleepUs;
+	else if (options.strategy == "sleep_ms") strategy = high_resolution_sleep::SleepStrategy::SleepMs;
+	else if (options.strategy == "hybrid") strategy = high_resolution_sleep::SleepStrategy::SleepUsHybrid;
+
+	uint64_t deadline_ns = high_resolution_sleep::now_ns() + period_ns;
+	for (uint64_t i = 0; i < options.loops; i++) {
+		const uint64_t start_ns = high_resolution_sleep::now_ns();
+		const uint64_t remaining_ns = deadline_ns > start_ns ? deadline_ns - start_ns : 0;
+		// Relative sleeps are rounded up to their unit so that they never aim to wake before the deadline.
+		switch (strategy) {
+			case high_resolution_sleep::SleepStrategy::SleepUs:
+				high_resolution_sleep::sleep_us(static_cast<uint32_t>((remaining_ns + 999) / 1'000));
+				break;
+			case high_resolution_sleep::SleepStrategy::SleepMs:
+				high_resolution_sleep::sleep_ms(static_cast<uint32_t>((remaining_ns + 999'999) / 1'000'000));
+				break;
+			#ifndef _WIN32
+			case high_resolution_sleep::SleepStrategy::SleepUsHybrid:
+				high_resolution_sleep::sleep_until_ns_hybrid(deadline_ns, high_resolution_sleep::hybrid_sleep_config{});
+				break;
+			#endif /* _WIN32 */
+			default:
+				high_resolution_sleep::sleep_until_ns(deadline_ns);
+				break;
+		}
+		const uint64_t end_ns = high_resolution_sleep::now_ns();
+		latencies.push_back(static_cast<int64_t>(end_ns) - static_cast<int64_t>(deadline_ns));
+		if (!options.trace_file.empty()) {
+			trace.push_back(high_resolution_sleep::sleep_trace_record{start_ns, end_ns, remaining_ns, static_cast<uint32_t>(strategy), 0});
+		}
+		deadline_ns += period_ns;
+	}
+	return latencies;
+}
+
+/**
+ * Prints the summary of the wakeup latencies in microseconds.
+ */
+void print_summary(const jitter_options &options, std::vector<int64_t> latencies) {
+	std::sort(latencies.begin(), latencies.end());
+	double sum = 0;
+	for (int64_t latency : latencies) sum += static_cast<double>(latency);
+	auto percentile = [&latencies](double fraction) { return latencies[static_cast<size_t>(fraction * (latencies.size() - 1))]; };
+	auto us = [](double ns) { return ns / 1'000.0; };
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Strategy " << options.strategy << ", period " << options.period_us << " us, " << latencies.size() << " wakeups, "
+		<< options.cpu_hogs << " CPU hogs, " << options.memory_hogs << " memory hogs, " << options.syscall_hogs << " syscall hogs\n"
+		<< "Wakeup latency (us): min " << us(latencies.front())
+		<< " avg " << us(sum / latencies.size())
+		<< " p50 " << us(percentile(0.5))
+		<< " p99 " << us(percentile(0.99))
+		<< " p99.9 " << us(percentile(0.999))
+		<< " max " << us(latencies.back()) << std::endl;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	jitter_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	// Start the background load, pinning each thread to the next of the load cores.
+	std::atomic<bool> stop_load{false};
+	std::vector<realtime_thread> load_threads;
+	auto start_load = [&](uint32_t count, void (*hog)(const std::atomic<bool> &)) {
+		for (uint32_t i = 0; i < count; i++) {
+			realtime_profile profile{SchedulingPolicy::Default, 0, {}, false, false};
+			if (!options.load_cpus.empty()) profile.cpus = {options.load_cpus[load_threads.size() % options.load_cpus.size()]};
+			load_threads.emplace_back(profile, hog, std::cref(stop_load));
+		}
+	};
+	start_load(options.cpu_hogs, cpu_hog);
+	start_load(options.memory_hogs, memory_hog);
+	start_load(options.syscall_hogs, syscall_hog);
+
+	// Run the wakeup loop on a thread of its own with the requested scheduling.
+	realtime_profile profile{SchedulingPolicy::Default, 0, {}, false, false};
+	if (options.realtime) profile = realtime_profile{SchedulingPolicy::Fifo, options.priority, {}, true, true};
+	if (options.cpu >= 0) profile.cpus = {options.cpu};
+	std::vector<int64_t> latencies;
+	std::vector<high_resolution_sleep::sleep_trace_record> trace;
+	realtime_thread measuring_thread(profile, [&]() { latencies = measure_wakeups(options, trace); });
+	high_resolution_sleep::realtime_status status = measuring_thread.status();
+	measuring_thread.join();
+
+	stop_load = true;
+	for (realtime_thread &thread : load_threads) thread.join();
+
+	if (options.realtime && !status.is_realtime()) std::cerr << "Warning: real-time scheduling was not available, measured with the default scheduling.\n";
+	if (options.cpu >= 0 && !status.affinity_applied) std::cerr << "Warning: the measuring thread could not be pinned to core " << options.cpu << ".\n";
+	print_summary(options, latencies);
+	if (!options.trace_file.empty()) high_resolution_sleep::write_sleep_trace(trace, options.trace_file);
+	return 0;
+}
@@ -0,0 +1,151 @@
+// Enable the instrumentation of the sleep functions for these tests.
+#define HIGH_RESOLUTION_SLEEP_INSTRUMENTATION
+
+// System Libraries
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "sleep_latency_histogram.hpp"
+
+using high_resolution_sleep::ConcurrentLatencyHistogram;
+using high_resolution_sleep::InstrumentedSleep;
+using high_resolution_sleep::LatencyHistogram;
+
+/**
+ * Prints the count and overshoot percentiles of a sleep function from a snapshot.
+ */
+void print_overshoot(std::string name, const high_resolution_sleep::sleep_latency_snapshot &snapshot, InstrumentedSleep function) {
+	const LatencyHistogram &overshoot = snapshot.overshoot(function);
+	std::cout << name << ": " << overshoot.count() << " calls, overshoot p50 " << overshoot.percentile(0.5) << " ns, p99 "
+		<< overshoot.percentile(0.99) << " ns, p99.9 " << overshoot.percentile(0.999) << " ns, max " << overshoot.max() << " ns" << std::endl;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* LatencyHistogram Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking every value lies within the bounds of its bucket.", "[sleep_latency_histogram][test][short]") {
+	std::vector<uint64_t> values = {0, 1, 31, 32, 33, 63, 64, 1'000, 50'000, 1'000'000, 123'456'789, UINT64_MAX / 3, UINT64_MAX};
+	for (uint64_t value = 1; value < (static_cast<uint64_t>(1) << 62); value = value * 3 + 1) values.push_back(value);
+	for (uint64_t value : values) {
+		size_t index = high_resolution_sleep::latency_histogram_index(value);
+		REQUIRE(index < high_resolution_sleep::latency_histogram_buckets);
+		REQUIRE(high_resolution_sleep::latency_histogram_lowest_value(index) <= value);
+		REQUIRE(high_resolution_sleep::latency_histogram_highest_value(index) >= value);
+		// Buckets are never wider than 1/16th of their lowest value.
+		uint64_t lowest = high_resolution_sleep::latency_histogram_lowest_value(index);
+		REQUIRE(high_resolution_sleep::latency_histogram_highest_value(index) - lowest <= (lowest >> 4));
+	}
+}
+
+TEST_CASE("Checking LatencyHistogram percentiles of a uniform distribution.", "[sleep_latency_histogram][test][short]") {
+	LatencyHistogram histogram;
+	REQUIRE(histogram.percentile(0.99) == 0);
+	for (uint64_t value = 1; value <= 100'000; value++) histogram.record(value);
+	REQUIRE(histogram.count() == 100'000);
+	// Each percentile is reported to within the 6.25% precision of the histogram.
+	REQUIRE(histogram.percentile(0.5) >= 50'000);
+	REQUIRE(histogram.percentile(0.5) <= 53'125);
+	REQUIRE(histogram.percentile(0.99) >= 99'000);
+	REQUIRE(histogram.percentile(0.99) <= 105'188);
+	REQUIRE(histogram.max() >= 100'000);
+}
+
+TEST_CASE("Checking ConcurrentLatencyHistogram snapshots while its writer is recording.", "[sleep_latency_histogram][test][short]") {
+	ConcurrentLatencyHistogram histogram;
+	std::atomic<bool> done = false;
+	std::thread writer([&]() {
+		for (uint64_t i = 0; i < 1'000'000; i++) histogram.record(i % 1'000);
+		done = true;
+	});
+	uint64_t previous_count = 0;
+	while (!done) {
+		LatencyHistogram snapshot;
+		histogram.snapshot_into(snapshot);
+		// Counters only ever grow, so successive snapshots never go backwards.
+		REQUIRE(snapshot.count() >= previous_count);
+		previous_count = snapshot.count();
+	}
+	writer.join();
+	LatencyHistogram snapshot;
+	histogram.snapshot_into(snapshot);
+	REQUIRE(snapshot.count() == 1'000'000);
+}
+
+/*************************************************************************************************/
+/* Instrumentation Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking sleeps on exited threads are kept in snapshots.", "[sleep_latency_histogram][test][short]") {
+	uint64_t before = high_resolution_sleep::snapshot_sleep_latency().overshoot(InstrumentedSleep::SleepUs).count();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([]() {
+			for (int i = 0; i < 100; i++) high_resolution_sleep::sleep_us(50);
+		});
+	}
+	for (std::thread &thread : threads) thread.join();
+	auto snapshot = high_resolution_sleep::snapshot_sleep_latency();
+	REQUIRE(snapshot.overshoot(InstrumentedSleep::SleepUs).count() == before + 400);
+	REQUIRE(snapshot.requested(InstrumentedSleep::SleepUs).percentile(1.0) >= 50'000);
+}
+
+TEST_CASE("Checking sleep_ms_corrected is recorded once with its corrected duration.", "[sleep_latency_histogram][test][short]") {
+	auto before = high_resolution_sleep::snapshot_sleep_latency();
+	high_resolution_sleep::sleep_ms_corrected(3, 1'000);
+	auto after = high_resolution_sleep::snapshot_sleep_latency();
+	REQUIRE(after.requested(InstrumentedSleep::SleepMsCorrected).count() == before.requested(InstrumentedSleep::SleepMsCorrected).count() + 1);
+	// The inner sleep_ms call is not recorded separately.
+	REQUIRE(after.requested(InstrumentedSleep::SleepMs).count() == before.requested(InstrumentedSleep::SleepMs).count());
+	REQUIRE(after.requested(InstrumentedSleep::SleepMsCorrected).percentile(1.0) >= 2'000'000);
+}
+
+TEST_CASE("Checking instrumented sleep_ms and sleep_us overshoot percentiles.", "[sleep_latency_histogram][test][short]") {
+	for (int i = 0; i < 500; i++) high_resolution_sleep::sleep_ms(1);
+	for (int i = 0; i < 5'000; i++) high_resolution_sleep::sleep_us(50);
+	auto snapshot = high_resolution_sleep::snapshot_sleep_latency();
+	REQUIRE(snapshot.overshoot(InstrumentedSleep::SleepMs).count() >= 500);
+	REQUIRE(snapshot.overshoot(InstrumentedSleep::SleepUs).count() >= 5'000);
+	print_overshoot("sleep_ms", snapshot, InstrumentedSleep::SleepMs);
+	print_overshoot("sleep_ms_corrected", snapshot, InstrumentedSleep::SleepMsCorrected);
+	print_overshoot("sleep_us", snapshot, InstrumentedSleep::SleepUs);
+}
+
+
+/*************************************************************************************************/
+/* LatencyHistogram Benchmarks																	 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking sleep latency recording.", "[sleep_latency_histogram][benchmark]") {
+	ConcurrentLatencyHistogram histogram;
+	uint64_t value = 12'345;
+	BENCHMARK("ConcurrentLatencyHistogram::record") {
+		histogram.record(value);
+		return value;
+	};
+	BENCHMARK("sleep_latency_recorder around an empty scope") {
+		high_resolution_sleep::sleep_latency_recorder recorder(InstrumentedSleep::SleepUs, 0);
+		return value;
+	};
+	BENCHMARK("snapshot_sleep_latency") {
+		return high_resolution_sleep::snapshot_sleep_latency().overshoot(InstrumentedSleep::SleepUs).count();
+	};
+	BENCHMARK("instrumented sleep_us 1 microsecond") {
+		return high_resolution_sleep::sleep_us(1);
+	};
+}
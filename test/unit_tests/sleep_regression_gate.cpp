@@ -0,0 +1,329 @@
+/**
+ * @file 	sleep_regression_gate.cpp
+ * @brief 	sleep_regression_gate.cpp runs a fixed set of sleep accuracy scenarios and either saves them as
+ * 			a baseline or compares them against a saved baseline, exiting non-zero on a regression.
+ * @details	Each scenario records the overshoot of every sleep and the CPU time used per sleep, measured
+ * 			over batches of calls. A comparison flags a scenario as regressed only when the change is
+ * 			both statistically significant under a one-sided Mann-Whitney U test and larger than the
+ * 			tolerance, so the gate ignores run to run noise but catches real changes to the p99
+ * 			overshoot or the CPU cost of the sleep functions. Baselines are a summary CSV for people
+ * 			plus a binary sleep trace of the raw overshoots for each scenario. Run with --help for the
+ * 			options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+	#include <time.h>
+#endif /* _WIN32 */
+
+// Directory Config Headers
+#include "DirectoryConfig.hpp"
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "sleep_trace.hpp"
+
+using high_resolution_sleep::sleep_trace_record;
+using high_resolution_sleep::SleepStrategy;
+
+/// Number of batches the CPU time of each scenario is measured over.
+const static uint32_t CPU_BATCHES = 30;
+/// Name of the summary file in a baseline directory.
+const static std::string SUMMARY_FILE = "baseline-summary.csv";
+
+/**
+ * Options of the gate, set from the command line.
+ */
+struct gate_options {
+	bool save = false;
+	std::string baseline_directory = std::string(PROJECT_DIRECTORY) + "/test/baselines";
+	double scale = 1.0;
+	double tolerance = 0.10;
+	double floor_ns = 1'000.0;
+	double alpha = 0.01;
+};
+
+/**
+ * A sleep scenario: the function and duration to sleep for and the number of samples to take.
+ */
+struct scenario {
+	std::string function;
+	SleepStrategy strategy;
+	uint64_t duration_ns;
+	uint32_t samples;
+	std::function<void()> sleep;
+
+	std::string name() const {
+		return function + "-" + std::to_string(duration_ns) + "ns";
+	}
+};
+
+/**
+ * The measurements of a scenario: the raw sleeps and the CPU nanoseconds per call of each batch.
+ */
+struct scenario_result {
+	std::vector<sleep_trace_record> sleeps;
+	std::vector<double> cpu_ns_per_call;
+};
+
+/**
+ * Gets the CPU time used by the calling thread in nanoseconds.
+ */
+uint64_t thread_cpu_ns() {
+	#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+	auto to_ns = [](FILETIME time) { return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100; };
+	return to_ns(kernel) + to_ns(user);
+	#else
+	struct timespec now;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+	#endif /* _WIN32 */
+}
+
+/**
+ * Gets the scenarios run by the gate, with sample counts multiplied by the scale.
+ */
+std::vector<scenario> gate_scenarios(double scale) {
+	auto samples = [scale](uint32_t count) { return std::max(CPU_BATCHES, static_cast<uint32_t>(count * scale)); };
+	return {
+		{"sleep_ms", SleepStrategy::SleepMs, 1'000'000, samples(1'000), []() { high_resolution_sleep::sleep_ms(1); }},
+		{"sleep_us", SleepStrategy::SleepUs, 1'000'000, samples(1'000), []() { high_resolution_sleep::sleep_us(1'000); }},
+		{"sleep_us", SleepStrategy::SleepUs, 250'000, samples(2'000), []() { high_resolution_sleep::sleep_us(250); }},
+		{"sleep_us", SleepStrategy::SleepUs, 50'000, samples(5'000), []() { high_resolution_sleep::sleep_us(50); }},
+		{"sleep_us", SleepStrategy::SleepUs, 10'000, samples(20'000), []() { high_resolution_sleep::sleep_us(10); }},
+		{"sleep_us", SleepStrategy::SleepUs, 1'000, samples(50'000), []() { high_resolution_sleep::sleep_us(1); }},
+		{"sleep_until_ns", SleepStrategy::SleepUntilNs, 250'000, samples(2'000), []() { high_resolution_sleep::sleep_until_ns(high_resolution_sleep::now_ns() + 250'000); }},
+	};
+}
+
+/**
+ * Runs a scenario, measuring each sleep and the CPU time of each batch of sleeps.
+ */
+scenario_result run_scenario(const scenario &s) {
+	scenario_result result;
+	result.sleeps.reserve(s.samples);
+	const uint32_t batch_size = s.samples / CPU_BATCHES;
+	for (uint32_t batch = 0; batch < CPU_BATCHES; batch++) {
+		const uint64_t cpu_start_ns = thread_cpu_ns();
+		for (uint32_t i = 0; i < batch_size; i++) {
+			const uint64_t start_ns = high_resolution_sleep::now_ns();
+			s.sleep();
+			const uint64_t end_ns = high_resolution_sleep::now_ns();
+			result.sleeps.push_back(sleep_trace_record{start_ns, end_ns, s.duration_ns, static_cast<uint32_t>(s.strategy), 0});
+		}
+		result.cpu_ns_per_call.push_back(static_cast<double>(thread_cpu_ns() - cpu_start_ns) / batch_size);
+	}
+	return result;
+}
+
+/**
+ * Gets the sorted overshoots in nanoseconds of a set of sleeps.
+ */
+std::vector<double> overshoots(const std::vector<sleep_trace_record> &sleeps) {
+	std::vector<double> values;
+	values.reserve(sleeps.size());
+	for (const sleep_trace_record &sleep : sleeps) values.push_back(static_cast<double>(static_cast<int64_t>(sleep.end_ns - sleep.start_ns - sleep.requested_ns)));
+	std::sort(values.begin(), values.end());
+	return values;
+}
+
+/**
+ * Gets a percentile of sorted values.
+ */
+double percentile(const std::vector<double> &sorted, double fraction) {
+	return sorted.empty() ? 0.0 : sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+}
+
+/**
+ * Gets the mean of values.
+ */
+double mean(const std::vector<double> &values) {
+	double sum = 0;
+	for (double value : values) sum += value;
+	return values.empty() ? 0.0 : sum / values.size();
+}
+
+/**
+ * Gets the one-sided p-value of a Mann-Whitney U test that the candidate values tend to be larger than
+ * the baseline values, using the normal approximation with a correction for ties.
+ */
+double mann_whitney_greater_p(const std::vector<double> &baseline, const std::vector<double> &candidate) {
+	const double n1 = static_cast<double>(baseline.size()), n2 = static_cast<double>(candidate.size()), n = n1 + n2;
+	if (n1 == 0 || n2 == 0) return 1.0;
+	std::vector<std::pair<double, bool>> combined;
+	combined.reserve(baseline.size() + candidate.size());
+	for (double value : baseline) combined.emplace_back(value, false);
+	for (double value : candidate) combined.emplace_back(value, true);
+	std::sort(combined.begin(), combined.end());
+
+	// Sum the ranks of the candidate values, giving tied values the average of their ranks.
+	double candidate_rank_sum = 0, tie_term = 0;
+	for (size_t i = 0; i < combined.size();) {
+		size_t j = i;
+		while (j < combined.size() && combined[j].first == combined[i].first) j++;
+		const double tied = static_cast<double>(j - i), average_rank = (i + 1 + j) / 2.0;
+		for (size_t k = i; k < j; k++) if (combined[k].second) candidate_rank_sum += average_rank;
+		tie_term += tied * tied * tied - tied;
+		i = j;
+	}
+	const double u = candidate_rank_sum - n2 * (n2 + 1) / 2;
+	const double variance = n1 * n2 / 12 * ((n + 1) - tie_term / (n * (n - 1)));
+	if (variance <= 0) return 1.0;
+	const double z = (u - n1 * n2 / 2 - 0.5) / std::sqrt(variance);
+	return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/*************************************************************************************************/
+/* Baselines																					 */
+/*************************************************************************************************/
+/**
+ * Saves the results of the scenarios as a baseline.
+ */
+void save_baseline(const gate_options &options, const std::vector<scenario> &scenarios, const std::vector<scenario_result> &results) {
+	std::filesystem::create_directories(options.baseline_directory);
+	std::ofstream summary(options.baseline_directory + "/" + SUMMARY_FILE);
+	summary << std::fixed << std::setprecision(1);
+	summary << "Scenario,Function,Requested ns,Samples,p50 ns,p99 ns,p99.9 ns,Max ns,CPU ns per call,CPU batches\n";
+	for (size_t i = 0; i < scenarios.size(); i++) {
+		std::vector<double> sorted = overshoots(results[i].sleeps);
+		summary << scenarios[i].name() << "," << scenarios[i].function << "," << scenarios[i].duration_ns << "," << sorted.size() << ","
+			<< percentile(sorted, 0.5) << "," << percentile(sorted, 0.99) << "," << percentile(sorted, 0.999) << "," << sorted.back() << ","
+			<< mean(results[i].cpu_ns_per_call) << ",";
+		for (size_t b = 0; b < results[i].cpu_ns_per_call.size(); b++) summary << (b ? " " : "") << results[i].cpu_ns_per_call[b];
+		summary << "\n";
+		high_resolution_sleep::write_sleep_trace(results[i].sleeps, options.baseline_directory + "/" + scenarios[i].name() + ".trace");
+	}
+}
+
+/**
+ * Loads the CPU batches of every scenario in a baseline summary, by scenario name.
+ */
+std::vector<std::pair<std::string, std::vector<double>>> load_cpu_batches(const gate_options &options) {
+	std::ifstream summary(options.baseline_directory + "/" + SUMMARY_FILE);
+	if (!summary) throw std::runtime_error("no baseline found in " + options.baseline_directory + ", create one with --save");
+	std::vector<std::pair<std::string, std::vector<double>>> batches;
+	std::string line;
+	std::getline(summary, line);
+	while (std::getline(summary, line)) {
+		std::stringstream columns(line);
+		std::string scenario_name, column;
+		std::getline(columns, scenario_name, ',');
+		for (int i = 0; i < 9; i++) std::getline(columns, column, ',');
+		std::stringstream values(column);
+		std::vector<double> cpu_ns_per_call;
+		for (double value; values >> value;) cpu_ns_per_call.push_back(value);
+		batches.emplace_back(scenario_name, cpu_ns_per_call);
+	}
+	return batches;
+}
+
+/**
+ * Compares the results of the scenarios against the baseline, printing a report, and returns true if
+ * any scenario regressed.
+ */
+bool compare_baseline(const gate_options &options, const std::vector<scenario> &scenarios, const std::vector<scenario_result> &results) {
+	auto cpu_batches = load_cpu_batches(options);
+	bool regressed = false;
+	std::cout << std::fixed << std::setprecision(0)
+		<< std::left << std::setw(24) << "Scenario" << std::right
+		<< std::setw(14) << "base p99 ns" << std::setw(14) << "new p99 ns" << std::setw(10) << "p-value"
+		<< std::setw(14) << "base CPU ns" << std::setw(14) << "new CPU ns" << std::setw(10) << "p-value" << "  Verdict\n";
+	for (size_t i = 0; i < scenarios.size(); i++) {
+		auto baseline_batches = std::find_if(cpu_batches.begin(), cpu_batches.end(), [&](const auto &entry) { return entry.first == scenarios[i].name(); });
+		if (baseline_batches == cpu_batches.end()) {
+			std::cout << std::left << std::setw(24) << scenarios[i].name() << std::right << "  not in baseline, skipped\n";
+			continue;
+		}
+		std::vector<double> baseline = overshoots(high_resolution_sleep::read_sleep_trace(options.baseline_directory + "/" + scenarios[i].name() + ".trace"));
+		std::vector<double> candidate = overshoots(results[i].sleeps);
+		const double baseline_p99 = percentile(baseline, 0.99), candidate_p99 = percentile(candidate, 0.99);
+		const double overshoot_p = mann_whitney_greater_p(baseline, candidate);
+		const double baseline_cpu = mean(baseline_batches->second), candidate_cpu = mean(results[i].cpu_ns_per_call);
+		const double cpu_p = mann_whitney_greater_p(baseline_batches->second, results[i].cpu_ns_per_call);
+
+		// A regression must be both significant and larger than the tolerance to fail the gate.
+		const bool overshoot_regressed = overshoot_p < options.alpha && candidate_p99 > baseline_p99 * (1 + options.tolerance) + options.floor_ns;
+		const bool cpu_regressed = cpu_p < options.alpha && candidate_cpu > baseline_cpu * (1 + options.tolerance) + options.floor_ns;
+		regressed = regressed || overshoot_regressed || cpu_regressed;
+
+		std::cout << std::left << std::setw(24) << scenarios[i].name() << std::right
+			<< std::setw(14) << baseline_p99 << std::setw(14) << candidate_p99 << std::setw(10) << std::setprecision(4) << overshoot_p << std::setprecision(0)
+			<< std::setw(14) << baseline_cpu << std::setw(14) << candidate_cpu << std::setw(10) << std::setprecision(4) << cpu_p << std::setprecision(0)
+			<< "  " << (overshoot_regressed ? "OVERSHOOT REGRESSED " : "") << (cpu_regressed ? "CPU REGRESSED" : "")
+			<< (!overshoot_regressed && !cpu_regressed ? "ok" : "") << "\n";
+	}
+	return regressed;
+}
+
+/**
+ * Prints the usage of the gate.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --save               save the run as the new baseline instead of comparing against it\n"
+		<< "  --baseline DIR       baseline directory (default " << gate_options{}.baseline_directory << ")\n"
+		<< "  --scale F            multiply the number of samples of every scenario by F (default 1)\n"
+		<< "  --tolerance F        fractional increase in p99 overshoot or CPU per call allowed (default 0.10)\n"
+		<< "  --floor-ns N         absolute increase in nanoseconds always allowed on top of the tolerance (default 1000)\n"
+		<< "  --alpha F            significance level of the Mann-Whitney U tests (default 0.01)\n"
+		<< "Exits with 0 if no scenario regressed, 1 if any did, and 2 on errors such as a missing baseline.\n";
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	gate_options options;
+	try {
+		for (int i = 1; i < argc; i++) {
+			std::string argument = argv[i];
+			auto value = [&]() -> std::string {
+				if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+				return argv[++i];
+			};
+			if (argument == "--help" || argument == "-h") {
+				print_usage(argv[0]);
+				return 0;
+			}
+			else if (argument == "--save") options.save = true;
+			else if (argument == "--baseline") options.baseline_directory = value();
+			else if (argument == "--scale") options.scale = std::stod(value());
+			else if (argument == "--tolerance") options.tolerance = std::stod(value());
+			else if (argument == "--floor-ns") options.floor_ns = std::stod(value());
+			else if (argument == "--alpha") options.alpha = std::stod(value());
+			else throw std::invalid_argument("unknown option " + argument);
+		}
+
+		std::vector<scenario> scenarios = gate_scenarios(options.scale);
+		std::vector<scenario_result> results;
+		for (const scenario &s : scenarios) results.push_back(run_scenario(s));
+
+		if (options.save) {
+			save_baseline(options, scenarios, results);
+			std::cout << "Saved baseline of " << scenarios.size() << " scenarios to " << options.baseline_directory << "\n";
+			return 0;
+		}
+		return compare_baseline(options, scenarios, results) ? 1 : 0;
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		return 2;
+	}
+}
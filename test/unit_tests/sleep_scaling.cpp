@@ -0,0 +1,266 @@
+/**
+ * @file 	sleep_scaling.cpp
+ * @brief 	sleep_scaling.cpp measures how the accuracy of the sleep strategies scales with the number of
+ * 			threads sleeping concurrently.
+ * @details	For every combination of strategy, thread count and duration in the scenario matrix, the tool
+ * 			starts the threads together, has each of them sleep for the duration repeatedly, and reports
+ * 			the overshoot percentiles over all the sleeps, the spread of the per-thread p99 overshoots, and
+ * 			the number of involuntary context switches each thread suffered. By default the thread counts
+ * 			double from 1 up to twice the number of cores and the durations are those of the unit tests.
+ * 			Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+	#include <sys/resource.h>
+#endif /* _WIN32 */
+
+// Sleep Headers
+#include "adaptive_sleep.hpp"
+#include "high_resolution_sleep.hpp"
+#include "sleeper.hpp"
+
+/// Strategies that can be measured, in the order they are run by --strategy all.
+const static std::vector<std::string> STRATEGIES = {"sleep_us", "sleep_until_ns",
+#ifndef _WIN32
+	"hybrid",
+#endif /* _WIN32 */
+	"adaptive", "sleeper"};
+
+/// Durations of the unit tests in microseconds, measured by default.
+const static std::vector<uint64_t> DEFAULT_DURATIONS_US = {10'000, 1'000, 500, 250, 50, 10, 5, 1};
+
+/// Total time each thread sleeps for per scenario when the number of samples is not given.
+const static uint64_t DEFAULT_SCENARIO_TIME_US = 200'000;
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct scaling_options {
+	std::vector<std::string> strategies = {"sleep_us"};
+	std::vector<uint32_t> thread_counts{};
+	std::vector<uint64_t> durations_us = DEFAULT_DURATIONS_US;
+	uint64_t samples = 0;
+	std::string csv_file{};
+};
+
+/**
+ * Parses a comma separated list of numbers.
+ */
+template <typename T>
+std::vector<T> parse_list(const std::string &text) {
+	std::vector<T> values;
+	std::stringstream list(text);
+	std::string value;
+	while (std::getline(list, value, ',')) values.push_back(static_cast<T>(std::stoull(value)));
+	return values;
+}
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --strategy NAME      sleep strategy: sleep_us (default), sleep_until_ns"
+	#ifndef _WIN32
+		<< ", hybrid"
+	#endif /* _WIN32 */
+		<< ", adaptive, sleeper, or all\n"
+		<< "  --threads LIST       comma separated thread counts (default 1, 2, 4, ... up to twice the cores)\n"
+		<< "  --durations-us LIST  comma separated sleep durations in microseconds (default those of the unit tests)\n"
+		<< "  --samples N          sleeps per thread per scenario (default enough for " << DEFAULT_SCENARIO_TIME_US / 1'000 << " ms, between 10 and 1000)\n"
+		<< "  --csv FILE           also write the summary of every scenario to a CSV file\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+scaling_options parse_options(int argc, char *argv[]) {
+	scaling_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--strategy") {
+			std::string strategy = value();
+			if (strategy == "all") options.strategies = STRATEGIES;
+			else if (std::find(STRATEGIES.begin(), STRATEGIES.end(), strategy) != STRATEGIES.end()) options.strategies = {strategy};
+			else throw std::invalid_argument("unknown strategy " + strategy);
+		}
+		else if (argument == "--threads") options.thread_counts = parse_list<uint32_t>(value());
+		else if (argument == "--durations-us") options.durations_us = parse_list<uint64_t>(value());
+		else if (argument == "--samples") options.samples = std::stoull(value());
+		else if (argument == "--csv") options.csv_file = value();
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.thread_counts.empty()) {
+		const uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+		for (uint32_t count = 1; count < 2 * cores; count *= 2) options.thread_counts.push_back(count);
+		options.thread_counts.push_back(2 * cores);
+	}
+	for (uint32_t count : options.thread_counts) {
+		if (count == 0) throw std::invalid_argument("--threads must be greater than zero");
+	}
+	for (uint64_t duration_us : options.durations_us) {
+		if (duration_us == 0 || duration_us > UINT32_MAX) throw std::invalid_argument("--durations-us must be between 1 and " + std::to_string(UINT32_MAX));
+	}
+	return options;
+}
+
+/**
+ * Gets the number of involuntary context switches of the calling thread, or zero where unavailable.
+ */
+uint64_t involuntary_context_switches() {
+	#ifdef RUSAGE_THREAD
+	struct rusage usage;
+	if (getrusage(RUSAGE_THREAD, &usage) == 0) return static_cast<uint64_t>(usage.ru_nivcsw);
+	#endif /* RUSAGE_THREAD */
+	return 0;
+}
+
+/**
+ * Sleeps for the duration with the named strategy.
+ */
+void sleep_with(const std::string &strategy, const uint32_t duration_us) {
+	if (strategy == "sleep_until_ns") high_resolution_sleep::sleep_until_ns(high_resolution_sleep::now_ns() + static_cast<uint64_t>(duration_us) * 1'000);
+	#ifndef _WIN32
+	else if (strategy == "hybrid") high_resolution_sleep::sleep_us_hybrid(duration_us, high_resolution_sleep::hybrid_sleep_config{});
+	#endif /* _WIN32 */
+	else if (strategy == "adaptive") high_resolution_sleep::sleep_us_adaptive(duration_us);
+	else if (strategy == "sleeper") {
+		thread_local high_resolution_sleep::Sleeper sleeper;
+		sleeper.sleep_for(std::chrono::microseconds(duration_us));
+	}
+	else high_resolution_sleep::sleep_us(duration_us);
+}
+
+/**
+ * Results of one thread of a scenario.
+ */
+struct thread_result {
+	std::vector<int64_t> overshoots_ns{};
+	uint64_t involuntary_switches = 0;
+};
+
+/**
+ * Gets a percentile of sorted values.
+ */
+int64_t percentile(const std::vector<int64_t> &sorted, const double fraction) {
+	return sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+}
+
+/**
+ * Runs one scenario of the matrix and prints its summary, appending it to the CSV if one is open.
+ */
+void run_scenario(const std::string &strategy, const uint32_t thread_count, const uint64_t duration_us, const uint64_t samples, std::ofstream &csv) {
+	std::vector<thread_result> results(thread_count);
+	std::atomic<uint32_t> ready{0};
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < thread_count; t++) {
+		threads.emplace_back([&, t]() {
+			thread_result &result = results[t];
+			result.overshoots_ns.reserve(samples);
+			// Start every thread together so that the sleeps overlap.
+			ready++;
+			while (ready.load() < thread_count) std::this_thread::yield();
+			const uint64_t start_switches = involuntary_context_switches();
+			for (uint64_t i = 0; i < samples; i++) {
+				const uint64_t start_ns = high_resolution_sleep::now_ns();
+				sleep_with(strategy, static_cast<uint32_t>(duration_us));
+				result.overshoots_ns.push_back(static_cast<int64_t>(high_resolution_sleep::now_ns() - start_ns) - static_cast<int64_t>(duration_us * 1'000));
+			}
+			result.involuntary_switches = involuntary_context_switches() - start_switches;
+		});
+	}
+	for (std::thread &thread : threads) thread.join();
+
+	std::vector<int64_t> aggregate, thread_p99s;
+	uint64_t switches = 0;
+	for (thread_result &result : results) {
+		std::sort(result.overshoots_ns.begin(), result.overshoots_ns.end());
+		thread_p99s.push_back(percentile(result.overshoots_ns, 0.99));
+		aggregate.insert(aggregate.end(), result.overshoots_ns.begin(), result.overshoots_ns.end());
+		switches += result.involuntary_switches;
+	}
+	std::sort(aggregate.begin(), aggregate.end());
+	std::sort(thread_p99s.begin(), thread_p99s.end());
+	const double switches_per_thread = static_cast<double>(switches) / thread_count;
+	auto us = [](int64_t ns) { return static_cast<double>(ns) / 1'000.0; };
+
+	std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(15) << strategy << std::right
+		<< std::setw(8) << thread_count << std::setw(10) << duration_us
+		<< std::setw(10) << us(percentile(aggregate, 0.5)) << std::setw(10) << us(percentile(aggregate, 0.99))
+		<< std::setw(10) << us(percentile(aggregate, 0.999)) << std::setw(12) << us(aggregate.back())
+		<< std::setw(12) << us(thread_p99s.front()) << std::setw(12) << us(thread_p99s.back())
+		<< std::setw(12) << switches_per_thread << std::endl;
+	if (csv.is_open()) {
+		csv << strategy << "," << thread_count << "," << duration_us << "," << percentile(aggregate, 0.5) << "," << percentile(aggregate, 0.99)
+			<< "," << percentile(aggregate, 0.999) << "," << aggregate.back() << "," << thread_p99s.front() << "," << thread_p99s[thread_p99s.size() / 2]
+			<< "," << thread_p99s.back() << "," << switches_per_thread << "\n";
+	}
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	scaling_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::ofstream csv;
+	if (!options.csv_file.empty()) {
+		csv.open(options.csv_file);
+		if (!csv) {
+			std::cerr << "Error: could not open " << options.csv_file << "\n";
+			return 1;
+		}
+		csv << "Strategy,Threads,Duration (us),p50 (ns),p99 (ns),p99.9 (ns),Max (ns),Min Thread p99 (ns),Median Thread p99 (ns),Max Thread p99 (ns),Involuntary Switches per Thread\n";
+	}
+
+	#ifndef RUSAGE_THREAD
+	std::cerr << "Warning: per-thread context switch counts are not available on this platform, they are reported as zero.\n";
+	#endif /* RUSAGE_THREAD */
+	std::cout << "Overshoots in microseconds, thread p99 is the spread of the p99 overshoot across the threads\n"
+		<< std::left << std::setw(15) << "Strategy" << std::right << std::setw(8) << "Threads" << std::setw(10) << "Duration"
+		<< std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "Max"
+		<< std::setw(12) << "Thread p99" << std::setw(12) << "to" << std::setw(12) << "Inv. Sw." << std::endl;
+	for (const std::string &strategy : options.strategies) {
+		for (uint64_t duration_us : options.durations_us) {
+			const uint64_t samples = options.samples > 0 ? options.samples : std::clamp<uint64_t>(DEFAULT_SCENARIO_TIME_US / duration_us, 10, 1'000);
+			for (uint32_t thread_count : options.thread_counts) {
+				run_scenario(strategy, thread_count, duration_us, samples, csv);
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,29 @@
+// System Libraries
+#include <cstdint>
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "periodic_executive.hpp"
+#include "realtime_thread.hpp"
+#include "sleep_latency_histogram.hpp"
+#include "sleep_trace.hpp"
+#include "timing_wheel.hpp"
+#include "tsc_clock.hpp"
+#ifdef __linux__
+#include "timerfd_engine.hpp"
+#endif /* __linux__ */
+
+/**
+ * Gets now_ns from a second translation unit, so that the sleep_unit_tests executable links the
+ * definitions of every header from more than one translation unit.
+ */
+uint64_t now_ns_from_second_translation_unit() {
+	return high_resolution_sleep::now_ns();
+}
+
+/**
+ * Gets now_ns_fast from a second translation unit, sharing the TSC calibration of the first.
+ */
+uint64_t now_ns_fast_from_second_translation_unit() {
+	return high_resolution_sleep::now_ns_fast();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file 	sleep_test_utilities.hpp
+ * @brief 	sleep_test_utilities.hpp defines helpers shared by the sleep test executables.
+ */
+
+#ifndef SLEEP_TEST_UTILITIES_HPP
+#define SLEEP_TEST_UTILITIES_HPP
+
+// System Libraries
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Directory Config Headers
+#include "DirectoryConfig.hpp"
+
+const static std::string RESULTS_DIR = "/test/results/";
+
+/**
+ * Saves results as a CSV of start time, end time and error. The file is formatted into one buffer that
+ * is written at once, rather than building a string for every line.
+ */
+inline void save_results(const std::vector<std::tuple<uint64_t, uint64_t, int64_t>> &start_end_times, std::string file_name) {
+	// Each line holds at most two 20 digit numbers, a signed 20 digit number, two commas and a newline.
+	const size_t max_line_length = 3 * 21 + 3;
+	const char header[] = "Start,End,Error\n";
+	std::vector<char> buffer(sizeof(header) - 1 + start_end_times.size() * max_line_length);
+	char *position = std::copy(header, header + sizeof(header) - 1, buffer.data());
+	char *buffer_end = buffer.data() + buffer.size();
+	for (const auto &[start, end, error] : start_end_times) {
+		position = std::to_chars(position, buffer_end, start).ptr;
+		*position++ = ',';
+		position = std::to_chars(position, buffer_end, end).ptr;
+		*position++ = ',';
+		position = std::to_chars(position, buffer_end, error).ptr;
+		*position++ = '\n';
+	}
+	std::ofstream output_file = std::ofstream(file_name, std::ios::out | std::ios::binary);
+	output_file.write(buffer.data(), position - buffer.data());
+}
+
+#endif /* SLEEP_TEST_UTILITIES_HPP */
@@ -0,0 +1,194 @@
+// System Libraries
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+	#include <time.h>
+#endif /* _WIN32 */
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "sleep_trace.hpp"
+
+using high_resolution_sleep::sleep_trace_record;
+using high_resolution_sleep::SleepStrategy;
+using high_resolution_sleep::SleepTraceRecorder;
+
+/**
+ * Sleeps with sleep_us for the given number of samples, recording each sleep into the recorder.
+ */
+void trace_sleep_us(SleepTraceRecorder &recorder, uint32_t duration_us, uint32_t sample_count) {
+	for (uint32_t i = 0; i < sample_count; i++) {
+		uint64_t start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_us(duration_us);
+		uint64_t end_ns = high_resolution_sleep::now_ns();
+		recorder.record(start_ns, end_ns, duration_us * 1'000, SleepStrategy::SleepUs);
+	}
+}
+
+/**
+ * Records sleep_us for the given number of samples into a trace file drained in the background.
+ */
+void test_trace_sleep_us(uint32_t duration_us, uint32_t sample_count) {
+	std::string file_name = PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us-trace-" + std::to_string(duration_us) + "us.trace";
+	SleepTraceRecorder recorder;
+	recorder.start_drain(file_name);
+	trace_sleep_us(recorder, duration_us, sample_count);
+	recorder.stop_drain();
+	REQUIRE(recorder.dropped() == 0);
+	REQUIRE(high_resolution_sleep::read_sleep_trace(file_name).size() == sample_count);
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* SleepTraceRecorder Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking a trace of a million records survives a write and read.", "[sleep_trace][test][short]") {
+	std::vector<sleep_trace_record> records;
+	for (uint64_t i = 0; i < 1'000'000; i++) {
+		records.push_back(sleep_trace_record{i * 1'000, i * 1'000 + 500, 450, static_cast<uint32_t>(SleepStrategy::SleepUs), static_cast<uint32_t>(i % 7)});
+	}
+	std::string file_name = PROJECT_DIRECTORY + RESULTS_DIR + "sleep_trace-roundtrip.trace";
+	REQUIRE_NOTHROW(high_resolution_sleep::write_sleep_trace(records, file_name));
+	std::vector<sleep_trace_record> read_records = high_resolution_sleep::read_sleep_trace(file_name);
+	REQUIRE(read_records.size() == records.size());
+	for (size_t i = 0; i < records.size(); i += 997) {
+		REQUIRE(read_records[i].start_ns == records[i].start_ns);
+		REQUIRE(read_records[i].end_ns == records[i].end_ns);
+		REQUIRE(read_records[i].thread_id == records[i].thread_id);
+	}
+}
+
+TEST_CASE("Checking read_sleep_trace rejects files that are not traces.", "[sleep_trace][test][short]") {
+	std::string file_name = PROJECT_DIRECTORY + RESULTS_DIR + "sleep_trace-invalid.trace";
+	save_results({}, file_name);
+	REQUIRE_THROWS_AS(high_resolution_sleep::read_sleep_trace(file_name), std::runtime_error);
+}
+
+TEST_CASE("Checking SleepTraceRecorder keeps every record from several threads while draining.", "[sleep_trace][test][short]") {
+	SleepTraceRecorder recorder(1'024);
+	std::vector<sleep_trace_record> drained;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&recorder]() {
+			for (uint64_t i = 0; i < 100'000; i++) {
+				// Retry while the ring is full, the drainer below will free space.
+				while (!recorder.record(i, i + 1, 1, SleepStrategy::Other)) std::this_thread::yield();
+			}
+		});
+	}
+	while (drained.size() < 400'000) {
+		if (recorder.drain(drained) == 0) std::this_thread::yield();
+	}
+	for (std::thread &thread : threads) thread.join();
+
+	// Each thread's records are drained in the order that thread wrote them.
+	std::vector<uint64_t> next_start(1'024, 0);
+	for (const sleep_trace_record &record : drained) {
+		REQUIRE(record.start_ns == next_start[record.thread_id]);
+		next_start[record.thread_id]++;
+	}
+}
+
+TEST_CASE("Checking SleepTraceRecorder drops records when full.", "[sleep_trace][test][short]") {
+	SleepTraceRecorder recorder(16);
+	for (int i = 0; i < 20; i++) recorder.record(i, i, 0, SleepStrategy::Other);
+	REQUIRE(recorder.capacity() == 16);
+	REQUIRE(recorder.dropped() == 4);
+	std::vector<sleep_trace_record> drained;
+	REQUIRE(recorder.drain(drained) == 16);
+	REQUIRE(recorder.record(0, 0, 0, SleepStrategy::Other));
+}
+
+TEST_CASE("Checking sleep_us with sleep duration of 1 millisecond recorded to a trace.", "[sleep_trace][test][short]") {
+	test_trace_sleep_us(1'000, 1'000);
+}
+
+TEST_CASE("Checking sleep_us with sleep duration of 50 microseconds recorded to a trace.", "[sleep_trace][test][short]") {
+	test_trace_sleep_us(50, 5'000);
+}
+
+TEST_CASE("Checking sleep_us with sleep duration of 1 microsecond recorded to a trace.", "[sleep_trace][test][short]") {
+	test_trace_sleep_us(1, 100'000);
+}
+
+/*************************************************************************************************/
+/* Replay Tests																					 */
+/*************************************************************************************************/
+TEST_CASE("Checking replay_sleep_trace reproduces a recorded sleep pattern.", "[sleep_trace][test][short]") {
+	// Record a pattern of short and long sleeps with idle gaps between them.
+	SleepTraceRecorder recorder;
+	for (uint32_t i = 0; i < 200; i++) {
+		uint32_t duration_us = i % 4 == 0 ? 1'000 : 100;
+		uint64_t start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_us(duration_us);
+		recorder.record(start_ns, high_resolution_sleep::now_ns(), duration_us * 1'000, SleepStrategy::SleepUs);
+		high_resolution_sleep::sleep_us(200);
+	}
+	std::vector<sleep_trace_record> trace;
+	recorder.drain(trace);
+	std::vector<sleep_trace_record> replayed = high_resolution_sleep::replay_sleep_trace(trace);
+
+	REQUIRE(replayed.size() == trace.size());
+	for (size_t i = 0; i < trace.size(); i++) {
+		REQUIRE(replayed[i].requested_ns == trace[i].requested_ns);
+		REQUIRE(replayed[i].end_ns - replayed[i].start_ns >= trace[i].requested_ns);
+	}
+	// With the gaps preserved the replay takes as long as the recording, less the time taken to issue the first sleep.
+	REQUIRE(replayed.back().start_ns - replayed.front().start_ns + 100'000 >= trace.back().start_ns - trace.front().start_ns);
+	REQUIRE_NOTHROW(high_resolution_sleep::write_sleep_trace(replayed, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_trace-replay.trace"));
+}
+
+#ifndef _WIN32
+TEST_CASE("Checking replay_sleep re-issues each sleep with the strategy it was recorded with.", "[sleep_trace][test][short]") {
+	// Sleeps shorter than the sleep margin never sleep in the kernel with the hybrid strategy, so replaying
+	// them keeps the processor busy for their whole duration, unlike the kernel sleep of sleep_us.
+	auto replay_cpu_time_ns = [](SleepStrategy strategy) {
+		std::vector<sleep_trace_record> trace(200, sleep_trace_record{0, 0, 50'000, static_cast<uint32_t>(strategy), 0});
+		struct timespec start, end;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+		high_resolution_sleep::replay_sleep_trace(trace, false);
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+		return static_cast<int64_t>(end.tv_sec - start.tv_sec) * 1'000'000'000 + (end.tv_nsec - start.tv_nsec);
+	};
+	int64_t kernel_cpu_ns = replay_cpu_time_ns(SleepStrategy::SleepUs);
+	int64_t hybrid_cpu_ns = replay_cpu_time_ns(SleepStrategy::SleepUsHybrid);
+	REQUIRE(hybrid_cpu_ns > 200 * 50'000 / 2);
+	REQUIRE(hybrid_cpu_ns > kernel_cpu_ns);
+}
+#endif /* _WIN32 */
+
+
+/*************************************************************************************************/
+/* SleepTraceRecorder Benchmarks																 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking SleepTraceRecorder.", "[sleep_trace][benchmark]") {
+	SleepTraceRecorder recorder(1 << 20);
+	std::vector<sleep_trace_record> drained;
+	drained.reserve(1 << 20);
+	BENCHMARK("SleepTraceRecorder::record") {
+		if (!recorder.record(1, 2, 3, SleepStrategy::Other)) recorder.drain(drained), drained.clear();
+		return recorder.dropped();
+	};
+	BENCHMARK("replay of 100 sleep_us 50 microsecond sleeps back to back") {
+		std::vector<sleep_trace_record> trace(100, sleep_trace_record{0, 0, 50'000, static_cast<uint32_t>(SleepStrategy::SleepUs), 0});
+		return high_resolution_sleep::replay_sleep_trace(trace, false).size();
+	};
+}
@@ -14,16 +14,28 @@
 // ASIO Header
 #include <asio.hpp>
 
-// Directory Config Headers
-#include "DirectoryConfig.hpp"
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
 
 // Sleep Headers
 #include "high_resolution_sleep.hpp"
-
-const static std::string RESULTS_DIR = "/test/results/";
+#include "periodic_executive.hpp"
+#include "realtime_thread.hpp"
+#include "sleep_latency_histogram.hpp"
+#include "sleep_trace.hpp"
+#include "timing_wheel.hpp"
+#include "tsc_clock.hpp"
+#ifdef __linux__
+#include "timerfd_engine.hpp"
+#endif /* __linux__ */
+
+// Functions defined in sleep_second_translation_unit.cpp.
+uint64_t now_ns_from_second_translation_unit();
+uint64_t now_ns_fast_from_second_translation_unit();
 
 std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_ms(uint32_t duration_ms, uint32_t sample_count) {
 	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
 	for (int i = 0; i < sample_count; i++) {
 		uint64_t start_ns, end_ns;
 		start_ns = high_resolution_sleep::now_ns();
@@ -36,6 +48,7 @@ std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_ms(uint32_t dura
 
 std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_ms_corrected(uint32_t duration_ms, uint32_t sample_count, uint64_t task_duration_us = 0) {
 	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
 	int64_t error_us = 0;
 	for (int i = 0; i < sample_count; i++) {
 		uint64_t start_ns, end_ns;
@@ -53,6 +66,7 @@ std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_ms_corrected(uin
 
 std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_us(uint32_t duration_us, uint32_t sample_count) {
 	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
 	for (int i = 0; i < sample_count; i++) {
 		uint64_t start_ns, end_ns;
 		start_ns = high_resolution_sleep::now_ns();
@@ -63,8 +77,106 @@ std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_us(uint32_t dura
 	return start_end_times;
 }
 
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_until_ns(uint32_t period_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	uint64_t deadline_ns = high_resolution_sleep::now_ns();
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = deadline_ns;
+		deadline_ns += period_us * 1'000;
+		high_resolution_sleep::sleep_until_ns(deadline_ns);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - deadline_ns));
+	}
+	return start_end_times;
+}
+
+template <typename ClockSource>
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_until_ns_on(uint32_t period_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	uint64_t deadline_ns = high_resolution_sleep::now_ns_on<ClockSource>();
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = deadline_ns;
+		deadline_ns += period_us * 1'000;
+		high_resolution_sleep::sleep_until_ns_on<ClockSource>(deadline_ns);
+		end_ns = high_resolution_sleep::now_ns_on<ClockSource>();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - deadline_ns));
+	}
+	return start_end_times;
+}
+
+template <typename ClockSource>
+uint64_t count_early_wakes_on(uint32_t period_us, uint32_t sample_count) {
+	namespace sleep_policy = high_resolution_sleep::sleep_policy;
+	uint64_t early_wakes = 0;
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t deadline_ns = high_resolution_sleep::now_ns_on<ClockSource>() + period_us * 1'000;
+		#ifndef _WIN32
+		high_resolution_sleep::sleep_until_ns_hybrid_on<ClockSource>(deadline_ns);
+		if (high_resolution_sleep::now_ns_on<ClockSource>() < deadline_ns) early_wakes++;
+		deadline_ns = high_resolution_sleep::now_ns_on<ClockSource>() + period_us * 1'000;
+		#endif /* _WIN32 */
+		high_resolution_sleep::sleep_for_on<ClockSource>(std::chrono::microseconds(period_us));
+		if (high_resolution_sleep::now_ns_on<ClockSource>() < deadline_ns) early_wakes++;
+		deadline_ns = high_resolution_sleep::now_ns_on<ClockSource>() + period_us * 1'000;
+		high_resolution_sleep::sleep_for_on<ClockSource, sleep_policy::kernel>(std::chrono::microseconds(period_us));
+		if (high_resolution_sleep::now_ns_on<ClockSource>() < deadline_ns) early_wakes++;
+		deadline_ns = high_resolution_sleep::now_ns_on<ClockSource>() + period_us * 1'000;
+		high_resolution_sleep::sleep_until_on<ClockSource, sleep_policy::spin>(std::chrono::steady_clock::now() + std::chrono::microseconds(period_us));
+		if (high_resolution_sleep::now_ns_on<ClockSource>() < deadline_ns) early_wakes++;
+	}
+	return early_wakes;
+}
+
+template <typename Policy = high_resolution_sleep::sleep_policy::automatic, typename Rep, typename Period>
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_for(std::chrono::duration<Rep, Period> duration, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	const int64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_for<Policy>(duration);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - duration_ns));
+	}
+	return start_end_times;
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_spin_until_ns(uint32_t duration_us, uint32_t sample_count, high_resolution_sleep::SpinStrategy strategy) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::spin_until_ns(start_ns + duration_us * 1'000, strategy);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	return start_end_times;
+}
+
+#ifndef _WIN32
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleep_us_hybrid(uint32_t duration_us, uint32_t sample_count, high_resolution_sleep::hybrid_sleep_config config) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		high_resolution_sleep::sleep_us_hybrid(duration_us, config);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	return start_end_times;
+}
+#endif /* _WIN32 */
+
 std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_asio_timer(uint32_t duration_us, uint32_t sample_count) {
 	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
 	asio::io_context context;
 	asio::high_resolution_timer timer{context};
 	for (int i = 0; i < sample_count; i++) {
@@ -79,16 +191,6 @@ std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_asio_timer(uint32_t du
 	return start_end_times;
 }
 
-void save_results(std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times, std::string file_name) {
-	std::ofstream output_file = std::ofstream(file_name, std::ios::out);
-	std::string line = "Start,End,Error\n";
-	output_file.write(line.c_str(), line.size());
-	for (auto [start, end, error] : start_end_times) {
-		std::string line = std::to_string(start) + "," + std::to_string(end) + "," + std::to_string(error) + "\n";
-		output_file.write(line.c_str(), line.size());
-	}
-}
-
 /*************************************************************************************************
 * Main Method
 *************************************************************************************************/
@@ -353,6 +455,348 @@ TEST_CASE("Benchmarking sleep_us.", "[sleep_us][benchmark]") {
 }
 
 
+/*************************************************************************************************/
+/* sleep_until_ns Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking sleep_until_ns with a period of 10 milliseconds.", "[sleep_until_ns][test][short]") {
+	uint32_t us = 10'000;
+	REQUIRE_NOTHROW(save_results(test_sleep_until_ns(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_until_ns with a period of 1 millisecond.", "[sleep_until_ns][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_sleep_until_ns(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_until_ns with a period of 500 microseconds.", "[sleep_until_ns][test][short]") {
+	uint32_t us = 500;
+	REQUIRE_NOTHROW(save_results(test_sleep_until_ns(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_until_ns with a period of 250 microseconds.", "[sleep_until_ns][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_sleep_until_ns(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_until_ns with a period of 50 microseconds.", "[sleep_until_ns][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_sleep_until_ns(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_until_ns with a std::chrono::steady_clock deadline.", "[sleep_until_ns][test][short]") {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+	high_resolution_sleep::sleep_until_ns(deadline);
+	REQUIRE(std::chrono::steady_clock::now() >= deadline);
+}
+
+
+/*************************************************************************************************/
+/* sleep_for Tests																				 */
+/*************************************************************************************************/
+namespace sleep_policy = high_resolution_sleep::sleep_policy;
+static_assert(std::is_same_v<high_resolution_sleep::resolve_sleep_policy_t<sleep_policy::automatic, std::nano>, sleep_policy::hybrid>);
+static_assert(std::is_same_v<high_resolution_sleep::resolve_sleep_policy_t<sleep_policy::automatic, std::micro>, sleep_policy::hybrid>);
+static_assert(std::is_same_v<high_resolution_sleep::resolve_sleep_policy_t<sleep_policy::automatic, std::milli>, sleep_policy::kernel>);
+static_assert(std::is_same_v<high_resolution_sleep::resolve_sleep_policy_t<sleep_policy::automatic, std::ratio<1>>, sleep_policy::kernel>);
+static_assert(std::is_same_v<high_resolution_sleep::resolve_sleep_policy_t<sleep_policy::spin, std::nano>, sleep_policy::spin>);
+static_assert(std::is_same_v<high_resolution_sleep::resolve_sleep_policy_t<sleep_policy::spin, std::milli>, sleep_policy::spin>);
+static_assert(high_resolution_sleep::duration_to_ns(std::chrono::milliseconds(5)) == 5'000'000);
+static_assert(high_resolution_sleep::duration_to_ns(std::chrono::microseconds(-5)) == 0);
+static_assert(high_resolution_sleep::duration_to_ns(std::chrono::hours(1'000'000'000)) == INT64_MAX);
+
+TEST_CASE("Checking sleep_for with sleep duration of 10 milliseconds.", "[sleep_for][test][short]") {
+	auto duration = std::chrono::milliseconds(10);
+	REQUIRE_NOTHROW(save_results(test_sleep_for(duration, 100), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_for-10000us.csv"));
+}
+
+TEST_CASE("Checking sleep_for with sleep duration of 1 millisecond.", "[sleep_for][test][short]") {
+	auto duration = std::chrono::milliseconds(1);
+	REQUIRE_NOTHROW(save_results(test_sleep_for(duration, 1'000), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_for-1000us.csv"));
+}
+
+TEST_CASE("Checking sleep_for with sleep duration of 50 microseconds.", "[sleep_for][test][short]") {
+	auto duration = std::chrono::microseconds(50);
+	REQUIRE_NOTHROW(save_results(test_sleep_for(duration, 5'000), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_for-50us.csv"));
+}
+
+TEST_CASE("Checking sleep_for with sleep duration of 500 nanoseconds.", "[sleep_for][test][short]") {
+	auto duration = std::chrono::nanoseconds(500);
+	REQUIRE_NOTHROW(save_results(test_sleep_for(duration, 100'000), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_for-500ns.csv"));
+}
+
+TEST_CASE("Checking sleep_for with the hybrid policy and sleep duration of 1 millisecond.", "[sleep_for][test][short]") {
+	auto duration = std::chrono::milliseconds(1);
+	REQUIRE_NOTHROW(save_results(test_sleep_for<sleep_policy::hybrid>(duration, 1'000), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_for_hybrid-1000us.csv"));
+}
+
+TEST_CASE("Checking sleep_for returns immediately for negative durations.", "[sleep_for][test][short]") {
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	high_resolution_sleep::sleep_for(std::chrono::milliseconds(-100));
+	REQUIRE(high_resolution_sleep::now_ns() - start_ns < 50'000'000);
+}
+
+TEST_CASE("Checking sleep_until with a std::chrono::steady_clock deadline.", "[sleep_for][test][short]") {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+	high_resolution_sleep::sleep_until(deadline);
+	REQUIRE(std::chrono::steady_clock::now() >= deadline);
+	auto coarse_deadline = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()) + std::chrono::milliseconds(2);
+	high_resolution_sleep::sleep_until(coarse_deadline);
+	REQUIRE(std::chrono::steady_clock::now() >= coarse_deadline);
+}
+
+
+/*************************************************************************************************/
+/* sleep_for Benchmarks																			 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking sleep_for.", "[sleep_for][benchmark]") {
+	BENCHMARK("1 millisecond"){ return high_resolution_sleep::sleep_for(std::chrono::milliseconds(1)); };
+	BENCHMARK("50 microseconds"){ return high_resolution_sleep::sleep_for(std::chrono::microseconds(50)); };
+	BENCHMARK("500 nanoseconds"){ return high_resolution_sleep::sleep_for(std::chrono::nanoseconds(500)); };
+	BENCHMARK("zero nanoseconds"){ return high_resolution_sleep::sleep_for(std::chrono::nanoseconds(0)); };
+}
+
+
+/*************************************************************************************************/
+/* Clock Source Tests																			 */
+/*************************************************************************************************/
+namespace clock_source = high_resolution_sleep::clock_source;
+
+TEST_CASE("Checking sleep_until_ns_on never wakes before the deadline of each clock.", "[clock_source][test][short]") {
+	uint32_t us = 1'000;
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> monotonic = test_sleep_until_ns_on<clock_source::monotonic>(us, 0.25 * (1'000'000 / us));
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> monotonic_coarse = test_sleep_until_ns_on<clock_source::monotonic_coarse>(us, 0.25 * (1'000'000 / us));
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> monotonic_raw = test_sleep_until_ns_on<clock_source::monotonic_raw>(us, 0.25 * (1'000'000 / us));
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> boottime = test_sleep_until_ns_on<clock_source::boottime>(us, 0.25 * (1'000'000 / us));
+	for (const auto *samples : {&monotonic, &monotonic_coarse, &monotonic_raw, &boottime}) {
+		for (const auto &sample : *samples) REQUIRE(std::get<2>(sample) >= 0);
+	}
+	REQUIRE_NOTHROW(save_results(monotonic, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns_on_monotonic-" + std::to_string(us) + "us.csv"));
+	REQUIRE_NOTHROW(save_results(monotonic_coarse, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns_on_monotonic_coarse-" + std::to_string(us) + "us.csv"));
+	REQUIRE_NOTHROW(save_results(monotonic_raw, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns_on_monotonic_raw-" + std::to_string(us) + "us.csv"));
+	REQUIRE_NOTHROW(save_results(boottime, PROJECT_DIRECTORY + RESULTS_DIR + "sleep_until_ns_on_boottime-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking the hybrid, chrono and spin sleeps never wake before the deadline of each clock.", "[clock_source][test][short]") {
+	REQUIRE(count_early_wakes_on<clock_source::monotonic>(500, 50) == 0);
+	REQUIRE(count_early_wakes_on<clock_source::monotonic_coarse>(500, 50) == 0);
+	REQUIRE(count_early_wakes_on<clock_source::monotonic_raw>(500, 50) == 0);
+	REQUIRE(count_early_wakes_on<clock_source::boottime>(500, 50) == 0);
+}
+
+TEST_CASE("Checking the monotonic clock source is the clock of now_ns.", "[clock_source][test][short]") {
+	uint64_t before_ns = high_resolution_sleep::now_ns();
+	uint64_t clock_ns = high_resolution_sleep::now_ns_on<clock_source::monotonic>();
+	uint64_t after_ns = high_resolution_sleep::now_ns();
+	REQUIRE(clock_ns >= before_ns);
+	REQUIRE(clock_ns <= after_ns);
+	REQUIRE(high_resolution_sleep::now_us_on<clock_source::monotonic>() >= after_ns / 1'000);
+}
+
+TEST_CASE("Checking the coarse clock trails now_ns by less than a scheduler tick.", "[clock_source][test][short]") {
+	REQUIRE(clock_source::monotonic_coarse::resolution_ns() > 0);
+	uint64_t previous_ms = high_resolution_sleep::now_ms_coarse();
+	for (int i = 0; i < 1'000; i++) {
+		uint64_t coarse_ms = high_resolution_sleep::now_ms_coarse();
+		REQUIRE(coarse_ms >= previous_ms);
+		previous_ms = coarse_ms;
+	}
+	#ifdef __linux__
+	// CLOCK_MONOTONIC_COARSE is CLOCK_MONOTONIC as of the last tick, so shares its time base.
+	uint64_t coarse_ns = high_resolution_sleep::now_ns_on<clock_source::monotonic_coarse>();
+	uint64_t precise_ns = high_resolution_sleep::now_ns();
+	REQUIRE(coarse_ns <= precise_ns);
+	REQUIRE(precise_ns - coarse_ns <= clock_source::monotonic_coarse::resolution_ns() + 10'000'000);
+	#endif /* __linux__ */
+}
+
+TEST_CASE("Checking every clock source reports a resolution.", "[clock_source][test][short]") {
+	REQUIRE(clock_source::monotonic::resolution_ns() > 0);
+	REQUIRE(clock_source::monotonic_raw::resolution_ns() > 0);
+	REQUIRE(clock_source::boottime::resolution_ns() > 0);
+	REQUIRE(clock_source::monotonic_coarse::resolution_ns() >= clock_source::monotonic::resolution_ns());
+}
+
+
+/*************************************************************************************************/
+/* Clock Source Benchmarks																		 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking clock sources.", "[clock_source][benchmark]") {
+	BENCHMARK("monotonic"){ return high_resolution_sleep::now_ns_on<clock_source::monotonic>(); };
+	BENCHMARK("monotonic_coarse"){ return high_resolution_sleep::now_ns_on<clock_source::monotonic_coarse>(); };
+	BENCHMARK("monotonic_raw"){ return high_resolution_sleep::now_ns_on<clock_source::monotonic_raw>(); };
+	BENCHMARK("boottime"){ return high_resolution_sleep::now_ns_on<clock_source::boottime>(); };
+	BENCHMARK("now_ms_coarse"){ return high_resolution_sleep::now_ms_coarse(); };
+}
+
+
+/*************************************************************************************************/
+/* Spin Wait Tests																				 */
+/*************************************************************************************************/
+TEST_CASE("Checking spin_until_ns with each spin strategy and spin duration of 5 microseconds.", "[spin_wait][test][short]") {
+	uint32_t us = 5;
+	REQUIRE_NOTHROW(save_results(test_spin_until_ns(us, 10'000, high_resolution_sleep::SpinStrategy::Busy), PROJECT_DIRECTORY + RESULTS_DIR + "spin_until_ns_busy-" + std::to_string(us) + "us.csv"));
+	REQUIRE_NOTHROW(save_results(test_spin_until_ns(us, 10'000, high_resolution_sleep::SpinStrategy::Pause), PROJECT_DIRECTORY + RESULTS_DIR + "spin_until_ns_pause-" + std::to_string(us) + "us.csv"));
+	// WaitPkg falls back to Pause on processors without tpause, so is safe to call everywhere.
+	REQUIRE_NOTHROW(save_results(test_spin_until_ns(us, 10'000, high_resolution_sleep::SpinStrategy::WaitPkg), PROJECT_DIRECTORY + RESULTS_DIR + "spin_until_ns_waitpkg-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking spin_until_ns never wakes before the deadline.", "[spin_wait][test][short]") {
+	for (high_resolution_sleep::SpinStrategy strategy : {high_resolution_sleep::SpinStrategy::Busy, high_resolution_sleep::SpinStrategy::Pause, high_resolution_sleep::SpinStrategy::WaitPkg}) {
+		for (uint64_t duration_ns : {0, 100, 1'000, 20'000}) {
+			uint64_t deadline_ns = high_resolution_sleep::now_ns() + duration_ns;
+			high_resolution_sleep::spin_until_ns(deadline_ns, strategy);
+			REQUIRE(high_resolution_sleep::now_ns() >= deadline_ns);
+		}
+	}
+	REQUIRE(high_resolution_sleep::pause_cost_ps() > 0);
+}
+
+
+/*************************************************************************************************/
+/* Spin Wait Benchmarks																			 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking spin_until_ns.", "[spin_wait][benchmark]") {
+	BENCHMARK("busy 1 microsecond"){ return high_resolution_sleep::spin_until_ns(high_resolution_sleep::now_ns() + 1'000, high_resolution_sleep::SpinStrategy::Busy); };
+	BENCHMARK("pause 1 microsecond"){ return high_resolution_sleep::spin_until_ns(high_resolution_sleep::now_ns() + 1'000, high_resolution_sleep::SpinStrategy::Pause); };
+	BENCHMARK("default 1 microsecond"){ return high_resolution_sleep::spin_until_ns(high_resolution_sleep::now_ns() + 1'000); };
+}
+
+
+/*************************************************************************************************/
+/* sleep_us_hybrid Tests																		 */
+/*************************************************************************************************/
+#ifndef _WIN32
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 10 milliseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 10'000;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 1 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 1 millisecond.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 1 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 500 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 500;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.5 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 250 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.5 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 50 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.25 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 10 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 10;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.25 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 5 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 5;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.25 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with kernel only thresholds and sleep duration of 1 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 1;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.1 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with default thresholds and sleep duration of 1 millisecond.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 1 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_hybrid-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with default thresholds and sleep duration of 250 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.5 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_hybrid-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking sleep_us_hybrid with spin only thresholds and sleep duration of 50 microseconds.", "[sleep_us_hybrid][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, 0.25 * (1'000'000 / us), high_resolution_sleep::hybrid_sleep_config{UINT64_MAX, UINT64_MAX}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_spin-" + std::to_string(us) + "us.csv"));
+}
+#endif /* _WIN32 */
+
+
+/*************************************************************************************************/
+/* sleep_us_hybrid Benchmarks																	 */
+/*************************************************************************************************/
+#ifndef _WIN32
+TEST_CASE("Benchmarking sleep_us_hybrid with kernel only thresholds.", "[sleep_us_hybrid][benchmark]") {
+	high_resolution_sleep::hybrid_sleep_config config{0, 0};
+	uint32_t us = 1'000;
+	BENCHMARK("1 millisecond"){ return high_resolution_sleep::sleep_us_hybrid(us, config); };
+	us = 250;
+	BENCHMARK("250 microseconds"){ return high_resolution_sleep::sleep_us_hybrid(us, config); };
+	us = 50;
+	BENCHMARK("50 microseconds"){ return high_resolution_sleep::sleep_us_hybrid(us, config); };
+	us = 10;
+	BENCHMARK("10 microseconds"){ return high_resolution_sleep::sleep_us_hybrid(us, config); };
+	us = 5;
+	BENCHMARK("5 microseconds"){ return high_resolution_sleep::sleep_us_hybrid(us, config); };
+}
+#endif /* _WIN32 */
+
+
+/*************************************************************************************************/
+/* Timer Slack Tests																			 */
+/*************************************************************************************************/
+#ifdef __linux__
+TEST_CASE("Checking TimerSlackGuard sets and restores the timer slack.", "[timer_slack][test][short]") {
+	uint64_t default_slack_ns = high_resolution_sleep::get_timer_slack_ns();
+	{
+		high_resolution_sleep::TimerSlackGuard guard(1'000);
+		REQUIRE(guard.is_applied());
+		REQUIRE(high_resolution_sleep::get_timer_slack_ns() == 1'000);
+	}
+	REQUIRE(high_resolution_sleep::get_timer_slack_ns() == default_slack_ns);
+}
+
+TEST_CASE("Checking kernel only sleep_us_hybrid with a timer slack of 1 nanosecond.", "[timer_slack][test][short]") {
+	high_resolution_sleep::TimerSlackGuard guard(1);
+	for (uint32_t us : {10'000u, 1'000u, 500u, 250u, 50u, 10u, 5u, 1u}) {
+		uint32_t sample_count = us >= 1'000 ? 1'000'000 / us : (us >= 250 ? 500'000 / us : (us >= 5 ? 250'000 / us : 100'000 / us));
+		REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, sample_count, high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-slack-1ns-" + std::to_string(us) + "us.csv"));
+	}
+}
+
+TEST_CASE("Checking kernel only sleep_us_hybrid with a timer slack of 1 microsecond.", "[timer_slack][test][short]") {
+	high_resolution_sleep::TimerSlackGuard guard(1'000);
+	for (uint32_t us : {10'000u, 1'000u, 500u, 250u, 50u, 10u, 5u, 1u}) {
+		uint32_t sample_count = us >= 1'000 ? 1'000'000 / us : (us >= 250 ? 500'000 / us : (us >= 5 ? 250'000 / us : 100'000 / us));
+		REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, sample_count, high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-slack-1000ns-" + std::to_string(us) + "us.csv"));
+	}
+}
+
+TEST_CASE("Checking kernel only sleep_us_hybrid with a timer slack of 50 microseconds.", "[timer_slack][test][short]") {
+	high_resolution_sleep::TimerSlackGuard guard(50'000);
+	for (uint32_t us : {10'000u, 1'000u, 500u, 250u, 50u, 10u, 5u, 1u}) {
+		uint32_t sample_count = us >= 1'000 ? 1'000'000 / us : (us >= 250 ? 500'000 / us : (us >= 5 ? 250'000 / us : 100'000 / us));
+		REQUIRE_NOTHROW(save_results(test_sleep_us_hybrid(us, sample_count, high_resolution_sleep::hybrid_sleep_config{0, 0}), PROJECT_DIRECTORY + RESULTS_DIR + "sleep_us_kernel-slack-50000ns-" + std::to_string(us) + "us.csv"));
+	}
+}
+#endif /* __linux__ */
+
+
+/*************************************************************************************************/
+/* Multiple Translation Unit Tests																 */
+/*************************************************************************************************/
+TEST_CASE("Checking the sleep headers share their state across translation units.", "[translation_units][test][short]") {
+	uint64_t first_ns = high_resolution_sleep::now_ns();
+	uint64_t second_ns = now_ns_from_second_translation_unit();
+	REQUIRE(second_ns >= first_ns);
+	// Both translation units use the single calibration of the TSC clock, so their readings are ordered.
+	uint64_t first_fast_ns = high_resolution_sleep::now_ns_fast();
+	uint64_t second_fast_ns = now_ns_fast_from_second_translation_unit();
+	REQUIRE(second_fast_ns >= first_fast_ns);
+}
+
+
 /*************************************************************************************************/
 /* ASIO Tests																					 */
 /*************************************************************************************************/
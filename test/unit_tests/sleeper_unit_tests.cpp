@@ -0,0 +1,171 @@
+// System Libraries
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "sleeper.hpp"
+
+using high_resolution_sleep::Sleeper;
+using high_resolution_sleep::WakeReason;
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleeper_deadline(uint32_t duration_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	Sleeper sleeper;
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns;
+		start_ns = high_resolution_sleep::now_ns();
+		REQUIRE(sleeper.sleep_until_ns(start_ns + duration_us * 1'000) == WakeReason::Deadline);
+		end_ns = high_resolution_sleep::now_ns();
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	return start_end_times;
+}
+
+template <typename ClockSource>
+uint64_t count_sleeper_early_wakes_on(uint32_t duration_us, uint32_t sample_count) {
+	uint64_t early_wakes = 0;
+	Sleeper sleeper;
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t deadline_ns = high_resolution_sleep::now_ns_on<ClockSource>() + duration_us * 1'000;
+		REQUIRE(sleeper.sleep_until_ns_on<ClockSource>(deadline_ns) == WakeReason::Deadline);
+		if (high_resolution_sleep::now_ns_on<ClockSource>() < deadline_ns) early_wakes++;
+	}
+	return early_wakes;
+}
+
+/**
+ * Wakes a thread sleeping for a second the given number of times, recording the time from each wake
+ * call until the sleeping thread returned.
+ */
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_sleeper_wake(uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	Sleeper sleeper;
+	std::atomic<uint64_t> woken_ns{0};
+	std::atomic<bool> asleep{false};
+	for (int i = 0; i < sample_count; i++) {
+		woken_ns = 0;
+		asleep = false;
+		std::thread sleeping_thread([&]() {
+			asleep = true;
+			WakeReason reason = sleeper.sleep_for(std::chrono::seconds(1));
+			woken_ns = high_resolution_sleep::now_ns();
+			REQUIRE(reason == WakeReason::Woken);
+		});
+		// Give the thread time to block before waking it.
+		while (!asleep) std::this_thread::yield();
+		high_resolution_sleep::sleep_ms(1);
+		uint64_t wake_ns = high_resolution_sleep::now_ns();
+		sleeper.wake();
+		sleeping_thread.join();
+		start_end_times.push_back(std::make_tuple(wake_ns, woken_ns.load(), woken_ns.load() - wake_ns));
+	}
+	return start_end_times;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* Sleeper Deadline Tests																		 */
+/*************************************************************************************************/
+TEST_CASE("Checking Sleeper with sleep duration of 10 milliseconds.", "[sleeper][test][short]") {
+	uint32_t us = 10'000;
+	REQUIRE_NOTHROW(save_results(test_sleeper_deadline(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleeper-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking Sleeper with sleep duration of 1 millisecond.", "[sleeper][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_sleeper_deadline(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleeper-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking Sleeper with sleep duration of 250 microseconds.", "[sleeper][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_sleeper_deadline(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleeper-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking Sleeper with sleep duration of 50 microseconds.", "[sleeper][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_sleeper_deadline(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleeper-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking Sleeper with sleep duration of 5 microseconds.", "[sleeper][test][short]") {
+	uint32_t us = 5;
+	REQUIRE_NOTHROW(save_results(test_sleeper_deadline(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "sleeper-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking Sleeper never wakes before the deadline of each clock.", "[sleeper][test][short]") {
+	namespace clock_source = high_resolution_sleep::clock_source;
+	REQUIRE(count_sleeper_early_wakes_on<clock_source::monotonic>(1'000, 100) == 0);
+	REQUIRE(count_sleeper_early_wakes_on<clock_source::monotonic_coarse>(1'000, 100) == 0);
+	REQUIRE(count_sleeper_early_wakes_on<clock_source::monotonic_raw>(1'000, 100) == 0);
+	REQUIRE(count_sleeper_early_wakes_on<clock_source::boottime>(1'000, 100) == 0);
+	Sleeper sleeper;
+	uint64_t start_ns = high_resolution_sleep::now_ns_on<clock_source::boottime>();
+	REQUIRE(sleeper.sleep_for_on<clock_source::boottime>(std::chrono::milliseconds(2)) == WakeReason::Deadline);
+	REQUIRE(high_resolution_sleep::now_ns_on<clock_source::boottime>() - start_ns >= 2'000'000);
+}
+
+
+/*************************************************************************************************/
+/* Sleeper Wake Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking Sleeper latches a wake made before the sleep.", "[sleeper][test][short]") {
+	Sleeper sleeper;
+	sleeper.wake();
+	sleeper.wake();
+	REQUIRE(sleeper.is_wake_pending());
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	REQUIRE(sleeper.sleep_for(std::chrono::seconds(10)) == WakeReason::Woken);
+	REQUIRE(high_resolution_sleep::now_ns() - start_ns < 1'000'000'000);
+	// Both wakes were consumed by the one sleep.
+	REQUIRE_FALSE(sleeper.is_wake_pending());
+	REQUIRE(sleeper.sleep_for(std::chrono::microseconds(100)) == WakeReason::Deadline);
+}
+
+TEST_CASE("Checking Sleeper wake latency from another thread.", "[sleeper][test][short]") {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times = test_sleeper_wake(200);
+	std::vector<int64_t> latencies;
+	for (const auto &sample : start_end_times) latencies.push_back(std::get<2>(sample));
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << "Sleeper wake latency: p50 " << latencies[latencies.size() / 2] / 1'000.0 << " us, p99 "
+		<< latencies[latencies.size() * 99 / 100] / 1'000.0 << " us, max " << latencies.back() / 1'000.0 << " us" << std::endl;
+	// Every sleep ended on its wake rather than its one second deadline.
+	REQUIRE(latencies.back() < 500'000'000);
+	REQUIRE_NOTHROW(save_results(start_end_times, PROJECT_DIRECTORY + RESULTS_DIR + "sleeper_wake_latency.csv"));
+}
+
+
+/*************************************************************************************************/
+/* Sleeper Benchmarks																			 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking Sleeper.", "[sleeper][benchmark]") {
+	Sleeper sleeper;
+	BENCHMARK("sleep_for 50 microseconds"){ return sleeper.sleep_for(std::chrono::microseconds(50)); };
+	BENCHMARK("wake and consume"){
+		sleeper.wake();
+		return sleeper.sleep_for(std::chrono::microseconds(50));
+	};
+}
@@ -0,0 +1,235 @@
+/**
+ * @file 	spin_wait_benchmark.cpp
+ * @brief 	spin_wait_benchmark.cpp measures the cost of each spin strategy to the host, alongside the
+ * 			accuracy of the wakeups it gives.
+ * @details	For each SpinStrategy supported by the processor the benchmark spins repeatedly for a short
+ * 			duration and reports the wakeup overshoot, the CPU time the spinning thread consumed, and how
+ * 			much a worker thread co-scheduled on the SMT sibling of the spinning core was slowed down
+ * 			relative to running next to an idle core. Run with --help for the options.
+ * @author 	James Horner (James.Horner@nrc-cnrc.gc.ca or jwehorner@gmail.com)
+ * @date 	2023-06-13
+ */
+
+// System Libraries
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif /* WIN32_LEAN_AND_MEAN */
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif /* NOMINMAX */
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif /* _WIN32 */
+
+// Sleep Headers
+#include "high_resolution_sleep.hpp"
+#include "realtime_thread.hpp"
+
+using high_resolution_sleep::realtime_profile;
+using high_resolution_sleep::realtime_thread;
+using high_resolution_sleep::SchedulingPolicy;
+using high_resolution_sleep::SpinStrategy;
+
+/**
+ * Options of the tool, set from the command line.
+ */
+struct spin_options {
+	uint64_t duration_us = 5;
+	uint64_t loops = 20'000;
+	int cpu = 0;
+	int sibling_cpu = -1;
+};
+
+/**
+ * Prints the usage of the tool.
+ */
+void print_usage(const char *program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		<< "  --duration-us N      duration of each spin in microseconds (default 5)\n"
+		<< "  --loops N            number of spins to measure per strategy (default 20000)\n"
+		<< "  --cpu N              core to pin the spinning thread to (default 0)\n"
+		<< "  --sibling-cpu N      core to pin the worker thread to (default the SMT sibling of --cpu)\n";
+}
+
+/**
+ * Parses the command line into options, throwing std::invalid_argument on bad input.
+ */
+spin_options parse_options(int argc, char *argv[]) {
+	spin_options options;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) throw std::invalid_argument(argument + " requires a value");
+			return argv[++i];
+		};
+		if (argument == "--duration-us") options.duration_us = std::stoull(value());
+		else if (argument == "--loops") options.loops = std::stoull(value());
+		else if (argument == "--cpu") options.cpu = std::stoi(value());
+		else if (argument == "--sibling-cpu") options.sibling_cpu = std::stoi(value());
+		else throw std::invalid_argument("unknown option " + argument);
+	}
+	if (options.duration_us == 0 || options.loops == 0) throw std::invalid_argument("--duration-us and --loops must be greater than zero");
+	return options;
+}
+
+/**
+ * Finds the first SMT sibling of a core from the Linux CPU topology, or -1 if it has none.
+ */
+int find_sibling_cpu(int cpu) {
+	std::ifstream siblings("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+	std::string list;
+	if (!std::getline(siblings, list)) return -1;
+	// The list is made of comma separated cores or ranges of cores, such as 0,64 or 0-1.
+	std::replace(list.begin(), list.end(), '-', ',');
+	std::stringstream stream(list);
+	std::string core;
+	while (std::getline(stream, core, ',')) {
+		if (!core.empty() && std::stoi(core) != cpu) return std::stoi(core);
+	}
+	return -1;
+}
+
+/**
+ * Gets the CPU time consumed by the calling thread in nanoseconds.
+ */
+uint64_t thread_cpu_time_ns() {
+	#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+	auto ticks = [](const FILETIME &time) { return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+	return (ticks(kernel) + ticks(user)) * 100;
+	#else
+	struct timespec now;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+	#endif /* _WIN32 */
+}
+
+/**
+ * Result of spinning with one strategy.
+ */
+struct spin_result {
+	std::vector<int64_t> overshoots_ns{};
+	uint64_t wall_ns = 0;
+	uint64_t cpu_ns = 0;
+};
+
+/**
+ * Spins for the duration the given number of times and measures the overshoot of every wakeup.
+ */
+spin_result measure_spins(const spin_options &options, const SpinStrategy strategy) {
+	spin_result result;
+	result.overshoots_ns.reserve(options.loops);
+	const uint64_t start_cpu_ns = thread_cpu_time_ns();
+	const uint64_t start_ns = high_resolution_sleep::now_ns();
+	for (uint64_t i = 0; i < options.loops; i++) {
+		const uint64_t deadline_ns = high_resolution_sleep::now_ns() + options.duration_us * 1'000;
+		high_resolution_sleep::spin_until_ns(deadline_ns, strategy);
+		result.overshoots_ns.push_back(static_cast<int64_t>(high_resolution_sleep::now_ns() - deadline_ns));
+	}
+	result.wall_ns = high_resolution_sleep::now_ns() - start_ns;
+	result.cpu_ns = thread_cpu_time_ns() - start_cpu_ns;
+	return result;
+}
+
+/**
+ * Runs a worker on the sibling core while the phase runs, returning the worker's iterations per second.
+ */
+template <typename Phase>
+double measure_worker_rate(const spin_options &options, Phase phase) {
+	std::atomic<bool> stop{false};
+	std::atomic<uint64_t> iterations{0};
+	realtime_profile profile{SchedulingPolicy::Default, 0, {}, false, false};
+	if (options.sibling_cpu >= 0) profile.cpus = {options.sibling_cpu};
+	realtime_thread worker(profile, [&]() {
+		volatile uint64_t value = 1;
+		uint64_t count = 0;
+		while (!stop.load(std::memory_order_relaxed)) {
+			for (int i = 0; i < 1'000; i++) value = value * 6'364'136'223'846'793'005ull + 1;
+			iterations.store(++count, std::memory_order_relaxed);
+		}
+	});
+	const uint64_t start_iterations = iterations.load(std::memory_order_relaxed);
+	const uint64_t start_ns = high_resolution_sleep::now_ns();
+	phase();
+	const uint64_t end_iterations = iterations.load(std::memory_order_relaxed);
+	const uint64_t end_ns = high_resolution_sleep::now_ns();
+	stop = true;
+	worker.join();
+	return static_cast<double>(end_iterations - start_iterations) * 1e9 / static_cast<double>(end_ns - start_ns);
+}
+
+/**
+ * Prints the accuracy and cost of one strategy.
+ */
+void print_result(const std::string &name, spin_result result, const double worker_rate, const double baseline_rate) {
+	std::sort(result.overshoots_ns.begin(), result.overshoots_ns.end());
+	auto percentile = [&result](double fraction) { return result.overshoots_ns[static_cast<size_t>(fraction * (result.overshoots_ns.size() - 1))]; };
+	std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(8) << name
+		<< " overshoot (ns): p50 " << percentile(0.5) << " p99 " << percentile(0.99) << " max " << result.overshoots_ns.back()
+		<< ", CPU time " << 100.0 * static_cast<double>(result.cpu_ns) / static_cast<double>(result.wall_ns) << "% of wall time"
+		<< ", sibling slowdown " << 100.0 * (1.0 - worker_rate / baseline_rate) << "%" << std::endl;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main(int argc, char *argv[]) {
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		}
+	}
+	spin_options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		print_usage(argv[0]);
+		return 1;
+	}
+	if (options.sibling_cpu < 0) options.sibling_cpu = find_sibling_cpu(options.cpu);
+	if (options.sibling_cpu < 0) {
+		options.sibling_cpu = options.cpu;
+		std::cerr << "Warning: core " << options.cpu << " has no SMT sibling, the worker shares the spinning core.\n";
+	}
+	// Measure the cost of a pause before any strategy is timed.
+	high_resolution_sleep::pause_cost_ps();
+
+	std::vector<std::pair<std::string, SpinStrategy>> strategies = {{"busy", SpinStrategy::Busy}, {"pause", SpinStrategy::Pause}};
+	if (high_resolution_sleep::waitpkg_is_supported()) strategies.push_back({"tpause", SpinStrategy::WaitPkg});
+	else std::cerr << "Warning: WAITPKG is not supported, tpause is not measured.\n";
+
+	std::cout << "Spinning for " << options.duration_us << " us " << options.loops << " times on core " << options.cpu
+		<< ", worker on core " << options.sibling_cpu << "\n";
+	realtime_profile profile{SchedulingPolicy::Default, 0, {options.cpu}, false, false};
+	for (const auto &[name, strategy] : strategies) {
+		spin_result result;
+		double baseline_rate = 0, worker_rate = 0;
+		realtime_thread spinner(profile, [&, strategy = strategy]() {
+			// The baseline is the worker running next to a core that sleeps for as long as the spins take.
+			spin_result probe = measure_spins(spin_options{options.duration_us, options.loops / 10 + 1, options.cpu, options.sibling_cpu}, strategy);
+			baseline_rate = measure_worker_rate(options, [&]() { high_resolution_sleep::sleep_ms(static_cast<uint32_t>(probe.wall_ns * 10 / 1'000'000 + 1)); });
+			worker_rate = measure_worker_rate(options, [&]() { result = measure_spins(options, strategy); });
+		});
+		if (!spinner.status().affinity_applied) std::cerr << "Warning: the spinning thread could not be pinned to core " << options.cpu << ".\n";
+		spinner.join();
+		print_result(name, result, worker_rate, baseline_rate);
+	}
+	return 0;
+}
@@ -0,0 +1,167 @@
+// System Libraries
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// Platform Dependant System Libraries
+#include <sys/epoll.h>
+#include <unistd.h>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "timerfd_engine.hpp"
+
+using high_resolution_sleep::TimerfdEngine;
+
+void wait_and_dispatch(int epoll_fd, TimerfdEngine &engine) {
+	epoll_event event;
+	while (epoll_wait(epoll_fd, &event, 1, -1) != 1);
+	engine.dispatch();
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_timerfd_engine(uint32_t duration_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> start_end_times{};
+	start_end_times.reserve(sample_count);
+	TimerfdEngine engine;
+	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	epoll_event event{};
+	event.events = EPOLLIN;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, engine.fd(), &event);
+
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t start_ns, end_ns = 0;
+		start_ns = high_resolution_sleep::now_ns();
+		engine.schedule_at_ns(start_ns + duration_us * 1'000, [&end_ns](uint64_t expirations) { end_ns = high_resolution_sleep::now_ns(); });
+		while (end_ns == 0) wait_and_dispatch(epoll_fd, engine);
+		start_end_times.push_back(std::make_tuple(start_ns, end_ns, end_ns - start_ns - (duration_us * 1'000)));
+	}
+	close(epoll_fd);
+	return start_end_times;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* TimerfdEngine Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking TimerfdEngine with sleep duration of 10 milliseconds.", "[timerfd_engine][test][short]") {
+	uint32_t us = 10'000;
+	REQUIRE_NOTHROW(save_results(test_timerfd_engine(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "timerfd_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimerfdEngine with sleep duration of 1 millisecond.", "[timerfd_engine][test][short]") {
+	uint32_t us = 1'000;
+	REQUIRE_NOTHROW(save_results(test_timerfd_engine(us, 1 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "timerfd_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimerfdEngine with sleep duration of 500 microseconds.", "[timerfd_engine][test][short]") {
+	uint32_t us = 500;
+	REQUIRE_NOTHROW(save_results(test_timerfd_engine(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "timerfd_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimerfdEngine with sleep duration of 250 microseconds.", "[timerfd_engine][test][short]") {
+	uint32_t us = 250;
+	REQUIRE_NOTHROW(save_results(test_timerfd_engine(us, 0.5 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "timerfd_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimerfdEngine with sleep duration of 50 microseconds.", "[timerfd_engine][test][short]") {
+	uint32_t us = 50;
+	REQUIRE_NOTHROW(save_results(test_timerfd_engine(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "timerfd_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimerfdEngine with sleep duration of 10 microseconds.", "[timerfd_engine][test][short]") {
+	uint32_t us = 10;
+	REQUIRE_NOTHROW(save_results(test_timerfd_engine(us, 0.25 * (1'000'000 / us)), PROJECT_DIRECTORY + RESULTS_DIR + "timerfd_engine-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimerfdEngine fires a batch of deadlines in order from one expiration.", "[timerfd_engine][test][short]") {
+	TimerfdEngine engine;
+	std::vector<uint64_t> fired_order;
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	// Schedule in reverse so that the engine has to order them.
+	for (uint64_t i = 1'000; i > 0; i--) {
+		engine.schedule_at_ns(start_ns + i * 1'000, [&fired_order, i](uint64_t expirations) { fired_order.push_back(i); });
+	}
+	high_resolution_sleep::sleep_ms(5);
+	REQUIRE(engine.dispatch() == 1'000);
+	REQUIRE(engine.expirations() == 1);
+	REQUIRE(fired_order.size() == 1'000);
+	for (uint64_t i = 0; i < fired_order.size(); i++) REQUIRE(fired_order[i] == i + 1);
+	REQUIRE(engine.size() == 0);
+}
+
+TEST_CASE("Checking TimerfdEngine reports missed periods of a periodic timer.", "[timerfd_engine][test][short]") {
+	TimerfdEngine engine;
+	uint64_t calls = 0, total_expirations = 0;
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	auto handle = engine.schedule_every_ns(start_ns + 1'000'000, 1'000'000, [&](uint64_t expirations) {
+		calls++;
+		total_expirations += expirations;
+	});
+	high_resolution_sleep::sleep_until_ns(start_ns + 10'500'000);
+	REQUIRE(engine.dispatch() == 1);
+	REQUIRE(calls == 1);
+	REQUIRE(total_expirations >= 10);
+	REQUIRE(engine.size() == 1);
+	REQUIRE(engine.cancel(handle));
+	REQUIRE_FALSE(engine.cancel(handle));
+	REQUIRE(engine.size() == 0);
+}
+
+TEST_CASE("Checking TimerfdEngine does not fire cancelled timers.", "[timerfd_engine][test][short]") {
+	TimerfdEngine engine;
+	uint64_t fired = 0;
+	auto first = engine.schedule_after_ns(1'000'000, [&fired](uint64_t expirations) { fired++; });
+	engine.schedule_after_ns(2'000'000, [&fired](uint64_t expirations) { fired++; });
+	REQUIRE(engine.cancel(first));
+	high_resolution_sleep::sleep_ms(3);
+	REQUIRE(engine.dispatch() == 1);
+	REQUIRE(fired == 1);
+}
+
+
+/*************************************************************************************************/
+/* TimerfdEngine Benchmarks																		 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking TimerfdEngine.", "[timerfd_engine][benchmark]") {
+	TimerfdEngine engine;
+	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	epoll_event event{};
+	event.events = EPOLLIN;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, engine.fd(), &event);
+
+	uint64_t us = 1'000;
+	BENCHMARK("1 millisecond") {
+		engine.schedule_after_ns(us * 1'000, [](uint64_t expirations) {});
+		return wait_and_dispatch(epoll_fd, engine);
+	};
+	us = 250;
+	BENCHMARK("250 microseconds") {
+		engine.schedule_after_ns(us * 1'000, [](uint64_t expirations) {});
+		return wait_and_dispatch(epoll_fd, engine);
+	};
+	us = 50;
+	BENCHMARK("50 microseconds") {
+		engine.schedule_after_ns(us * 1'000, [](uint64_t expirations) {});
+		return wait_and_dispatch(epoll_fd, engine);
+	};
+	us = 10;
+	BENCHMARK("10 microseconds") {
+		engine.schedule_after_ns(us * 1'000, [](uint64_t expirations) {});
+		return wait_and_dispatch(epoll_fd, engine);
+	};
+	close(epoll_fd);
+}
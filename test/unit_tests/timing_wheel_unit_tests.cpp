@@ -0,0 +1,187 @@
+// System Libraries
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "timing_wheel.hpp"
+
+using high_resolution_sleep::TimingWheel;
+
+struct timer_record {
+	uint64_t deadline_ns;
+	uint64_t fired_ns;
+	std::atomic<uint64_t> *fired_count;
+};
+
+void record_fire(void *context) {
+	timer_record *record = static_cast<timer_record *>(context);
+	record->fired_ns = high_resolution_sleep::now_ns();
+	record->fired_count->fetch_add(1);
+}
+
+void count_fire(void *context) {
+	(*static_cast<uint64_t *>(context))++;
+}
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_timing_wheel(uint32_t max_delay_us, uint32_t timer_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> deadline_fire_times{};
+	std::vector<timer_record> records(timer_count);
+	std::atomic<uint64_t> fired_count{0};
+	std::mt19937_64 generator(timer_count);
+	std::uniform_int_distribution<uint64_t> delay_ns(1'000, max_delay_us * 1'000);
+
+	TimingWheel wheel(timer_count);
+	wheel.start();
+	for (timer_record &record : records) {
+		record.deadline_ns = high_resolution_sleep::now_ns() + delay_ns(generator);
+		record.fired_count = &fired_count;
+		wheel.schedule_at_ns(record.deadline_ns, record_fire, &record);
+	}
+	while (fired_count.load() < timer_count) high_resolution_sleep::sleep_ms(1);
+	wheel.stop();
+
+	for (timer_record &record : records) {
+		deadline_fire_times.push_back(std::make_tuple(record.deadline_ns, record.fired_ns, record.fired_ns - record.deadline_ns));
+	}
+	return deadline_fire_times;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* TimingWheel Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking TimingWheel with 10000 timers within 10 milliseconds.", "[timing_wheel][test][short]") {
+	uint32_t us = 10'000;
+	auto deadline_fire_times = test_timing_wheel(us, 10'000);
+	for (auto [deadline, fired, error] : deadline_fire_times) REQUIRE(fired >= deadline);
+	REQUIRE_NOTHROW(save_results(deadline_fire_times, PROJECT_DIRECTORY + RESULTS_DIR + "timing_wheel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimingWheel with 1000 timers within 1 second.", "[timing_wheel][test][long]") {
+	uint32_t us = 1'000'000;
+	auto deadline_fire_times = test_timing_wheel(us, 1'000);
+	for (auto [deadline, fired, error] : deadline_fire_times) REQUIRE(fired >= deadline);
+	REQUIRE_NOTHROW(save_results(deadline_fire_times, PROJECT_DIRECTORY + RESULTS_DIR + "timing_wheel-" + std::to_string(us) + "us.csv"));
+}
+
+TEST_CASE("Checking TimingWheel fires only timers that were not cancelled.", "[timing_wheel][test][short]") {
+	uint64_t fired = 0;
+	TimingWheel wheel(100'000);
+	std::vector<TimingWheel::timer_handle> handles;
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	for (uint64_t i = 0; i < 100'000; i++) {
+		handles.push_back(wheel.schedule_at_ns(start_ns + i * 10'000, count_fire, &fired));
+	}
+	for (size_t i = 0; i < handles.size(); i += 2) REQUIRE(wheel.cancel(handles[i]));
+	REQUIRE(wheel.size() == 50'000);
+	REQUIRE(wheel.advance_to_ns(start_ns + 100'000 * 10'000ull) == 50'000);
+	REQUIRE(fired == 50'000);
+	REQUIRE(wheel.size() == 0);
+	// Handles of fired and cancelled timers are stale.
+	REQUIRE_FALSE(wheel.cancel(handles[0]));
+	REQUIRE_FALSE(wheel.cancel(handles[1]));
+}
+
+TEST_CASE("Checking TimingWheel cascades timers from every level and the overflow list.", "[timing_wheel][test][short]") {
+	uint64_t fired = 0;
+	TimingWheel wheel(16);
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	// Delays that land in each level of a microsecond wheel, and beyond its 71 minute range.
+	std::vector<uint64_t> delays_ns = {100'000, 10'000'000, 1'000'000'000, 600'000'000'000, 7'200'000'000'000};
+	for (uint64_t delay_ns : delays_ns) wheel.schedule_at_ns(start_ns + delay_ns, count_fire, &fired);
+	for (size_t i = 0; i < delays_ns.size(); i++) {
+		REQUIRE(wheel.advance_to_ns(start_ns + delays_ns[i] - 2'000) == 0);
+		REQUIRE(wheel.advance_to_ns(start_ns + delays_ns[i] + 2'000) == 1);
+	}
+	REQUIRE(fired == delays_ns.size());
+}
+
+TEST_CASE("Checking TimingWheel throws when the timer pool is exhausted.", "[timing_wheel][test][short]") {
+	uint64_t fired = 0;
+	TimingWheel wheel(2);
+	wheel.schedule_after_ns(1'000'000, count_fire, &fired);
+	wheel.schedule_after_ns(1'000'000, count_fire, &fired);
+	REQUIRE_THROWS_AS(wheel.schedule_after_ns(1'000'000, count_fire, &fired), std::length_error);
+}
+
+
+TEST_CASE("Checking TimingWheel rejects an invalid capacity before allocating.", "[timing_wheel][test][short]") {
+	REQUIRE_THROWS_AS(TimingWheel(0), std::invalid_argument);
+	REQUIRE_THROWS_AS(TimingWheel(SIZE_MAX), std::invalid_argument);
+}
+
+/// Timers that record the order they fired in.
+struct order_record {
+	uint32_t id;
+	std::vector<uint32_t> *fired_ids;
+};
+
+void record_order(void *context) {
+	order_record *record = static_cast<order_record *>(context);
+	record->fired_ids->push_back(record->id);
+}
+
+TEST_CASE("Checking TimingWheel fires timers in order of expiry, then in the order they were scheduled.", "[timing_wheel][test][short]") {
+	std::vector<uint32_t> fired_ids;
+	std::vector<order_record> records;
+	for (uint32_t id = 0; id < 12; id++) records.push_back(order_record{id, &fired_ids});
+	TimingWheel wheel(16);
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	// Three timers in each of four ticks spread over the levels, scheduled latest tick first, so each
+	// advance fires timers from several slots and cascades.
+	std::vector<uint64_t> delays_ns = {20'000'000, 5'000'000, 300'000, 100'000};
+	for (size_t tick = 0; tick < delays_ns.size(); tick++) {
+		for (uint32_t i = 0; i < 3; i++) wheel.schedule_at_ns(start_ns + delays_ns[tick], record_order, &records[tick * 3 + i]);
+	}
+	REQUIRE(wheel.advance_to_ns(start_ns + 30'000'000) == 12);
+	std::vector<uint32_t> expected_ids = {9, 10, 11, 6, 7, 8, 3, 4, 5, 0, 1, 2};
+	REQUIRE(fired_ids == expected_ids);
+}
+
+/*************************************************************************************************/
+/* TimingWheel Benchmarks																		 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking TimingWheel insert, cancel and fire throughput.", "[timing_wheel][benchmark]") {
+	const uint64_t timer_count = 100'000;
+	uint64_t fired = 0;
+	TimingWheel wheel(timer_count);
+	std::vector<TimingWheel::timer_handle> handles(timer_count);
+	std::vector<uint64_t> deadlines_ns(timer_count);
+	std::mt19937_64 generator(timer_count);
+	std::uniform_int_distribution<uint64_t> delay_ns(1'000, 1'000'000'000);
+	uint64_t start_ns = high_resolution_sleep::now_ns();
+	for (uint64_t &deadline_ns : deadlines_ns) deadline_ns = start_ns + delay_ns(generator);
+
+	BENCHMARK("100000 inserts and cancels") {
+		for (uint64_t i = 0; i < timer_count; i++) handles[i] = wheel.schedule_at_ns(deadlines_ns[i], count_fire, &fired);
+		for (uint64_t i = 0; i < timer_count; i++) wheel.cancel(handles[i]);
+		return wheel.size();
+	};
+
+	BENCHMARK("100000 inserts and fires") {
+		for (uint64_t i = 0; i < timer_count; i++) wheel.schedule_at_ns(deadlines_ns[i], count_fire, &fired);
+		// Move every deadline forward so the next run inserts into the future again.
+		size_t fired_now = wheel.advance_to_ns(deadlines_ns.back() + 2'000'000'000);
+		for (uint64_t &deadline_ns : deadlines_ns) deadline_ns += 2'000'000'000;
+		return fired_now;
+	};
+}
@@ -0,0 +1,115 @@
+// System Libraries
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// Unit Test Headers
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// Test Utility Headers
+#include "sleep_test_utilities.hpp"
+
+// Sleep Headers
+#include "tsc_clock.hpp"
+
+std::vector<std::tuple<uint64_t, uint64_t, int64_t>> test_now_ns_fast_offset(uint32_t interval_us, uint32_t sample_count) {
+	std::vector<std::tuple<uint64_t, uint64_t, int64_t>> offsets{};
+	offsets.reserve(sample_count);
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t before_ns, fast_ns, after_ns;
+		before_ns = high_resolution_sleep::now_ns();
+		fast_ns = high_resolution_sleep::now_ns_fast();
+		after_ns = high_resolution_sleep::now_ns();
+		// Compare against the midpoint of the two now_ns calls surrounding the fast read.
+		offsets.push_back(std::make_tuple(before_ns, fast_ns, (int64_t)fast_ns - (int64_t)(before_ns + (after_ns - before_ns) / 2)));
+		high_resolution_sleep::sleep_us(interval_us);
+	}
+	return offsets;
+}
+
+template <typename Clock>
+uint64_t count_backward_steps(Clock clock, uint32_t sample_count) {
+	uint64_t backward_steps = 0;
+	uint64_t previous_ns = clock();
+	for (int i = 0; i < sample_count; i++) {
+		uint64_t current_ns = clock();
+		if (current_ns < previous_ns) backward_steps++;
+		previous_ns = current_ns;
+	}
+	return backward_steps;
+}
+
+/*************************************************************************************************
+* Main Method
+*************************************************************************************************/
+int main( int argc, char* argv[] ) {
+  	int result = Catch::Session().run( argc, argv );
+	return result;
+}
+
+/*************************************************************************************************/
+/* now_ns_fast Tests																			 */
+/*************************************************************************************************/
+TEST_CASE("Checking now_ns_fast is monotonic.", "[tsc_clock][test][short]") {
+	high_resolution_sleep::calibrate_tsc_clock();
+	REQUIRE(count_backward_steps(high_resolution_sleep::now_ns, 1'000'000) == 0);
+	REQUIRE(count_backward_steps(high_resolution_sleep::now_ns_fast, 1'000'000) == 0);
+}
+
+TEST_CASE("Checking now_ns_fast is monotonic across recalibrations.", "[tsc_clock][test][long]") {
+	high_resolution_sleep::calibrate_tsc_clock();
+	uint64_t backward_steps = 0;
+	uint64_t previous_ns = high_resolution_sleep::now_ns_fast();
+	uint64_t end_ns = high_resolution_sleep::now_ns() + 1'000'000'000;
+	while (high_resolution_sleep::now_ns() < end_ns) {
+		uint64_t current_ns = high_resolution_sleep::now_ns_fast();
+		if (current_ns < previous_ns) backward_steps++;
+		previous_ns = current_ns;
+	}
+	REQUIRE(backward_steps == 0);
+}
+
+TEST_CASE("Checking now_ns_fast stays close to now_ns over 2 seconds.", "[tsc_clock][test][long]") {
+	high_resolution_sleep::calibrate_tsc_clock();
+	auto offsets = test_now_ns_fast_offset(1'000, 2'000);
+	REQUIRE_NOTHROW(save_results(offsets, PROJECT_DIRECTORY + RESULTS_DIR + "now_ns_fast-offset-1000us.csv"));
+	if (high_resolution_sleep::tsc_clock_state::instance().available()) {
+		// The last samples have been through many recalibrations and should agree to within a few microseconds.
+		REQUIRE(std::get<2>(offsets.back()) < 10'000);
+		REQUIRE(std::get<2>(offsets.back()) > -10'000);
+	}
+}
+
+TEST_CASE("Checking now_ns_fast stays close to now_ns after idling for several recalibration intervals.", "[tsc_clock][test][long]") {
+	high_resolution_sleep::calibrate_tsc_clock();
+	// Re-anchor once so that the multiplier is slewed to remove the error of the first calibration.
+	high_resolution_sleep::sleep_until_ns(high_resolution_sleep::now_ns() + high_resolution_sleep::tsc_recalibration_interval_ns * 3 / 2);
+	high_resolution_sleep::now_ns_fast();
+	// The slew only applies to the interval after the anchor, not the whole of a longer idle gap.
+	high_resolution_sleep::sleep_until_ns(high_resolution_sleep::now_ns() + high_resolution_sleep::tsc_recalibration_interval_ns * 10);
+	auto offsets = test_now_ns_fast_offset(0, 1);
+	if (high_resolution_sleep::tsc_clock_state::instance().available()) {
+		REQUIRE(std::get<2>(offsets.front()) < 20'000);
+		REQUIRE(std::get<2>(offsets.front()) > -20'000);
+	}
+}
+
+TEST_CASE("Checking tsc_clock time points share the time base of now_ns.", "[tsc_clock][test][short]") {
+	auto deadline = high_resolution_sleep::tsc_clock::now() + std::chrono::milliseconds(1);
+	high_resolution_sleep::sleep_until_ns(static_cast<uint64_t>(deadline.time_since_epoch().count()));
+	REQUIRE(high_resolution_sleep::tsc_clock::now() >= deadline);
+}
+
+
+/*************************************************************************************************/
+/* now_ns_fast Benchmarks																		 */
+/*************************************************************************************************/
+TEST_CASE("Benchmarking now_ns_fast against now_ns.", "[tsc_clock][benchmark]") {
+	high_resolution_sleep::calibrate_tsc_clock();
+	BENCHMARK("now_ns"){ return high_resolution_sleep::now_ns(); };
+	BENCHMARK("now_ns_fast"){ return high_resolution_sleep::now_ns_fast(); };
+	BENCHMARK("tsc_clock::now"){ return high_resolution_sleep::tsc_clock::now(); };
+	BENCHMARK("std::chrono::steady_clock::now"){ return std::chrono::steady_clock::now(); };
+}